@@ -11,28 +11,58 @@
 
 #include <Arduino.h>
 #include "include/Config.h"
+#include "include/HAL.h"
 #include "include/TemperatureSensor.h"
 #include "include/Display.h"
 #include "include/Encoder.h"
 #include "include/PIDController.h"
+#include "include/PreheatController.h"
+#include "include/CascadeController.h"
 #include "include/SSRControl.h"
 #include "include/StateMachine.h"
 #include "include/DataLogger.h"
+#include "include/LogPolicy.h"
 #include "include/WebInterface.h"
+#include "include/ControlStatus.h"
+#include "include/CommandBus.h"
+#include "include/SerialConsole.h"
+#include "include/MqttClient.h"
+#include "include/SpscQueue.h"
+#include "include/Tasks.h"
+
+void controlStep();
+void uiStep();
+void logStep();
 
 // Global objects
 TemperatureSensor tempSensor;
 Display display;
 Encoder encoder;
 PIDController pidController;
+PreheatController preheatController;
+CascadeController cascadeController;
 SSRControl ssrControl;
 StateMachine stateMachine;
 DataLogger dataLogger;
+LogPolicy logPolicy;
 WebInterface webInterface;
+SerialConsole serialConsole;
+MqttClient mqttClient;
+
+// Control on one core at high priority, UI/network/logging on the other;
+// they share nothing but the status queue and the command bus. Flash
+// writes for the log happen in their own task, off the UI path.
+PeriodicTask controlTask("control", controlStep, CONTROL_TASK_PERIOD,
+                         CONTROL_TASK_PRIORITY, CONTROL_TASK_CORE);
+PeriodicTask uiTask("ui", uiStep, UI_TASK_PERIOD, UI_TASK_PRIORITY, UI_TASK_CORE);
+PeriodicTask logTask("log", logStep, LOG_TASK_PERIOD, LOG_TASK_PRIORITY, LOG_TASK_CORE);
+SpscQueue<ControlStatus, STATUS_QUEUE_SIZE> statusQueue;
+CommandBus commandBus;
 
 // Global variables
 unsigned long lastUpdateTime = 0;
 unsigned long lastLogTime = 0;
+ControlStatus uiStatus = {};
 
 void setup() {
     Serial.begin(115200);
@@ -50,13 +80,22 @@ void setup() {
     encoder.begin();
     ssrControl.begin();
     
-    // Initialize PID controller with default parameters
+    // Initialize PID controller with default parameters. Output is SSR
+    // power in percent, the unit SSRControl::setPower() interprets without
+    // ambiguity and the one auto-tuned gains are expressed in.
     pidController.begin(DEFAULT_KP, DEFAULT_KI, DEFAULT_KD);
-    pidController.setOutputLimits(0, PID_WINDOW_SIZE);
+    pidController.setOutputLimits(0, 100);
+    pidController.enableAntiWindup(true);
+    pidController.enableFeedForward(ENABLE_FEEDFORWARD);
     pidController.setSetpoint(DEFAULT_TARGET_TEMP);
+    cascadeController.begin();
     
-    // Initialize state machine
+    // Initialize state machine; remote commands reach it through the bus
     stateMachine.begin();
+    stateMachine.setCommandBus(&commandBus);
+    if (ENABLE_SERIAL_CONSOLE) {
+        serialConsole.begin(&commandBus);
+    }
     
     // Initialize data logger
     if (ENABLE_DATA_LOGGING) {
@@ -65,19 +104,50 @@ void setup() {
     
     // Initialize WiFi and web interface
     if (ENABLE_WIFI) {
+        webInterface.setCommandBus(&commandBus);
         webInterface.begin();
     }
     
+    // Telemetry and commands over MQTT; keeps retrying until the broker is up
+    if (ENABLE_WIFI && ENABLE_MQTT) {
+        mqttClient.begin(&commandBus);
+    }
+    
     // Display startup message
     display.showStartupScreen();
-    delay(2000);
+    HAL::clock().delay(2000);
     
     Serial.println(F("Initialization complete"));
+    
+#ifdef ARDUINO
+    // The host runner steps loop() on virtual time instead
+    if (ENABLE_TASK_SPLIT) {
+        controlTask.start();
+        uiTask.start();
+        if (ENABLE_DATA_LOGGING) {
+            logTask.start();
+        }
+    }
+#endif
 }
 
 void loop() {
-    unsigned long currentTime = millis();
+    // With the task split running loop() has nothing left to do
+    if (controlTask.isRunning()) {
+        HAL::clock().delay(1000);
+        return;
+    }
     
+    controlStep();
+    uiStep();
+    logStep();
+    
+    // Small delay to prevent watchdog issues
+    HAL::clock().delay(10);
+}
+
+// Sensor, state machine, PID and SSR: everything with a deadline
+void controlStep() {
     // Update temperature reading
     tempSensor.update();
     float currentTemp = tempSensor.getTemperature();
@@ -85,19 +155,117 @@ void loop() {
     // Update encoder state
     encoder.update();
     
-    // Process state machine
+    // Process state machine, including queued remote commands
+    stateMachine.setCoreTemperature(tempSensor.getTemperature(SENSOR_CORE));
     stateMachine.update(currentTemp, encoder);
     
     // Get current cooking parameters from state machine
     CookingParameters params = stateMachine.getCookingParameters();
     
-    // Update PID controller if cooking
-    if (stateMachine.getCurrentState() == STATE_COOKING) {
+    // Update PID controller while heating up or cooking
+    SystemState state = stateMachine.getCurrentState();
+    tempSensor.adaptResolution(params.targetTemperature - currentTemp, state == STATE_PREHEAT);
+    if (state == STATE_PREHEAT || state == STATE_COOKING) {
+        // Back in automatic after a pause: continues from the held output
+        pidController.setMode(true);
+        pidController.setTunings(params.pidKp, params.pidKi, params.pidKd);
         pidController.setSetpoint(params.targetTemperature);
-        float output = pidController.compute(currentTemp);
+        
+        // Predictive preheat drives the SSR until the coast has peaked,
+        // then hands over to the PID without a bump in output
+        if (ENABLE_PREDICTIVE_PREHEAT && state == STATE_PREHEAT &&
+            preheatController.getPhase() == PreheatController::PHASE_IDLE) {
+            preheatController.setHoldingPower(pidController.getHoldingPower(params.targetTemperature));
+            preheatController.start(currentTemp, params.targetTemperature);
+            if (preheatController.isDone()) {
+                pidController.initialize(currentTemp, preheatController.getOutput());
+            }
+        }
+        
+        float output;
+        if (preheatController.isActive()) {
+            preheatController.setHoldingPower(pidController.getHoldingPower(params.targetTemperature));
+            output = preheatController.compute(currentTemp, params.targetTemperature);
+            if (preheatController.isDone()) {
+                pidController.initialize(currentTemp, output);
+            }
+        } else {
+            output = ENABLE_KALMAN_FILTER
+                ? pidController.compute(currentTemp, tempSensor.getTemperatureRate())
+                : pidController.compute(currentTemp);
+        }
+        
+        // With a heater outlet probe the PID output becomes the demand of
+        // the fast inner loop; losing the probe falls back to direct control
+        if (ENABLE_CASCADE_CONTROL && tempSensor.hasSensor(SENSOR_HEATER_OUTLET) &&
+            !preheatController.isActive()) {
+            float outletTemp = tempSensor.getTemperature(SENSOR_HEATER_OUTLET);
+            if (!cascadeController.isActive()) {
+                cascadeController.start(outletTemp, output);
+            }
+            output = cascadeController.compute(output, currentTemp, outletTemp);
+        } else {
+            cascadeController.stop();
+        }
         ssrControl.setPower(output);
+    } else if (state == STATE_AUTOTUNE) {
+        // Relay auto-tune around the target; the tuner drives the SSR
+        if (!pidController.isAutoTuning()) {
+            pidController.startAutoTune();
+        }
+        PIDController::TuningParameters tuning = pidController.autoTune(currentTemp, params.targetTemperature);
+        ssrControl.setPower(pidController.getOutput());
+        
+        if (pidController.getAutoTuneState() == PIDController::AUTOTUNE_DONE) {
+            stateMachine.applyTuning(tuning.kp, tuning.ki, tuning.kd);
+        } else if (pidController.getAutoTuneState() == PIDController::AUTOTUNE_FAILED) {
+            stateMachine.setError(ERROR_PID_FAILURE);
+        }
     } else {
-        ssrControl.setPower(0);  // Turn off heater when not cooking
+        pidController.cancelAutoTune();
+        pidController.setMode(false);
+        preheatController.cancel();
+        cascadeController.stop();
+        ssrControl.setPower(0);  // Turn off heater when not heating
+    }
+    
+    // Update SSR control (needs to be called frequently for PWM)
+    ssrControl.update();
+    
+    // Never blocks: a full queue means the UI is behind and only wants
+    // the newest status anyway
+    ControlStatus status;
+    status.timestamp = HAL::clock().millis();
+    status.state = stateMachine.getCurrentState();
+    status.error = stateMachine.getLastError();
+    status.currentTemp = currentTemp;
+    status.targetTemp = params.targetTemperature;
+    status.coreTemp = stateMachine.getCoreTemperature();
+    status.tempRate = tempSensor.getTemperatureRate();
+    status.activeSensors = tempSensor.getActiveSensorCount();
+    status.sensorError = tempSensor.hasError();
+    status.cookingTime = params.cookingTime;
+    status.elapsedTime = stateMachine.getElapsedTime();
+    status.remainingTime = stateMachine.getRemainingTime();
+    status.power = ssrControl.getPowerPercentage();
+    status.pidOutput = pidController.getOutput();
+    status.feedForward = pidController.getFeedForward();
+    status.kp = params.pidKp;
+    status.ki = params.pidKi;
+    status.kd = params.pidKd;
+    status.pidAutoMode = pidController.isAutoMode();
+    status.ssrEnabled = ssrControl.isEnabled();
+    status.ssrSafetyLocked = ssrControl.isSafetyLocked();
+    statusQueue.push(status);
+}
+
+// Display, data logging and web: may take tens of milliseconds
+void uiStep() {
+    unsigned long currentTime = HAL::clock().millis();
+    statusQueue.popLatest(uiStatus);
+    
+    if (ENABLE_SERIAL_CONSOLE) {
+        serialConsole.update();
     }
     
     // Update display (limit refresh rate)
@@ -105,43 +273,45 @@ void loop() {
         lastUpdateTime = currentTime;
         
         display.updateScreen(
-            stateMachine.getCurrentState(),
-            currentTemp,
-            params.targetTemperature,
-            params.cookingTime,
-            stateMachine.getRemainingTime(),
-            ssrControl.getPowerPercentage()
+            uiStatus.state,
+            uiStatus.currentTemp,
+            uiStatus.targetTemp,
+            uiStatus.cookingTime,
+            uiStatus.remainingTime,
+            uiStatus.power
         );
     }
     
-    // Log data if enabled
-    if (ENABLE_DATA_LOGGING && stateMachine.getCurrentState() == STATE_COOKING) {
-        if (currentTime - lastLogTime >= DATA_LOG_INTERVAL) {
-            lastLogTime = currentTime;
-            
+    // Log data if enabled: the policy thins out steady holding and logs
+    // every sample around state changes, setpoint changes and deviations
+    if (ENABLE_DATA_LOGGING && currentTime - lastLogTime >= DATA_LOG_INTERVAL) {
+        lastLogTime = currentTime;
+        
+        logPolicy.offer(uiStatus, currentTime);
+        LogEntry entry;
+        while (logPolicy.next(entry)) {
             dataLogger.logData(
-                currentTemp,
-                params.targetTemperature,
-                ssrControl.getPowerPercentage(),
-                stateMachine.getRemainingTime()
+                entry.temperature,
+                entry.targetTemp,
+                entry.power,
+                entry.remainingTime,
+                entry.timestamp
             );
         }
     }
     
     // Update web interface if enabled
     if (ENABLE_WIFI) {
-        webInterface.update(
-            stateMachine.getCurrentState(),
-            currentTemp,
-            params.targetTemperature,
-            stateMachine.getRemainingTime(),
-            ssrControl.getPowerPercentage()
-        );
+        webInterface.update(uiStatus);
     }
     
-    // Update SSR control (needs to be called frequently for PWM)
-    ssrControl.update();
-    
-    // Small delay to prevent watchdog issues
-    delay(10);
-}
\ No newline at end of file
+    // Samples even while the broker is unreachable; idle unless begun
+    mqttClient.update(uiStatus);
+}
+
+// Staged log data to flash, a whole page at a time
+void logStep() {
+    if (ENABLE_DATA_LOGGING) {
+        dataLogger.commit();
+    }
+}
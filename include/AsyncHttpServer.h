@@ -0,0 +1,180 @@
+#ifndef ASYNC_HTTP_SERVER_H
+#define ASYNC_HTTP_SERVER_H
+
+#include <Arduino.h>
+#include <functional>
+#include "Config.h"
+#include "HAL.h"
+
+// Non-blocking HTTP/1.1 server on HAL::tcpServer().
+//
+// Requests are parsed incrementally as bytes arrive and responses are
+// written as the send window opens, all from the network callbacks: nothing
+// waits on a client, so a slow or stalled browser costs the control path
+// nothing. Each connection owns a fixed request buffer and a fixed response
+// buffer (HTTP_REQUEST_BUFFER_SIZE, HTTP_RESPONSE_BUFFER_SIZE); a request
+// that does not fit is answered 431/413 and the connection closed. Bodies
+// are either copied into the response buffer, sent straight from flash for
+// constant data such as the dashboard page, or pulled from an
+// HttpBodySource one response buffer at a time, so a file of any size is
+// served with no more RAM than a small response.
+//
+// Handlers run in the network context. They must not block and must not
+// touch control state directly.
+enum HttpMethod {
+    HTTP_METHOD_ANY,
+    HTTP_METHOD_GET,
+    HTTP_METHOD_HEAD,
+    HTTP_METHOD_POST,
+    HTTP_METHOD_OTHER
+};
+
+enum HttpRange {
+    HTTP_RANGE_NONE,                // no Range header, or one to ignore
+    HTTP_RANGE_SATISFIABLE,
+    HTTP_RANGE_UNSATISFIABLE
+};
+
+// Streamed response body. The server owns it once passed to sendStream()
+// and deletes it when the response ends or the connection drops; read() is
+// called from the network context as the send window opens.
+class HttpBodySource {
+public:
+    virtual ~HttpBodySource() {}
+    // Fills buffer with up to size bytes; returns the count, 0 at the end
+    virtual size_t read(uint8_t* buffer, size_t size) = 0;
+};
+
+class AsyncHttpServer;
+
+// One request/response exchange, valid for the duration of the handler
+class HttpRequest {
+    friend class AsyncHttpServer;
+
+private:
+    AsyncHttpServer* server;
+    int connection;
+    HttpMethod requestMethod;
+    const char* requestPath;
+    const char* requestQuery;       // without '?', empty if none
+    const char* headerStart;        // first header line
+    const char* requestBody;
+    size_t bodyLength;
+    bool responded;
+
+    HttpRequest() : server(nullptr), connection(-1), requestMethod(HTTP_METHOD_OTHER),
+                    requestPath(""), requestQuery(""), headerStart(""), requestBody(""),
+                    bodyLength(0), responded(false) {}
+
+public:
+    HttpMethod method() const { return requestMethod; }
+    const char* path() const { return requestPath; }
+    const char* body() const { return requestBody; }
+    size_t contentLength() const { return bodyLength; }
+
+    // URL-decoded query (or form body) argument into value; false if absent
+    // or longer than size - 1
+    bool arg(const char* name, char* value, size_t size) const;
+    bool hasArg(const char* name) const;
+    // Header value with surrounding whitespace removed; false if absent
+    bool header(const char* name, char* value, size_t size) const;
+    // Single byte range of a size byte resource, first to last inclusive.
+    // Multiple ranges, malformed ones and any with If-Range (there are no
+    // validators to check it against) are ignored: the whole resource is
+    // the correct answer to all of them.
+    HttpRange range(size_t size, size_t& first, size_t& last) const;
+
+    // Copies content into the connection's response buffer
+    void send(int code, const char* contentType, const char* content);
+    void send(int code, const char* contentType, const char* content, size_t length);
+    // Sends constant content without copying; it must outlive the response
+    void sendStatic(int code, const char* contentType, const uint8_t* content, size_t length,
+                    const char* extraHeaders = nullptr);
+    // Streams the body from source, which the server takes over. With a
+    // known length exactly that many bytes are sent; otherwise HTTP/1.1
+    // clients get chunked transfer encoding and HTTP/1.0 clients a body
+    // delimited by closing the connection.
+    static const size_t UNKNOWN_LENGTH = (size_t)-1;
+    void sendStream(int code, const char* contentType, HttpBodySource* source,
+                    size_t length = UNKNOWN_LENGTH, const char* extraHeaders = nullptr);
+};
+
+class AsyncHttpServer : public HalTcpServer::Listener {
+public:
+    typedef std::function<void(HttpRequest& request)> Handler;
+
+    struct Stats {
+        unsigned long requests;
+        unsigned long rejected;         // oversized or malformed
+        unsigned long bytesSent;
+    };
+
+private:
+    enum Phase { PHASE_CLOSED, PHASE_REQUEST, PHASE_RESPONSE };
+
+    struct Connection {
+        Phase phase;
+        char request[HTTP_REQUEST_BUFFER_SIZE + 1];     // + NUL terminator
+        size_t requestLength;
+        char response[HTTP_RESPONSE_BUFFER_SIZE];
+        size_t responseLength;
+        size_t responseSent;
+        const uint8_t* body;            // static body, nullptr if copied
+        size_t bodyLength;
+        size_t bodySent;
+        HttpBodySource* source;         // streamed body, refills response[]
+        size_t sourceRemaining;         // UNKNOWN_LENGTH unless Content-Length was sent
+        bool chunked;
+        bool keepAlive;
+        bool http11;
+    };
+
+    struct Route {
+        const char* path;
+        HttpMethod method;
+        Handler handler;
+    };
+
+    static const int MAX_ROUTES = 12;
+
+    Connection connections[HTTP_MAX_CONNECTIONS];
+    Route routes[MAX_ROUTES];
+    int routeCount;
+    Handler notFoundHandler;
+    Stats stats;
+    bool started;
+
+    // These return true when the response has been sent in full and the
+    // caller should finish() it
+    bool parse(int id);
+    bool dispatch(int id, char* headersEnd, size_t contentLength);
+    bool reject(int id, int code);
+    bool pump(int id);
+    bool refill(int id);
+    void finish(int id);
+    void release(int id);
+
+    bool beginResponse(int id, int code, const char* contentType, size_t contentLength,
+                       const char* extraHeaders);
+
+    friend class HttpRequest;
+
+public:
+    AsyncHttpServer();
+
+    void on(const char* path, HttpMethod method, Handler handler);
+    void onNotFound(Handler handler) { notFoundHandler = handler; }
+    bool begin(uint16_t port);
+
+    Stats getStats() { return stats; }
+
+    static const char* statusText(int code);
+
+    // HalTcpServer::Listener
+    void onConnect(int connection) override;
+    void onData(int connection, const uint8_t* data, size_t length) override;
+    void onSent(int connection) override;
+    void onDisconnect(int connection) override;
+};
+
+#endif // ASYNC_HTTP_SERVER_H
@@ -0,0 +1,45 @@
+#ifndef CASCADE_CONTROLLER_H
+#define CASCADE_CONTROLLER_H
+
+#include <Arduino.h>
+#include "Config.h"
+#include "HAL.h"
+#include "PIDCore.h"
+
+// Inner loop of the bath/heater-outlet cascade.
+//
+// The outer PIDController keeps regulating the bath and its output is read
+// as a power demand. Heater outlet temperature rises above the bath in
+// proportion to delivered power, so the demand becomes an outlet setpoint
+// bath + demand * CASCADE_OUTLET_RISE / 100, and a fast PIDCore on the outlet
+// probe drives the SSR. Heater-side disturbances (mains sag, scale, flow)
+// are corrected within a few inner samples instead of after they have
+// shown up in the bath.
+class CascadeController {
+private:
+    typedef PIDCore<PIDNumber, CASCADE_INNER_SAMPLE_TIME> InnerLoop;
+
+    InnerLoop inner;
+    bool active;
+    float outletSetpoint;
+    float output;
+    unsigned long lastTime;
+
+public:
+    CascadeController();
+
+    void begin();
+
+    // Bumpless engage at the current SSR power
+    void start(float outletTemp, float currentOutput);
+    void stop();
+
+    // demand: outer loop output in percent; returns SSR power in percent
+    float compute(float demand, float bathTemp, float outletTemp);
+
+    bool isActive() { return active; }
+    float getOutletSetpoint() { return outletSetpoint; }
+    float getOutput() { return output; }
+};
+
+#endif // CASCADE_CONTROLLER_H
@@ -0,0 +1,77 @@
+#ifndef COMMAND_BUS_H
+#define COMMAND_BUS_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "Config.h"
+#include "MpscQueue.h"
+
+enum CommandType {
+    COMMAND_START,
+    COMMAND_STOP,
+    COMMAND_PAUSE,
+    COMMAND_RESUME,
+    COMMAND_SET_TARGET,
+    COMMAND_SET_TIME,
+    COMMAND_SET_PID,
+    COMMAND_AUTOTUNE
+};
+
+enum CommandSource {
+    COMMAND_SOURCE_WEB,
+    COMMAND_SOURCE_SERIAL,
+    COMMAND_SOURCE_MQTT
+};
+
+struct PidGains {
+    float kp;
+    float ki;
+    float kd;
+};
+
+struct Command {
+    CommandType type;
+    CommandSource source;
+    union {
+        float temperature;          // COMMAND_SET_TARGET, °C
+        unsigned long seconds;      // COMMAND_SET_TIME
+        PidGains gains;             // COMMAND_SET_PID
+    };
+};
+
+// Remote operation of the controller: every frontend (web, serial console,
+// MQTT) posts typed commands from its own task, and StateMachine::update()
+// takes them on the control task at the start of each tick. Posting never
+// waits, so a slow network never reaches the control path; a full queue
+// drops the command and the frontend reports it.
+//
+// The text form is shared by all frontends: "start", "stop", "pause",
+// "resume", "autotune" (relay auto-tune at the target, from idle), "target"
+// with °C, "time" with seconds and "pid" with "<kp>,<ki>,<kd>". Values
+// outside MIN_TEMP..MAX_TEMP or MIN_COOKING_TIME..MAX_COOKING_TIME are
+// rejected, not clamped.
+class CommandBus {
+private:
+    MpscQueue<Command, COMMAND_QUEUE_SIZE> queue;
+    std::atomic<unsigned long> dropped;
+
+public:
+    CommandBus();
+
+    // Any task; false when the queue is full
+    bool post(const Command& command);
+    // Any task; all count commands, in order, or none when they don't fit
+    bool postAll(const Command* commands, int count);
+    // Control task only
+    bool take(Command& command);
+
+    unsigned long getDropped() { return dropped.load(std::memory_order_relaxed); }
+
+    // false for an unknown action or a missing, malformed or out-of-range
+    // value
+    static bool parse(const char* action, const char* value, CommandSource source, Command& command);
+    static const char* typeName(CommandType type);
+    static const char* sourceName(CommandSource source);
+};
+
+#endif // COMMAND_BUS_H
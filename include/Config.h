@@ -10,6 +10,7 @@
 #define ENCODER_BUTTON_PIN  25     // Rotary encoder push button
 #define SSR_PIN             26     // Solid State Relay control
 #define BUZZER_PIN          27     // Optional buzzer for alerts
+#define ZERO_CROSS_PIN      34     // Optional mains zero-cross detector (input only)
 
 // Display Configuration
 #define SCREEN_WIDTH        128
@@ -20,14 +21,85 @@
 // Temperature Sensor Configuration
 #define TEMP_RESOLUTION     12     // DS18B20 resolution (9-12 bits)
 #define TEMP_READ_INTERVAL  750    // ms
-#define TEMP_SENSOR_COUNT   1      // Number of temperature sensors
+// Coarser, faster bath reads while preheating. Off by default: the
+// PreheatController owns the SSR for all of preheat and the PID samples
+// once a second, so --plant --cook-time=14400 measures no change (0.40 C
+// overshoot, 0.23 C rms; 0.10 C / 0.05 C with tuned gains, either way)
+#define ENABLE_ADAPTIVE_RESOLUTION false
+#define ADAPTIVE_RES_FAST_ERROR 5.0  // °C from target above which 10-bit (187 ms) is used
+#define ADAPTIVE_RES_MEDIUM_ERROR 2.0 // °C above which 11-bit (375 ms) is used
+#define ADAPTIVE_RES_HYSTERESIS 0.3  // °C the error must clear a switch point to coarsen again
+#define ENABLE_KALMAN_FILTER true  // Bath temperature/rate estimate for the PID derivative
+#define KALMAN_RATE_NOISE   1e-6   // °C²/s³ - how quickly the heating rate can change
+#define KALMAN_MEASUREMENT_NOISE 1e-4 // °C² probe noise on top of quantization
+#define KALMAN_INITIAL_RATE_VARIANCE 1e-3 // (°C/s)²
+#define TEMP_SENSOR_MAX_FAILURES 3  // Consecutive failed reads before a probe counts as lost
+#define TEMP_SENSOR_COUNT   3      // Probe roles, bound by ROM code:
+#define SENSOR_BATH         0      //   water bath (controlled temperature)
+#define SENSOR_HEATER_OUTLET 1     //   heater outlet (cascade inner loop)
+#define SENSOR_CORE         2      //   food core probe (early finish)
+// ROM codes as printed at boot; all zeros leaves the role unbound. An
+// unbound bath takes the only probe on the bus not bound to another role.
+#define SENSOR_BATH_ADDRESS          {0, 0, 0, 0, 0, 0, 0, 0}
+#define SENSOR_HEATER_OUTLET_ADDRESS {0, 0, 0, 0, 0, 0, 0, 0}
+#define SENSOR_CORE_ADDRESS          {0, 0, 0, 0, 0, 0, 0, 0}
 
 // PID Control Parameters
 #define DEFAULT_KP          2.0
 #define DEFAULT_KI          0.5
 #define DEFAULT_KD          1.0
 #define PID_WINDOW_SIZE     5000   // ms (5 seconds)
+#define SSR_USE_TIMER       true   // Window edges from timer alarms instead of loop() polling
+#define SSR_SIGMA_DELTA     false  // Spread whole mains cycles evenly instead of one on-block per window
+#define SSR_SIGMA_DELTA_CYCLES 1   // Mains cycles per on/off decision (whole cycles, no DC)
+#define SSR_ZERO_CROSS_SYNC false  // Take sigma-delta decisions on ZERO_CROSS_PIN edges
+#define SSR_ZERO_CROSS_TIMEOUT 4   // Half-cycles without an edge before update() decides on its own
+#define MAINS_FREQUENCY     50     // Hz
 #define PID_SAMPLE_TIME     1000   // ms
+#define PID_SETPOINT_WEIGHT 1.0    // 2-DOF weight b of setpoint changes in P (0-1)
+#define PID_CORE_FIXED_POINT false // PIDCore number type: Q16.16 instead of float
+
+// Feed-forward Heat-Loss Model
+#define ENABLE_FEEDFORWARD  true
+#define AMBIENT_TEMP        20.0   // °C - assumed room temperature
+#define FEEDFORWARD_LOSS_GAIN 0.4  // %/°C - initial holding power per degree above ambient
+#define FEEDFORWARD_LEARN_BAND 0.3 // °C - error band counted as steady holding
+#define FEEDFORWARD_LEARN_WINDOW 600000 // ms of steady holding per learning update
+#define FEEDFORWARD_LEARN_RATE 0.5 // weight of each new estimate
+#define FEEDFORWARD_INTEGRAL_SHARE 0.2 // integral limit near the setpoint, share of output range
+#define FEEDFORWARD_INTEGRAL_BAND 0.5 // °C - error band where that limit applies
+
+// Cascaded Control (active when a heater outlet sensor is present)
+#define ENABLE_CASCADE_CONTROL true
+#define CASCADE_INNER_SAMPLE_TIME TEMP_READ_INTERVAL // ms
+#define CASCADE_OUTLET_RISE 20.0   // °C outlet above bath at full heater power
+#define CASCADE_INNER_KP    2.0    // %/°C outlet error
+#define CASCADE_INNER_KI    0.1    // %/(°C*s)
+#define CASCADE_INNER_KD    0.0
+
+// Core Probe
+#define ENABLE_CORE_FINISH  true
+#define CORE_DONE_BAND      0.5    // °C - core this close to target counts as done
+#define CORE_HOLD_TIME      600    // s the core must stay done before finishing
+
+// Predictive Preheat
+#define ENABLE_PREDICTIVE_PREHEAT true
+#define PREHEAT_SAMPLE_INTERVAL 1000 // ms between slope samples
+#define PREHEAT_SLOPE_SAMPLES 30   // samples in the dT/dt window
+#define PREHEAT_TIME_CONSTANT 20.0 // s - initial coast time constant
+#define PREHEAT_MIN_TIME_CONSTANT 2.0
+#define PREHEAT_MAX_TIME_CONSTANT 600.0
+#define PREHEAT_LEARN_RATE  0.5    // weight of each observed coast
+#define PREHEAT_MIN_SLOPE   0.001  // °C/s - slower cuts are not learned from
+#define PREHEAT_RAMP_BAND   0.5    // °C of predicted margin to ramp down over
+#define PREHEAT_HANDOVER_BAND 1.0  // °C - skip or end preheat this close to target
+
+// Relay Auto-Tuning
+#define AUTOTUNE_HYSTERESIS 0.1    // °C - relay switching band around the setpoint
+#define AUTOTUNE_CYCLES     4      // oscillation cycles averaged for Ku/Tu
+#define AUTOTUNE_MAX_BIAS_ADJUSTMENTS 6
+#define AUTOTUNE_SETTLE_BAND 0.25  // °C - verification band for settling time
+#define AUTOTUNE_TIMEOUT    14400000 // ms (4 hours)
 
 // Cooking Parameters
 #define DEFAULT_TARGET_TEMP 56.0   // °C
@@ -47,18 +119,62 @@
 
 // Data Logging
 #define ENABLE_DATA_LOGGING true
-#define DATA_LOG_INTERVAL   10000  // ms (10 seconds)
-#define MAX_LOG_ENTRIES     1000
+#define DATA_LOG_INTERVAL   1000   // ms - sampling, and the logging rate during bursts
+#define LOG_ADAPTIVE        true   // deadband and bursts (LogPolicy.h); false logs every sample
+#define LOG_DEADBAND_TEMP   0.15   // °C - outside bursts, log when the temperature moves this much
+#define LOG_DEADBAND_POWER  25.0   // % - ... or the power
+#define LOG_HEARTBEAT       60000  // ms - longest gap between logged samples
+#define LOG_BURST_DURATION  60000  // ms of logging every sample after an event
+#define LOG_BURST_DEVIATION 0.5    // °C from target that starts a burst while cooking
+#define LOG_PRETRIGGER_SAMPLES 10  // dropped samples logged ahead of a burst
+#define MAX_LOG_ENTRIES     1000   // per CSV file; binary sessions are not capped
+#define LOG_FORMAT_BINARY   true   // delta/XOR-compressed .bin logs instead of .csv
+#define LOG_TIME_UNIT       100    // ms per binary timestamp tick
+#define LOG_TEMPERATURE_BITS 7     // binary log resolution: 1/128 C
+#define LOG_POWER_BITS      4      // binary log resolution: 1/16 %
+#define LOG_MIN_FREE_SPACE  8192   // bytes - binary logging stops below this
+#define LOG_STAGING_SIZE    2048   // bytes of RAM between logData() and flash
+#define LOG_PAGE_SIZE       256    // SPIFFS page; commits fill whole pages
+#define LOG_COMMIT_INTERVAL 60000  // ms - most logged data a power failure can lose
+#define LOG_INDEX_INTERVAL  600000 // ms of binary log between .idx entries - seek granularity
 #define LOG_TO_SPIFFS       true
 #define LOG_TO_SD_CARD      false
 
+// Serial Console ("target=56.5", "start", ... one per line at 115200 baud)
+#define ENABLE_SERIAL_CONSOLE true
+#define SERIAL_LINE_SIZE    64     // bytes - longest command line
+
+// Task Split (ESP32: FreeRTOS tasks; the WiFi stack runs on core 0)
+#define ENABLE_TASK_SPLIT   true
+#define CONTROL_TASK_PERIOD 10     // ms - sensor, state machine, PID, SSR
+#define CONTROL_TASK_PRIORITY 5
+#define CONTROL_TASK_CORE   1
+#define UI_TASK_PERIOD      10     // ms - display, web, logging
+#define UI_TASK_PRIORITY    1
+#define UI_TASK_CORE        0
+#define LOG_TASK_PERIOD     100    // ms - commits staged log data to flash
+#define LOG_TASK_PRIORITY   1
+#define LOG_TASK_CORE       0
+#define TASK_STACK_SIZE     8192   // bytes
+#define STATUS_QUEUE_SIZE   8      // control -> UI snapshots
+#define COMMAND_QUEUE_SIZE  8      // remote commands from all frontends -> control, power of two
+
 // WiFi Configuration
 #define ENABLE_WIFI         true
 #define WIFI_SSID           "YourWiFiSSID"
 #define WIFI_PASSWORD       "YourWiFiPassword"
 #define MDNS_HOSTNAME       "sousvide"
 #define WEB_SERVER_PORT     80
+#define HTTP_MAX_CONNECTIONS 8     // concurrent HTTP connections, more are refused
+#define HTTP_REQUEST_BUFFER_SIZE 512 // bytes per connection - request line, headers, body
+#define HTTP_RESPONSE_BUFFER_SIZE 512 // bytes per connection - response headers and small bodies
+#define HTTP_IDLE_TIMEOUT   10000  // ms before an idle keep-alive connection is closed
 #define WEBSOCKET_PORT      81
+#define WEBSOCKET_MIN_INTERVAL 250 // ms between state pushes
+#define WEBSOCKET_BUFFER_SIZE 128  // bytes - largest state frame
+#define STATUS_BUFFER_SIZE  448    // bytes - /status JSON, must fit HTTP_RESPONSE_BUFFER_SIZE with headers
+#define HISTORY_DEFAULT_POINTS 300 // points a /history query returns unless asked
+#define HISTORY_MAX_POINTS  2000   // most points a /history query may ask for
 #define AP_MODE_ENABLED     false  // Enable Access Point mode if WiFi fails
 #define AP_SSID             "SousVide-AP"
 #define AP_PASSWORD         "12345678"
@@ -74,6 +190,14 @@
 #define MQTT_TOPIC_SETPOINT "sousvide/setpoint"
 #define MQTT_TOPIC_STATUS   "sousvide/status"
 #define MQTT_TOPIC_COMMAND  "sousvide/command"
+#define MQTT_TOPIC_TELEMETRY "sousvide/telemetry"
+#define MQTT_SAMPLE_INTERVAL 1000  // ms between telemetry samples
+#define MQTT_BATCH_SIZE     10     // samples per telemetry message
+#define MQTT_BUFFER_SAMPLES 1800   // samples held while the broker is unreachable (12 bytes each)
+#define MQTT_BACKLOG_BATCHES 4     // backlog messages sent per update after reconnecting
+#define MQTT_PAYLOAD_SIZE   512    // bytes - PubSubClient buffer, largest message
+#define MQTT_RECONNECT_MIN  1000   // ms, doubled after each failed attempt
+#define MQTT_RECONNECT_MAX  60000  // ms
 
 // Encoder Configuration
 #define ENCODER_STEPS_PER_NOTCH 4
@@ -90,7 +214,8 @@ enum SystemState {
     STATE_FINISHED,
     STATE_ERROR,
     STATE_CALIBRATION,
-    STATE_WIFI_CONFIG
+    STATE_WIFI_CONFIG,
+    STATE_AUTOTUNE
 };
 
 // Error Codes
@@ -0,0 +1,34 @@
+#ifndef CONTROL_STATUS_H
+#define CONTROL_STATUS_H
+
+#include <Arduino.h>
+#include "Config.h"
+
+// Published by the control side every step, consumed by the UI side and,
+// through WebInterface, by /status. Plain values only, so it can be copied
+// between tasks without locks on either end.
+struct ControlStatus {
+    unsigned long timestamp;        // ms, when the control step ran
+    SystemState state;
+    ErrorCode error;
+    float currentTemp;
+    float targetTemp;
+    float coreTemp;                 // SENSOR_ERROR_TEMP without a core probe
+    float tempRate;                 // °C/s
+    uint8_t activeSensors;
+    bool sensorError;
+    unsigned long cookingTime;      // s
+    unsigned long elapsedTime;      // s
+    unsigned long remainingTime;    // s
+    float power;                    // % delivered by the SSR
+    float pidOutput;                // %
+    float feedForward;              // %
+    float kp;                       // configured gains
+    float ki;
+    float kd;
+    bool pidAutoMode;
+    bool ssrEnabled;
+    bool ssrSafetyLocked;
+};
+
+#endif // CONTROL_STATUS_H
@@ -0,0 +1,89 @@
+// Generated by web/build_dashboard.py from web/dashboard.html - do not edit.
+// 3542 bytes of HTML (2812 minified), 1186 bytes gzipped.
+#ifndef DASHBOARD_PAGE_H
+#define DASHBOARD_PAGE_H
+
+#include <Arduino.h>
+
+#define DASHBOARD_WEBSOCKET_PORT 81
+#define DASHBOARD_ETAG "\"b80c9852f10b3d9b\""
+
+static const uint8_t DASHBOARD_HTML_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0x8d, 0x56, 0x6d, 0x6f, 0xe2, 0x46,
+    0x10, 0xfe, 0xce, 0xaf, 0x98, 0x72, 0x2f, 0x06, 0x35, 0x18, 0x08, 0x49, 0x94, 0x33, 0x2f, 0x55,
+    0x8e, 0x12, 0xe9, 0x2a, 0xf5, 0x82, 0x4a, 0xd4, 0x53, 0x75, 0x3a, 0xe9, 0x16, 0x7b, 0x81, 0x6d,
+    0x6c, 0xaf, 0xb5, 0xbb, 0x0e, 0x49, 0x39, 0xfe, 0x53, 0x7f, 0x43, 0x7f, 0x59, 0x67, 0xd6, 0x36,
+    0xd8, 0x01, 0x45, 0x88, 0x0f, 0x66, 0x77, 0x9f, 0x79, 0x9e, 0x99, 0xd9, 0x99, 0xb1, 0x07, 0x3f,
+    0xfd, 0x7a, 0x37, 0xbe, 0xff, 0x6b, 0x3a, 0x81, 0x95, 0x89, 0xc2, 0x51, 0x6d, 0x50, 0x3c, 0x38,
+    0x0b, 0xf0, 0x61, 0x84, 0x09, 0xf9, 0x68, 0x32, 0x9b, 0xf6, 0xce, 0x61, 0x26, 0x53, 0x0d, 0x7f,
+    0x8a, 0x80, 0xc3, 0x58, 0xc6, 0x46, 0xc9, 0x30, 0xe4, 0x6a, 0xd0, 0xce, 0x10, 0xb5, 0x41, 0xc4,
+    0x0d, 0x83, 0x98, 0x45, 0x7c, 0x58, 0x7f, 0x14, 0x7c, 0x9d, 0x48, 0x65, 0xea, 0xe0, 0x23, 0x90,
+    0xc7, 0x66, 0x58, 0x5f, 0x8b, 0xc0, 0xac, 0x86, 0x01, 0x7f, 0x14, 0x3e, 0x6f, 0xd9, 0xc5, 0x19,
+    0x88, 0x58, 0x18, 0xc1, 0xc2, 0x96, 0xf6, 0x59, 0xc8, 0x87, 0xdd, 0x3a, 0x92, 0x68, 0xf3, 0x4c,
+    0x64, 0x73, 0x19, 0x3c, 0xc3, 0x06, 0x16, 0x68, 0xdd, 0x5a, 0xb0, 0x48, 0x84, 0xcf, 0x1e, 0xdc,
+    0x28, 0xc4, 0xf6, 0x21, 0x62, 0x6a, 0x29, 0x62, 0x0f, 0xce, 0x3b, 0xc9, 0x53, 0x1f, 0xe6, 0xcc,
+    0x7f, 0x58, 0x2a, 0x99, 0xc6, 0x81, 0x07, 0x6f, 0x16, 0x1d, 0xfa, 0xf5, 0x61, 0x5b, 0x73, 0x49,
+    0x97, 0x89, 0x98, 0x2b, 0x64, 0x89, 0xd8, 0x53, 0xa6, 0xe8, 0xc1, 0x55, 0xc7, 0x5a, 0x15, 0x1c,
+    0x2c, 0x35, 0xb2, 0xca, 0xb1, 0x5e, 0x09, 0xc3, 0xfb, 0x90, 0xb0, 0x20, 0x10, 0xf1, 0x72, 0xa7,
+    0x22, 0x55, 0xc0, 0x55, 0x4b, 0xb1, 0x40, 0xa4, 0xda, 0x83, 0xae, 0xdd, 0xdc, 0xd6, 0x56, 0x5d,
+    0x64, 0xf7, 0x65, 0x28, 0x15, 0x8a, 0xf7, 0x7a, 0xbd, 0x3e, 0x18, 0xfe, 0x64, 0x5a, 0x2c, 0x14,
+    0x4b, 0x24, 0xf7, 0x31, 0x6e, 0xae, 0xac, 0x37, 0xda, 0x30, 0x83, 0xa9, 0xdb, 0x54, 0x9c, 0x87,
+    0x4e, 0x49, 0xa7, 0x7b, 0x79, 0x10, 0x0d, 0xbf, 0x5e, 0x5c, 0x2c, 0xae, 0x0f, 0xc4, 0x2f, 0x33,
+    0x6d, 0x1b, 0x21, 0x5e, 0xc1, 0x11, 0xd2, 0x6d, 0x6d, 0x9e, 0x1a, 0x23, 0x63, 0x3c, 0xda, 0xf3,
+    0xd3, 0xd9, 0x79, 0x25, 0xf8, 0x43, 0xc5, 0x8b, 0xf1, 0xcd, 0xed, 0x25, 0x12, 0xe4, 0x21, 0xe5,
+    0xb9, 0xc8, 0xf4, 0x3d, 0x88, 0x65, 0xcc, 0x8f, 0x7b, 0xe3, 0xa7, 0x4a, 0x93, 0x41, 0x22, 0x45,
+    0x11, 0x72, 0xe6, 0x81, 0xb7, 0x92, 0x8f, 0xf6, 0x0a, 0xaa, 0x32, 0x97, 0xac, 0x73, 0xf1, 0xc1,
+    0x06, 0x61, 0x78, 0x94, 0x14, 0xf7, 0xac, 0xc5, 0x3f, 0x1c, 0x83, 0xb8, 0x20, 0x46, 0xbb, 0xb1,
+    0xe6, 0x62, 0xb9, 0x32, 0x1e, 0x4a, 0x86, 0xc1, 0xce, 0xa9, 0x37, 0xe7, 0xdd, 0x0f, 0x57, 0xb7,
+    0x3d, 0xb2, 0x1e, 0xb4, 0xf3, 0x6a, 0x19, 0xb4, 0xf3, 0x62, 0xa5, 0xb2, 0xc1, 0x47, 0x20, 0x1e,
+    0xc1, 0x0f, 0x99, 0xd6, 0xc3, 0xfa, 0xae, 0x0e, 0xa8, 0xb8, 0x56, 0xdd, 0xd1, 0xf1, 0x12, 0xc6,
+    0x83, 0x8a, 0x55, 0x76, 0x5f, 0x64, 0x92, 0x8c, 0xc6, 0xa9, 0x52, 0x78, 0x93, 0x70, 0x8f, 0xae,
+    0x72, 0x85, 0xfb, 0x0a, 0xbd, 0x1c, 0xe8, 0x84, 0xc5, 0x05, 0x9a, 0x82, 0xa8, 0x83, 0x08, 0x50,
+    0x2d, 0xc3, 0x12, 0xb4, 0x3e, 0x6a, 0xb5, 0xd0, 0x41, 0x84, 0x8d, 0xfe, 0xfb, 0x77, 0x3c, 0x68,
+    0x27, 0x96, 0xec, 0x1e, 0x73, 0xcf, 0x4f, 0xe3, 0x32, 0x16, 0xfa, 0x0a, 0x95, 0x88, 0x38, 0xfc,
+    0xc1, 0x23, 0x8c, 0xce, 0xde, 0x70, 0x46, 0x63, 0x2d, 0xf1, 0x64, 0x77, 0x40, 0xc6, 0xde, 0xce,
+    0xbe, 0x30, 0x9e, 0xca, 0x35, 0x5d, 0xe9, 0xde, 0x26, 0xa1, 0x0d, 0xc2, 0xbe, 0x7b, 0x81, 0x9c,
+    0x61, 0x2a, 0x78, 0x19, 0x49, 0xb9, 0xe1, 0x25, 0x97, 0x32, 0x60, 0x1b, 0xb3, 0x77, 0x98, 0x79,
+    0xcc, 0x2f, 0x25, 0x31, 0x2f, 0x47, 0x19, 0xfb, 0xa1, 0xf0, 0x1f, 0x2c, 0x85, 0x32, 0x63, 0x29,
+    0x1f, 0xd0, 0xbf, 0x46, 0xb3, 0x4e, 0x1a, 0xca, 0x0c, 0xda, 0x19, 0xec, 0x28, 0x5e, 0x26, 0x15,
+    0xb8, 0x4c, 0x5e, 0x41, 0x27, 0x2c, 0xd5, 0xbc, 0x04, 0x9f, 0xd2, 0xba, 0x84, 0xcf, 0x5d, 0xcd,
+    0x1f, 0xda, 0x57, 0x22, 0x31, 0xa3, 0x1a, 0xba, 0xab, 0x0d, 0xcc, 0xee, 0x6f, 0xee, 0x27, 0x33,
+    0x18, 0xc2, 0x57, 0xe7, 0x53, 0x10, 0x72, 0xe7, 0x0c, 0x9c, 0x19, 0xde, 0x97, 0xd9, 0xdf, 0xd7,
+    0x6e, 0x0b, 0x93, 0x4c, 0xff, 0xa7, 0x8a, 0x63, 0xf1, 0x19, 0xd4, 0xa2, 0x55, 0x2e, 0xeb, 0x9c,
+    0xd5, 0x9c, 0x5b, 0x4c, 0xbf, 0x5e, 0xf1, 0x80, 0xb6, 0x27, 0x4a, 0x49, 0x65, 0xcf, 0x71, 0x36,
+    0xcc, 0x91, 0x48, 0xc8, 0x98, 0x96, 0x5f, 0xc4, 0xad, 0x00, 0xcd, 0x4d, 0x9a, 0xd0, 0xea, 0x06,
+    0xa7, 0x51, 0xcb, 0xa4, 0x74, 0x6b, 0xce, 0xb7, 0x7e, 0xee, 0x51, 0xc0, 0x70, 0xaa, 0x0e, 0x61,
+    0xb3, 0xed, 0xd7, 0x42, 0x94, 0xd5, 0xd2, 0x7f, 0xe0, 0xa6, 0x5f, 0x5b, 0xa4, 0xb1, 0x4f, 0x2c,
+    0x34, 0x60, 0x63, 0xee, 0x9b, 0x46, 0x13, 0x36, 0xb5, 0xec, 0x10, 0xd1, 0x31, 0x5f, 0xc3, 0x17,
+    0x3e, 0x9f, 0xd9, 0x75, 0xc3, 0x59, 0x6b, 0xaf, 0xdd, 0x76, 0xe0, 0x67, 0x08, 0xa5, 0x6f, 0xb5,
+    0xdd, 0x95, 0xd4, 0x86, 0x46, 0x35, 0xee, 0x39, 0xde, 0x75, 0xb7, 0xed, 0x34, 0xfb, 0xb9, 0xb5,
+    0x2b, 0xe3, 0x88, 0x6b, 0xcd, 0x96, 0x1c, 0x79, 0xf8, 0x23, 0x55, 0xfe, 0x70, 0x84, 0xdc, 0x77,
+    0xf3, 0xbf, 0x51, 0xc6, 0xc5, 0xab, 0xc5, 0xe1, 0xd6, 0x20, 0xaf, 0xce, 0xe0, 0xb7, 0xd9, 0xdd,
+    0x67, 0x37, 0x61, 0x4a, 0xf3, 0x86, 0x45, 0xba, 0xb4, 0xdd, 0x44, 0x2a, 0x6c, 0x02, 0x1c, 0x12,
+    0x0d, 0xfc, 0xb7, 0x2d, 0xf1, 0xfa, 0xa1, 0xd4, 0xc4, 0x8a, 0xbe, 0x22, 0x25, 0x86, 0x4d, 0x25,
+    0x2c, 0x53, 0xd3, 0xc8, 0x63, 0x38, 0xc3, 0x01, 0xd5, 0xe9, 0x90, 0xd1, 0x3e, 0xbc, 0x82, 0x09,
+    0x3d, 0x10, 0x0b, 0x68, 0x38, 0xa5, 0x0e, 0x73, 0xf0, 0xfd, 0x61, 0xd3, 0xd3, 0x84, 0x40, 0xfa,
+    0x69, 0x44, 0x0e, 0x60, 0xc7, 0x4c, 0x42, 0x4e, 0x7f, 0x3f, 0x3e, 0x7f, 0x0a, 0xaa, 0xf0, 0xa6,
+    0x4b, 0xd3, 0x79, 0x9c, 0xbd, 0x90, 0xd0, 0x0d, 0x32, 0x75, 0x4b, 0x00, 0xd7, 0xc8, 0x5b, 0xf1,
+    0xc4, 0x83, 0x46, 0x17, 0x5d, 0xb0, 0x62, 0xfb, 0x16, 0x3c, 0x45, 0xab, 0x84, 0x3e, 0x2a, 0xb5,
+    0x3f, 0x3f, 0x54, 0x52, 0x45, 0xbb, 0x52, 0x4a, 0x4e, 0x12, 0x2b, 0xf7, 0xf8, 0x81, 0xde, 0x42,
+    0xaa, 0x88, 0xd9, 0xf4, 0xda, 0x9b, 0x72, 0x2b, 0xf4, 0x85, 0xa6, 0x6d, 0xf9, 0x53, 0xb4, 0x32,
+    0xe0, 0xd1, 0x98, 0xec, 0xd1, 0x2e, 0x9c, 0x4e, 0x93, 0xea, 0xe9, 0x9d, 0x93, 0x0b, 0xd8, 0x49,
+    0x71, 0x8a, 0x40, 0x06, 0x7c, 0x29, 0x90, 0xf5, 0xe2, 0x57, 0xab, 0x63, 0x11, 0xdf, 0xe0, 0xc7,
+    0x0f, 0xd8, 0x2f, 0x2b, 0x75, 0x52, 0x8a, 0x58, 0x73, 0xac, 0xa7, 0x40, 0x53, 0xc9, 0x64, 0x2d,
+    0xb4, 0x92, 0xf8, 0x7e, 0x42, 0xc2, 0xdf, 0x99, 0x59, 0xb9, 0x8b, 0x50, 0x4a, 0x55, 0x60, 0xa0,
+    0x0d, 0xbd, 0x2b, 0x5b, 0x72, 0x19, 0x32, 0x12, 0x71, 0x6a, 0xf8, 0x0b, 0xec, 0x0e, 0xfc, 0x2e,
+    0x03, 0xa3, 0xd1, 0xd5, 0xde, 0x04, 0x0f, 0x09, 0xbf, 0xc7, 0x5c, 0x75, 0xa8, 0xfe, 0x71, 0x54,
+    0xc4, 0xb9, 0xf0, 0x08, 0x3a, 0xf0, 0x4b, 0xed, 0xfb, 0xdb, 0x8d, 0x5d, 0x6e, 0xbd, 0xb7, 0x9b,
+    0x5c, 0x06, 0xf3, 0x36, 0x33, 0xca, 0x4e, 0x29, 0xec, 0xa2, 0xc0, 0x4e, 0xc1, 0xc6, 0x39, 0x0e,
+    0x82, 0x8e, 0xd3, 0x24, 0x18, 0x51, 0xbf, 0x8a, 0xf9, 0x0e, 0x1e, 0xf1, 0xe6, 0x74, 0xa7, 0x99,
+    0x54, 0xb2, 0xa6, 0xb1, 0xbb, 0xb0, 0xfb, 0xa2, 0x88, 0xc5, 0x41, 0xd1, 0x62, 0xf9, 0x10, 0x79,
+    0xff, 0x3e, 0x9f, 0x35, 0x58, 0x3c, 0x2c, 0x78, 0xb6, 0xaf, 0x01, 0x18, 0x0e, 0x87, 0xfb, 0xb9,
+    0xe2, 0xde, 0x4d, 0x27, 0x9f, 0x9b, 0x05, 0xaa, 0x42, 0x55, 0x15, 0xa9, 0x4c, 0x7b, 0x7c, 0xdb,
+    0x5b, 0xa8, 0x63, 0xb7, 0x71, 0xee, 0x40, 0x05, 0x5a, 0x1a, 0xf4, 0x25, 0xa4, 0x4c, 0x5e, 0x00,
+    0xab, 0x33, 0x7e, 0x87, 0xb4, 0xdb, 0x19, 0x74, 0x37, 0x17, 0xfb, 0xf4, 0x9d, 0x90, 0x0f, 0x79,
+    0x7c, 0x0b, 0x64, 0x5f, 0x08, 0xed, 0xec, 0x23, 0xf7, 0x7f, 0x3f, 0x55, 0x0c, 0x9f, 0xfc, 0x0a,
+    0x00, 0x00,
+};
+
+#endif // DASHBOARD_PAGE_H
@@ -2,44 +2,101 @@
 #define DATA_LOGGER_H
 
 #include <Arduino.h>
-#include <SPIFFS.h>
+#include <atomic>
 #include "Config.h"
+#include "HAL.h"
+#include "LogCodec.h"
+#include "SpscQueue.h"
 
-struct LogEntry {
-    unsigned long timestamp;
-    float temperature;
-    float targetTemp;
-    float power;
-    unsigned long remainingTime;
+enum LogEventKind {
+    LOG_EVENT_OPEN,
+    LOG_EVENT_CLOSE,
+    LOG_EVENT_INDEX
 };
 
+// Session boundaries and index entries travel to the writer in order with
+// the staged bytes
+struct LogSessionEvent {
+    size_t position;            // staged byte count when the event was posted
+    LogEventKind kind;
+    char fileName[32];          // LOG_EVENT_OPEN: file to open
+    LogIndexEntry index;        // LOG_EVENT_INDEX: entry for the session's .idx
+};
+
+// Logs samples during a cook, as CSV or in the binary format of LogCodec.h.
+//
+// logData() never touches the filesystem: it encodes the sample into a RAM
+// staging ring and returns. commit(), called from a background context (the
+// log task), moves staged bytes to flash in whole LOG_PAGE_SIZE pages, so a
+// SPIFFS page is programmed once instead of on every sample. Partial pages
+// are committed only when the oldest staged byte is LOG_COMMIT_INTERVAL old
+// or a session ends, which bounds what a power failure can lose.
+//
+// A binary session also gets a sparse time index, /log_<ms>.idx, with an
+// entry every LOG_INDEX_INTERVAL (LogIndex in LogCodec.h), so readers such
+// as LogHistory can start decoding near a time.
+//
+// logData() and the session calls belong to one task, commit() to another;
+// they share only the ring and the session event queue.
 class DataLogger {
 private:
     bool enabled;
-    File logFile;
     String currentLogFileName;
     unsigned long logStartTime;
     int entryCount;
-    
+    bool binary;
+    bool sessionOpen;
+    LogEncoder encoder;
+    unsigned long droppedEntries;
+    unsigned long nextIndexTime;
+
+    // Staging ring; positions count bytes since begin() and never wrap
+    uint8_t staging[LOG_STAGING_SIZE];
+    std::atomic<size_t> stagedBytes;        // written by the logging side
+    std::atomic<size_t> committedBytes;     // written by commit()
+    std::atomic<bool> storageLow;           // set by commit()
+    SpscQueue<LogSessionEvent, 8> sessionEvents;
+
+    // Writer side
+    HalFile* logFile;
+    HalFile* indexFile;
+    size_t fileBytes;
+    unsigned long pendingSince;
+
 public:
     DataLogger();
-    
+
     bool begin();
     void logData(float temp, float target, float power, unsigned long remaining);
+    // A sample taken earlier, at time (HAL ms), e.g. one LogPolicy held back
+    void logData(float temp, float target, float power, unsigned long remaining, unsigned long time);
     void startNewSession();
     void endSession();
-    
+    // CSV or binary (LogCodec.h); takes effect with the next session
+    void setBinary(bool enabled) { binary = enabled; }
+
+    // Writer side: moves staged data to flash, from the log task
+    void commit();
+
     String getCurrentLogFileName() { return currentLogFileName; }
     int getEntryCount() { return entryCount; }
-    
-    bool exportToCSV(String& output);
+    // Samples lost because the ring was full
+    unsigned long getDroppedEntries() { return droppedEntries; }
+
     void clearAllLogs();
     size_t getUsedSpace();
     size_t getFreeSpace();
-    
+
 private:
     String generateFileName();
     bool mountFileSystem();
+    size_t stagingRoom();
+    bool stage(const uint8_t* data, size_t length);
+    bool stageEncoded();
+    bool postEvent(LogEventKind kind, const char* fileName, const LogIndexEntry* index);
+    void closeFiles();
+    void openFiles(const char* fileName);
+    void writeStaged(size_t until);
 };
 
-#endif // DATA_LOGGER_H
\ No newline at end of file
+#endif // DATA_LOGGER_H
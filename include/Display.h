@@ -5,6 +5,7 @@
 #include <Adafruit_GFX.h>
 #include <Adafruit_SSD1306.h>
 #include "Config.h"
+#include "HAL.h"
 
 class Display {
 private:
@@ -37,6 +38,7 @@ public:
     void showErrorScreen(ErrorCode error);
     void showCalibrationScreen(float currentTemp, float offset);
     void showWiFiConfigScreen(const char* ssid, const char* ip);
+    void showAutoTuneScreen(float currentTemp, float targetTemp, float power);
     
     // Update main screen based on state
     void updateScreen(SystemState state, float currentTemp, float targetTemp, 
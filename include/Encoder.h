@@ -3,6 +3,7 @@
 
 #include <Arduino.h>
 #include "Config.h"
+#include "HAL.h"
 
 class Encoder {
 public:
@@ -0,0 +1,80 @@
+#ifndef FIXED_POINT_H
+#define FIXED_POINT_H
+
+#include <Arduino.h>
+
+// Signed Q16.16 fixed-point number: 16 integer bits (±32767) and a
+// resolution of 1/65536. Enough for temperatures, percent outputs and PID
+// gains while keeping every operation on the integer pipeline. Every
+// operation saturates at the ends of the range instead of wrapping.
+class Q16_16 {
+private:
+    int32_t raw;
+
+    static int32_t saturate(int64_t value) {
+        if (value > INT32_MAX) return INT32_MAX;
+        if (value < INT32_MIN) return INT32_MIN;
+        return (int32_t)value;
+    }
+
+public:
+    static const int FRACTION_BITS = 16;
+    static const int32_t ONE = (int32_t)1 << FRACTION_BITS;
+
+    Q16_16() : raw(0) {}
+
+    static Q16_16 fromRaw(int32_t value) {
+        Q16_16 result;
+        result.raw = value;
+        return result;
+    }
+
+    static Q16_16 fromFloat(float value) {
+        return fromRaw(saturate((int64_t)(value * ONE + (value >= 0 ? 0.5f : -0.5f))));
+    }
+
+    // Whether fromFloat() represents value instead of saturating
+    static bool fits(float value) { return fabsf(value) < (float)(INT32_MAX / ONE + 1); }
+
+    static Q16_16 fromInt(int value) { return fromRaw((int32_t)value << FRACTION_BITS); }
+
+    int32_t getRaw() const { return raw; }
+    float toFloat() const { return raw * (1.0f / ONE); }
+
+    Q16_16 operator+(Q16_16 rhs) const { return fromRaw(saturate((int64_t)raw + rhs.raw)); }
+    Q16_16 operator-(Q16_16 rhs) const { return fromRaw(saturate((int64_t)raw - rhs.raw)); }
+    Q16_16 operator-() const { return fromRaw(saturate(-(int64_t)raw)); }
+    Q16_16 operator*(Q16_16 rhs) const {
+        return fromRaw(saturate(((int64_t)raw * rhs.raw) >> FRACTION_BITS));
+    }
+    Q16_16 operator/(Q16_16 rhs) const {
+        return fromRaw(saturate(((int64_t)raw << FRACTION_BITS) / rhs.raw));
+    }
+
+    Q16_16& operator+=(Q16_16 rhs) { return *this = *this + rhs; }
+    Q16_16& operator-=(Q16_16 rhs) { return *this = *this - rhs; }
+
+    bool operator<(Q16_16 rhs) const { return raw < rhs.raw; }
+    bool operator>(Q16_16 rhs) const { return raw > rhs.raw; }
+    bool operator<=(Q16_16 rhs) const { return raw <= rhs.raw; }
+    bool operator>=(Q16_16 rhs) const { return raw >= rhs.raw; }
+    bool operator==(Q16_16 rhs) const { return raw == rhs.raw; }
+    bool operator!=(Q16_16 rhs) const { return raw != rhs.raw; }
+};
+
+// Conversions used by templates that run on either float or Q16_16
+template <typename T>
+struct NumericTraits {
+    static T fromFloat(float value) { return value; }
+    static float toFloat(T value) { return value; }
+    static bool fits(float) { return true; }
+};
+
+template <>
+struct NumericTraits<Q16_16> {
+    static Q16_16 fromFloat(float value) { return Q16_16::fromFloat(value); }
+    static float toFloat(Q16_16 value) { return value.toFloat(); }
+    static bool fits(float value) { return Q16_16::fits(value); }
+};
+
+#endif // FIXED_POINT_H
@@ -0,0 +1,147 @@
+#ifndef HAL_H
+#define HAL_H
+
+#include <Arduino.h>
+#include <functional>
+#include "Config.h"
+
+// Hardware Abstraction Layer
+//
+// Every module reaches the hardware through these interfaces instead of
+// calling the Arduino core directly. The ESP32 build binds them to the real
+// peripherals (src/HalArduino.cpp); the native build binds them to simulated
+// backends (native/src/SimHal.cpp) so the firmware can run on a workstation.
+
+typedef uint8_t OneWireAddress[8];
+
+class HalClock {
+public:
+    virtual ~HalClock() {}
+
+    virtual unsigned long millis() = 0;
+    virtual unsigned long micros() = 0;
+    virtual void delay(unsigned long ms) = 0;
+};
+
+class HalGpio {
+public:
+    virtual ~HalGpio() {}
+
+    virtual void pinMode(uint8_t pin, uint8_t mode) = 0;
+    virtual void digitalWrite(uint8_t pin, uint8_t value) = 0;
+    virtual int digitalRead(uint8_t pin) = 0;
+    virtual void attachInterrupt(uint8_t pin, void (*handler)(), int mode) = 0;
+    virtual void detachInterrupt(uint8_t pin) = 0;
+};
+
+// One-shot alarm on a free-running microsecond timer. The callback runs in
+// interrupt context on the ESP32: it must be short, touch only volatile
+// state and may re-arm the alarm. Absolute alarm times keep a chain of
+// alarms free of accumulated latency.
+class HalTimer {
+public:
+    virtual ~HalTimer() {}
+
+    virtual void begin(void (*callback)()) = 0;
+    virtual uint64_t nowMicros() = 0;
+    virtual void alarmAt(uint64_t timeUs) = 0;     // a past time fires at once
+    virtual void cancel() = 0;
+};
+
+// DS18B20 bus at the level the DallasTemperature library exposes it
+class HalOneWire {
+public:
+    virtual ~HalOneWire() {}
+
+    virtual void begin(uint8_t pin) = 0;
+    virtual int getDeviceCount() = 0;
+    virtual bool getAddress(OneWireAddress address, int index) = 0;
+    virtual bool isConnected(const OneWireAddress address) = 0;
+    virtual void setResolution(const OneWireAddress address, uint8_t bits) = 0;
+    virtual uint8_t getResolution(const OneWireAddress address) = 0;
+    virtual void setWaitForConversion(bool wait) = 0;
+    virtual void requestTemperatures() = 0;
+    // Starts a conversion on one device only: a single addressed transaction
+    virtual bool requestTemperature(const OneWireAddress address) = 0;
+    // One scratchpad read with CRC check
+    virtual float getTempC(const OneWireAddress address) = 0;  // SENSOR_ERROR_TEMP on failure
+};
+
+class HalI2C {
+public:
+    virtual ~HalI2C() {}
+
+    virtual bool begin(int sda, int scl) = 0;
+    virtual void setClock(uint32_t frequency) = 0;
+    // Returns 0 on success, like TwoWire::endTransmission()
+    virtual uint8_t write(uint8_t address, const uint8_t* data, size_t length) = 0;
+    virtual size_t read(uint8_t address, uint8_t* data, size_t length) = 0;
+};
+
+class HalFile : public Print {
+public:
+    virtual ~HalFile() {}
+
+    using Print::write;
+    virtual size_t write(uint8_t b) override { return write(&b, 1); }
+    virtual size_t write(const uint8_t* buffer, size_t size) override = 0;
+
+    virtual int read(uint8_t* buffer, size_t size) = 0;
+    virtual int available() = 0;
+    virtual bool seek(size_t position) = 0;
+    virtual size_t position() = 0;
+    virtual size_t size() = 0;
+    virtual void flush() = 0;
+    virtual void close() = 0;
+};
+
+class HalFileSystem {
+public:
+    virtual ~HalFileSystem() {}
+
+    virtual bool begin(bool formatOnFail) = 0;
+    // mode is "r", "w" or "a"; returns nullptr on failure, caller deletes
+    virtual HalFile* open(const char* path, const char* mode) = 0;
+    virtual bool exists(const char* path) = 0;
+    virtual bool remove(const char* path) = 0;
+    virtual void listFiles(std::function<void(const char* path, size_t size)> callback) = 0;
+    virtual size_t usedBytes() = 0;
+    virtual size_t totalBytes() = 0;
+};
+
+// Event-driven TCP server in the style of AsyncTCP. The listener is called
+// from the network task (ESP32) or a loopback thread (host), never from
+// loop(), and must not block; writes take what fits in the send window and
+// onSent() reports when more room is available. Idle connections are
+// closed after HTTP_IDLE_TIMEOUT.
+class HalTcpServer {
+public:
+    class Listener {
+    public:
+        virtual ~Listener() {}
+        virtual void onConnect(int connection) = 0;     // 0 .. HTTP_MAX_CONNECTIONS - 1
+        virtual void onData(int connection, const uint8_t* data, size_t length) = 0;
+        virtual void onSent(int connection) = 0;
+        virtual void onDisconnect(int connection) = 0;
+    };
+
+    virtual ~HalTcpServer() {}
+
+    virtual bool begin(uint16_t port, Listener* listener) = 0;
+    virtual size_t write(int connection, const uint8_t* data, size_t length) = 0;  // bytes taken
+    virtual void close(int connection) = 0;
+};
+
+// Backend accessors, defined by exactly one backend per build
+class HAL {
+public:
+    static HalClock& clock();
+    static HalGpio& gpio();
+    static HalOneWire& oneWire();
+    static HalI2C& i2c();
+    static HalFileSystem& fs();
+    static HalTimer& timer();
+    static HalTcpServer& tcpServer();
+};
+
+#endif // HAL_H
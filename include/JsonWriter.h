@@ -0,0 +1,55 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+#include <Arduino.h>
+
+// Streaming JSON writer into a caller-provided buffer.
+//
+// No heap, no printf: numbers are formatted with integer arithmetic, floats
+// as fixed-point with a given number of decimals (NaN and infinities become
+// null). Commas between members are inserted automatically. A value that
+// does not fit sets the overflow flag and everything after it is dropped;
+// finish() then returns 0 rather than a truncated document. Inside arrays
+// the name argument is ignored.
+class JsonWriter {
+private:
+    static const int MAX_DEPTH = 4;
+
+    char* buffer;
+    size_t size;
+    size_t length;
+    bool overflowed;
+    int depth;
+    bool needComma[MAX_DEPTH + 1];
+    bool inArray[MAX_DEPTH + 1];
+
+    void put(char c);
+    void put(const char* text);
+    void putUnsigned(uint64_t value);
+    void key(const char* name);
+    void begin(const char* name, char bracket, bool array);
+    void end(char bracket, bool array);
+
+public:
+    JsonWriter(char* buffer, size_t size);
+
+    // name is ignored at the top level and required inside an object
+    void beginObject(const char* name = nullptr);
+    void endObject();
+    void beginArray(const char* name = nullptr);
+    void endArray();
+
+    void addInt(const char* name, long value);
+    void addUnsigned(const char* name, unsigned long value);
+    void addFloat(const char* name, float value, uint8_t decimals);
+    void addBool(const char* name, bool value);
+    void addString(const char* name, const char* value);
+    void addNull(const char* name);
+
+    // NUL-terminates and returns the length, 0 on overflow or unbalanced
+    // objects and arrays
+    size_t finish();
+    bool isOverflowed() { return overflowed; }
+};
+
+#endif // JSON_WRITER_H
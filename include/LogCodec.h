@@ -0,0 +1,158 @@
+#ifndef LOG_CODEC_H
+#define LOG_CODEC_H
+
+#include <Arduino.h>
+#include <functional>
+#include "Config.h"
+
+struct LogEntry {
+    unsigned long timestamp;        // ms since the session started
+    float temperature;
+    float targetTemp;
+    float power;
+    unsigned long remainingTime;
+};
+
+#define LOG_CSV_HEADER      "Time(s),Temperature(C),Target(C),Power(%),Remaining(s)"
+#define LOG_MAGIC           "SVLG"
+#define LOG_VERSION         1
+#define LOG_HEADER_SIZE     20
+#define LOG_INDEX_MAGIC     "SVIX"
+#define LOG_INDEX_HEADER_SIZE 8
+#define LOG_INDEX_ENTRY_SIZE 40
+
+// Session header at the start of every binary log, stored little-endian:
+// magic, version, temperature and power fraction bits, one reserved byte,
+// timeUnit (uint16), two reserved bytes, interval and startTime (uint32).
+struct LogHeader {
+    uint8_t version;
+    uint8_t temperatureBits;        // values are multiples of 2^-bits
+    uint8_t powerBits;
+    uint16_t timeUnit;              // ms per timestamp tick
+    uint32_t interval;              // nominal sample interval, ms
+    uint32_t startTime;             // millis() when the session started
+};
+
+// What the encoder carries from one record to the next, and what a
+// decoder needs to pick up the stream in the middle
+struct LogCodecState {
+    uint32_t lastTime;              // timestamp ticks
+    int32_t lastTimeDelta;
+    uint32_t lastRemaining;
+    int32_t lastRemainingDelta;
+    uint32_t lastValue[3];
+    uint8_t lastLeading[3];
+    uint8_t lastTrailing[3];
+};
+
+// A point a binary log can be decoded from: the codec state after one
+// record and the bit where the next starts. Sessions keep a sparse list of
+// them in a .idx file beside the .bin (LogIndex), so a reader can seek by
+// time instead of decoding from the header.
+struct LogIndexEntry {
+    uint32_t bitOffset;             // from the start of the file
+    LogCodecState state;
+
+    // ms since the session started of the record before bitOffset
+    unsigned long time(uint16_t timeUnit) const { return (unsigned long)state.lastTime * timeUnit; }
+};
+
+// Binary log encoder in the style of Gorilla (Pelkonen et al., VLDB 2015).
+//
+// Each sample is a bit-packed record:
+//   timestamp      delta-of-delta in LOG_TIME_UNIT ticks, zigzag coded:
+//                  '0' (unchanged), '10'+7, '110'+9, '1110'+12 or
+//                  '11110'+32 bits; '11111' ends the stream
+//   temperature,   XOR against the previous value's float bits: '0' (same),
+//   target, power  '10'+bits inside the previous window, or '11'+5 bits
+//                  of leading zeros+5 bits of length-1+the bits
+//   remainingTime  delta-of-delta in seconds, coded like the timestamp
+//
+// Temperatures and power are first rounded to binary fractions
+// (LOG_TEMPERATURE_BITS, LOG_POWER_BITS) so steady values share most of
+// their bits. Records are not byte-aligned; complete bytes can be written
+// out after every sample and a power loss costs at most the last record.
+class LogEncoder {
+private:
+    // Worst case record is 206 bits, plus the byte still being filled
+    uint8_t buffer[32];
+    size_t bitCount;
+    size_t consumedBytes;           // since the header
+    LogCodecState state;
+
+    void writeBits(uint32_t value, int bits);
+    void writeDelta(int32_t deltaOfDelta);
+    void writeValue(int field, float value);
+
+public:
+    LogEncoder();
+
+    // Starts a new stream; returns the header bytes to write first
+    size_t begin(uint8_t* header, unsigned long startTime);
+    void add(const LogEntry& entry);
+    // Appends the end marker and pads the last byte
+    void finish();
+
+    // Complete bytes ready to be written; consume() drops them
+    const uint8_t* data() const { return buffer; }
+    size_t available() const { return bitCount / 8; }
+    void consume();
+
+    // Where decoding can resume before the next add()
+    LogIndexEntry indexEntry() const;
+
+    static float quantize(float value, int fractionBits);
+};
+
+// Reads a binary log back from any byte source (a HalFile on the device,
+// a FILE on the host). next() returns false at the end marker, and also
+// when the stream stops inside a record, as after a power loss; only
+// isComplete() tells the two apart.
+class LogDecoder {
+public:
+    // Fills buffer with up to size bytes; returns the count, 0 at the end
+    typedef std::function<int(uint8_t* buffer, size_t size)> Source;
+
+private:
+    Source source;
+    uint8_t buffer[64];
+    size_t length;
+    size_t bitIndex;
+    bool exhausted;
+    bool complete;
+
+    LogHeader header;
+    LogCodecState state;
+
+    bool readBits(int bits, uint32_t& value);
+    bool readDelta(int32_t& deltaOfDelta, bool& end);
+    bool readValue(int field, float& value);
+
+public:
+    LogDecoder(Source source);
+
+    // Reads and checks the header
+    bool begin();
+    const LogHeader& getHeader() const { return header; }
+    bool next(LogEntry& entry);
+    bool isComplete() const { return complete; }
+    // Continues from an index entry of this log, after begin(), once the
+    // source has been moved to byte entry.bitOffset / 8
+    bool resume(const LogIndexEntry& entry);
+
+    // One CSV line in the format DataLogger writes, with CRLF like println()
+    static size_t formatCSV(const LogEntry& entry, char* line, size_t size);
+};
+
+// The .idx file of a binary session: an 8-byte header (magic, version)
+// followed by LOG_INDEX_ENTRY_SIZE entries in time order, little-endian.
+// Entries are fixed-size so a reader can binary-search them by time.
+class LogIndex {
+public:
+    static size_t writeHeader(uint8_t* header);
+    static bool checkHeader(const uint8_t* header);
+    static void pack(const LogIndexEntry& entry, uint8_t* bytes);
+    static void unpack(const uint8_t* bytes, LogIndexEntry& entry);
+};
+
+#endif // LOG_CODEC_H
@@ -0,0 +1,88 @@
+#ifndef LOG_HISTORY_H
+#define LOG_HISTORY_H
+
+#include <Arduino.h>
+#include "Config.h"
+#include "HAL.h"
+#include "LogCodec.h"
+
+// Time-range query over one binary log, downsampled with Largest-Triangle-
+// Three-Buckets (Steinarsson, 2013) on the temperature series.
+//
+// The session's .idx puts the start of the range within LOG_INDEX_INTERVAL,
+// so a query costs the samples in its range, whatever the length of the
+// cook. The range is cut into points - 2 equal spans of time. The first and
+// last samples are kept, and from each span the one sample that forms the
+// largest triangle with the sample kept before it and the average of the
+// next non-empty span. Two decoders walk the range one span apart, the
+// leading one averaging, so nothing is buffered: memory stays constant
+// and points come out one at a time.
+class LogHistory {
+private:
+    // A decoder on its own handle of the log, one sample ahead
+    class Cursor {
+    private:
+        HalFile* file;
+        LogDecoder decoder;
+        LogEntry pending;
+        bool hasPending;
+
+    public:
+        unsigned long decoded;
+
+        Cursor();
+        ~Cursor();
+        // From the header, or from an index entry of the log
+        bool open(const char* path, const LogIndexEntry* start);
+        void close();
+        const LogHeader& getHeader() const { return decoder.getHeader(); }
+        bool peek(LogEntry& entry);
+        void skip() { hasPending = false; }
+    };
+
+    enum Phase { PHASE_FIRST, PHASE_BUCKETS, PHASE_LAST, PHASE_DONE };
+
+    char path[40];
+    LogHeader header;
+    unsigned long endTime;
+    bool opened;
+
+    Cursor trail;               // the span being selected from
+    Cursor lead;                // the span after it, for the average
+    Phase phase;
+    int buckets;
+    unsigned long spanEnd;
+    LogEntry first;
+    LogEntry last;              // the last sample of the range, once found
+    bool hasLast;
+    LogEntry kept;              // point A: the sample kept before
+    float averageTime;          // point C: the next span's average
+    float averageTemp;
+
+    bool findStart(unsigned long time, LogIndexEntry& entry, bool& found);
+    bool take(Cursor& cursor, LogEntry& entry);
+    int bucketOf(unsigned long time) const;
+    void average();
+    bool select(LogEntry& entry);
+
+public:
+    LogHistory();
+
+    // Reads the header, the index and the time of the last sample
+    bool open(const char* path);
+    const LogHeader& getHeader() const { return header; }
+    // ms since the session started of the last sample on flash
+    unsigned long getEndTime() const { return endTime; }
+
+    // Samples from from to to (ms since the session started, inclusive),
+    // at most points of them (at least 2)
+    bool query(unsigned long from, unsigned long to, int points);
+    bool next(LogEntry& entry);
+    // Samples decoded so far, both cursors
+    unsigned long getDecoded() const { return trail.decoded + lead.decoded; }
+
+    // One point as a JSON array: [seconds, temperature, target, power]
+    static size_t formatJSON(const LogEntry& entry, char* text, size_t size);
+};
+
+#endif // LOG_HISTORY_H
@@ -0,0 +1,68 @@
+#ifndef LOG_POLICY_H
+#define LOG_POLICY_H
+
+#include <Arduino.h>
+#include "Config.h"
+#include "ControlStatus.h"
+#include "LogCodec.h"
+
+// Decides which samples of the status stream reach the log.
+//
+// The sketch offers a sample every DATA_LOG_INTERVAL while preheating,
+// cooking and after the cook has finished. Outside bursts a deadband drops
+// samples until the temperature or the power has moved LOG_DEADBAND_TEMP or
+// LOG_DEADBAND_POWER from the last logged sample, with at least one sample
+// every LOG_HEARTBEAT. The newest dropped sample is logged ahead of the one
+// that breaks the deadband, so a chart drawn through the logged samples
+// stays within two deadbands of the full stream.
+//
+// A change of state or setpoint, or a deviation beyond LOG_BURST_DEVIATION
+// while cooking, starts a burst: every sample for LOG_BURST_DURATION, led
+// by the last LOG_PRETRIGGER_SAMPLES dropped ones, so the log shows what
+// happened just before the event as well.
+class LogPolicy {
+private:
+    bool adaptive;
+    bool active;                // the previous sample was in a logged state
+    SystemState lastState;
+    float lastTarget;
+    unsigned long burstUntil;
+
+    bool hasLogged;
+    LogEntry logged;            // the last sample logged
+
+    // Newest samples dropped since, ring
+    LogEntry dropped[LOG_PRETRIGGER_SAMPLES];
+    int droppedHead;            // next slot to write
+    int droppedCount;
+
+    // Waiting for next(): pendingDropped of the dropped ring, then current
+    int pendingDropped;
+    LogEntry current;
+    bool hasCurrent;
+
+    unsigned long offered;
+    unsigned long accepted;
+
+    static bool isLogged(SystemState state);
+    void drop(const LogEntry& entry);
+    void accept(const LogEntry& entry, int dropped);
+
+public:
+    LogPolicy();
+
+    // Deadband and bursts, or every sample; from the next offer()
+    void setAdaptive(bool enabled) { adaptive = enabled; }
+
+    // One sample of the status stream, taken at time (HAL ms). Drain next()
+    // before offering the following one.
+    void offer(const ControlStatus& status, unsigned long time);
+    // Samples to log, oldest first; timestamp is the HAL ms they were taken
+    bool next(LogEntry& entry);
+
+    bool inBurst(unsigned long time) const { return active && (long)(burstUntil - time) > 0; }
+    unsigned long getOffered() const { return offered; }
+    unsigned long getAccepted() const { return accepted; }
+};
+
+#endif // LOG_POLICY_H
@@ -0,0 +1,110 @@
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// Lock-free bounded multi-producer/single-consumer ring, for several tasks
+// (web, serial, MQTT) feeding one consumer without a mutex.
+//
+// Every slot carries a sequence number saying whose turn it is. A producer
+// claims the slot at tail with a compare-and-swap, writes the item and then
+// publishes it by advancing the slot's sequence with a release store; the
+// consumer reads a slot only once its sequence shows it published, and
+// hands it back to the producers one lap ahead. A producer preempted
+// between claim and publish holds up only the consumer, which sees the
+// queue as empty until then. Nothing blocks: push() fails when the ring is
+// full, pushAll() when it cannot take every item, and pop() when it is
+// empty. N must be a power of two.
+template <typename T, size_t N>
+class MpscQueue {
+private:
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "MpscQueue size must be a power of two");
+
+    struct Slot {
+        std::atomic<size_t> sequence;
+        T item;
+    };
+
+    Slot slots[N];
+    std::atomic<size_t> tail;   // next position to claim, shared by producers
+    size_t head;                // next position to read, consumer only
+
+public:
+    MpscQueue() : tail(0), head(0) {
+        for (size_t i = 0; i < N; i++) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Producer side, any task
+    bool push(const T& item) {
+        size_t position = tail.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &slots[position & (N - 1)];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            intptr_t lap = (intptr_t)sequence - (intptr_t)position;
+            if (lap == 0) {
+                // Free for this position; on failure position is reloaded
+                if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (lap < 0) {
+                return false;       // still holds an item from the last lap
+            } else {
+                position = tail.load(std::memory_order_relaxed);
+            }
+        }
+        slot->item = item;
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producer side: all count items in consecutive positions, or none.
+    // The consumer frees slots in order, so once the last slot of the range
+    // is free for this lap the ones before it are too, and a single
+    // compare-and-swap claims the whole range.
+    bool pushAll(const T* items, size_t count) {
+        if (count == 0) return true;
+        if (count > N) return false;
+
+        size_t position = tail.load(std::memory_order_relaxed);
+        for (;;) {
+            size_t last = position + count - 1;
+            size_t sequence = slots[last & (N - 1)].sequence.load(std::memory_order_acquire);
+            intptr_t lap = (intptr_t)sequence - (intptr_t)last;
+            if (lap == 0) {
+                if (tail.compare_exchange_weak(position, position + count, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (lap < 0) {
+                return false;
+            } else {
+                position = tail.load(std::memory_order_relaxed);
+            }
+        }
+        for (size_t i = 0; i < count; i++) {
+            Slot& slot = slots[(position + i) & (N - 1)];
+            slot.item = items[i];
+            slot.sequence.store(position + i + 1, std::memory_order_release);
+        }
+        return true;
+    }
+
+    // Consumer side
+    bool pop(T& item) {
+        Slot& slot = slots[head & (N - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != head + 1) {
+            return false;
+        }
+        item = slot.item;
+        slot.sequence.store(head + N, std::memory_order_release);
+        head++;
+        return true;
+    }
+
+    size_t capacity() { return N; }
+};
+
+#endif // MPSC_QUEUE_H
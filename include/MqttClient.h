@@ -0,0 +1,99 @@
+#ifndef MQTT_CLIENT_H
+#define MQTT_CLIENT_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <PubSubClient.h>
+#include "Config.h"
+#include "HAL.h"
+#include "ControlStatus.h"
+#include "CommandBus.h"
+
+// Telemetry and remote control over MQTT.
+//
+// A sample (temperature, setpoint, power, state) is taken every
+// MQTT_SAMPLE_INTERVAL into a RAM ring, whether or not the broker is
+// reachable. Every MQTT_BATCH_SIZE samples go out as one message on
+// MQTT_TOPIC_TELEMETRY, in columns:
+//
+//   {"seq":120,"t0":123000,"t":[0,1000,...],"temp":[56.06,...],
+//    "target":[56.00,...],"power":[14.8,...],"state":[4,...]}
+//
+// seq numbers samples since boot and t0 is the first sample's uptime in ms,
+// so a consumer can place late batches and see gaps. While the broker is
+// unreachable the ring holds up to MQTT_BUFFER_SAMPLES; beyond that the
+// oldest samples are overwritten and counted. After a reconnect the backlog
+// drains at MQTT_BACKLOG_BATCHES messages per update.
+//
+// The latest temperature and setpoint are also kept retained on
+// MQTT_TOPIC_TEMP and MQTT_TOPIC_SETPOINT, and MQTT_TOPIC_STATUS carries
+// {"online":true,"state":..,"error":..}, replaced by {"online":false}
+// through the last will when the connection drops. Text payloads on
+// MQTT_TOPIC_COMMAND are CommandBus commands ("start", "target=56.5").
+//
+// Runs in the UI task. Reconnects back off from MQTT_RECONNECT_MIN to
+// MQTT_RECONNECT_MAX; on the ESP32 a connect attempt to an unreachable
+// broker can block this task for the socket timeout, never the control task.
+class MqttClient {
+public:
+    struct Stats {
+        unsigned long samples;          // taken
+        unsigned long samplesSent;
+        unsigned long samplesDropped;   // overwritten while offline
+        unsigned long messages;         // all topics
+        unsigned long bytes;            // topic + payload
+        unsigned long connects;
+        unsigned long commands;         // accepted from MQTT_TOPIC_COMMAND
+    };
+
+private:
+    struct Sample {
+        uint32_t timestamp;             // ms
+        int16_t temperature;            // 0.01 °C
+        int16_t target;                 // 0.01 °C
+        uint16_t power;                 // 0.1 %
+        uint8_t state;
+    };
+
+    WiFiClient network;
+    PubSubClient client;
+    CommandBus* commandBus;
+    bool started;
+    bool wasConnected;
+
+    Sample* samples;                // MQTT_BUFFER_SAMPLES, allocated by begin()
+    size_t oldest;
+    size_t count;
+    uint32_t oldestSequence;
+    unsigned long lastSampleTime;
+
+    unsigned long nextAttemptTime;
+    unsigned long backoff;
+    bool statePublished;
+    int publishedState;
+    int publishedError;
+    int16_t publishedTarget;
+
+    char payload[MQTT_PAYLOAD_SIZE];
+    Stats stats;
+
+    bool connect();
+    void addSample(const ControlStatus& status, unsigned long now);
+    size_t serializeBatch(size_t samplesInBatch);
+    bool publishBatch();
+    void publishState(const ControlStatus& status);
+    bool publish(const char* topic, const char* text, size_t length, bool retained);
+    void handleMessage(char* topic, uint8_t* message, unsigned int length);
+
+public:
+    MqttClient();
+
+    void begin(CommandBus* bus);
+    void update(const ControlStatus& status);   // does nothing until begin()
+
+    bool isConnected() { return started && client.connected(); }
+    size_t getBacklog() { return count; }
+    Stats getStats() { return stats; }
+};
+
+#endif // MQTT_CLIENT_H
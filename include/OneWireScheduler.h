@@ -0,0 +1,71 @@
+#ifndef ONE_WIRE_SCHEDULER_H
+#define ONE_WIRE_SCHEDULER_H
+
+#include <Arduino.h>
+#include "Config.h"
+#include "HAL.h"
+
+// Pipelined DS18B20 reads with bounded bus time.
+//
+// Every probe is converted on its own, staggered across the read interval,
+// and poll() issues at most one scratchpad read (the oldest finished
+// conversion) and one addressed convert command (the next probe due) per
+// call. Results are cached, so getters never touch the bus and the bus time
+// of a loop() iteration stays the same however many probes are attached.
+//
+// Needs externally powered probes: a parasite-powered conversion would be
+// starved by traffic to the other devices.
+class OneWireScheduler {
+private:
+    struct Slot {
+        OneWireAddress address;
+        uint8_t resolution;
+        bool converting;
+        unsigned long requestTime;
+        unsigned long dueTime;
+        float reading;          // last value read, SENSOR_ERROR_TEMP if none
+        uint8_t failures;       // consecutive failed reads
+    };
+
+    HalOneWire* bus;
+    Slot slots[TEMP_SENSOR_COUNT];
+    int slotCount;
+    int nextSlot;               // round-robin start for convert commands
+    unsigned long interval;     // read interval at TEMP_RESOLUTION
+    unsigned long transactions;
+
+    int findFinished(unsigned long now);
+    int findDue(unsigned long now);
+    unsigned long slotInterval(const Slot& slot);
+
+public:
+    OneWireScheduler();
+
+    void begin(HalOneWire* bus, unsigned long interval);
+    int addDevice(const OneWireAddress address, uint8_t resolution);
+
+    // One broadcast conversion for every probe, so first readings are ready
+    // a conversion time after startup
+    void startAll();
+
+    // At most one read and one convert. Returns the slot with a new reading
+    // (which may be SENSOR_ERROR_TEMP), or -1.
+    int poll();
+
+    // Cached, no bus traffic
+    float getReading(int slot) { return slots[slot].reading; }
+    bool isResponding(int slot) { return slots[slot].failures < TEMP_SENSOR_MAX_FAILURES; }
+    uint8_t getResolution(int slot) { return slots[slot].resolution; }
+    int getDeviceCount() { return slotCount; }
+    unsigned long getTransactionCount() { return transactions; }
+    const uint8_t* getAddress(int slot) { return slots[slot].address; }
+
+    // Writes the configuration register; a pending conversion is restarted.
+    // The read interval scales with the conversion time, so a coarser
+    // probe is also read more often.
+    void setResolution(int slot, uint8_t bits);
+
+    static unsigned long conversionTime(uint8_t resolution);
+};
+
+#endif // ONE_WIRE_SCHEDULER_H
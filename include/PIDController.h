@@ -3,6 +3,7 @@
 
 #include <Arduino.h>
 #include "Config.h"
+#include "HAL.h"
 
 class PIDController {
 private:
@@ -33,11 +34,27 @@ private:
     // Output
     float output;
     
+    // 2-DOF setpoint weighting: P and I act on a reference that jumps by
+    // setpointWeight of a setpoint change and relaxes to it with Ti = kp/ki
+    float setpointWeight;
+    float weightedSetpoint;
+    
+    // Feed-forward heat-loss model
+    bool feedForwardEnabled;
+    float ambientTemp;
+    float lossGain;             // output units per °C above ambient
+    float feedForward;
+    float learnOutputSum;       // output integrated over the steady window
+    unsigned long learnTime;    // ms of steady holding in the window
+    
 public:
     PIDController();
     
     void begin(float kp, float ki, float kd);
     float compute(float input);
+    // inputRate: dInput/dt in units per second from an estimator, used for
+    // the derivative instead of differencing successive inputs
+    float compute(float input, float inputRate);
     
     // Setters
     void setSetpoint(float sp);
@@ -46,6 +63,7 @@ public:
     void setSampleTime(unsigned long time);
     void setMode(bool automatic);
     void setReverse(bool reverse);
+    void setSetpointWeight(float weight);
     
     // Getters
     float getSetpoint() { return setpoint; }
@@ -53,6 +71,7 @@ public:
     float getKi() { return ki; }
     float getKd() { return kd; }
     float getOutput() { return output; }
+    float getSetpointWeight() { return setpointWeight; }
     bool isAutoMode() { return autoMode; }
     
     // Advanced features
@@ -60,13 +79,86 @@ public:
     void setDerivativeFilter(float alpha);
     void reset();
     
+    // Bumpless handover from another controller: picks the integral so the
+    // next compute() continues from currentOutput at this input.
+    // setMode(true) does the same with the output held while in manual.
+    void initialize(float input, float currentOutput);
+    
+    // Feed-forward: adds the estimated holding power lossGain * (setpoint -
+    // ambient) to the output, so the integral only has to cover the residual.
+    // lossGain is refined online from the average output while holding.
+    void enableFeedForward(bool enable, float lossGain = FEEDFORWARD_LOSS_GAIN);
+    void setAmbientTemperature(float temp) { ambientTemp = temp; }
+    void setLossGain(float gain);
+    float getLossGain() { return lossGain; }
+    float getFeedForward() { return feedForward; }
+    float getHoldingPower(float sp);
+    bool isFeedForwardEnabled() { return feedForwardEnabled; }
+    
     // Auto-tuning support
+    enum AutoTuneState {
+        AUTOTUNE_IDLE,
+        AUTOTUNE_RELAY,     // relay oscillation around the setpoint
+        AUTOTUNE_VERIFY,    // closed loop with the new gains, measuring the response
+        AUTOTUNE_DONE,
+        AUTOTUNE_FAILED
+    };
+    
+    enum TuningRule {
+        TUNING_ZIEGLER_NICHOLS,
+        TUNING_SOME_OVERSHOOT,
+        TUNING_NO_OVERSHOOT
+    };
+    
     struct TuningParameters {
         float kp, ki, kd;
-        float overshoot;
-        float settlingTime;
+        float overshoot;        // °C above target after switching to the new gains
+        float settlingTime;     // s until within AUTOTUNE_SETTLE_BAND, -1 if it never settled
+        float ultimateGain;     // Ku from the relay describing function
+        float ultimatePeriod;   // Tu in seconds
     };
+    
+    // Non-blocking: call autoTune() once per loop and drive the SSR with
+    // getOutput(). The first call starts a tune with the defaults if
+    // startAutoTune() was not called.
+    void startAutoTune(float hysteresis = AUTOTUNE_HYSTERESIS, int cycles = AUTOTUNE_CYCLES,
+                       TuningRule rule = TUNING_SOME_OVERSHOOT);
     TuningParameters autoTune(float input, float target);
+    void cancelAutoTune();
+    AutoTuneState getAutoTuneState() { return tuneState; }
+    TuningParameters getTuningResult() { return tuning; }
+    bool isAutoTuning() { return tuneState == AUTOTUNE_RELAY || tuneState == AUTOTUNE_VERIFY; }
+    
+private:
+    float update(float input, bool rateGiven, float inputRate);
+    void learnHoldingPower(float error, unsigned long timeChange);
+    
+    // Relay auto-tuner state
+    AutoTuneState tuneState;
+    TuningRule tuneRule;
+    int tuneCycles;
+    float tuneHysteresis;
+    float relayBias;
+    float relayAmplitude;
+    bool relayHigh;
+    bool relayStarted;
+    unsigned long tuneStartTime;
+    unsigned long switchHighTime;
+    unsigned long switchLowTime;
+    float peakMax;
+    float peakMin;
+    int biasAdjustments;
+    int goodCycles;
+    float periodSum;
+    float amplitudeSum;
+    unsigned long verifyStartTime;
+    unsigned long lastOutsideBand;
+    
+    TuningParameters tuning;
+    
+    void relayStep(float input, float target, unsigned long now);
+    void finishRelay(float input, float target);
+    void verifyStep(float input, float target, unsigned long now);
 };
 
 #endif // PID_CONTROLLER_H
\ No newline at end of file
@@ -0,0 +1,103 @@
+#ifndef PID_CORE_H
+#define PID_CORE_H
+
+#include <Arduino.h>
+#include "Config.h"
+#include "FixedPoint.h"
+
+// Minimal PID engine for fixed-rate loops, templated on the number type
+// (float or Q16_16) and the sample period.
+//
+// compute() must be called exactly every SampleTimeMs (timer interrupt,
+// RTOS task period). Because the period is a compile-time constant, ki * dt
+// and kd / dt are folded into the gains by setTunings() and a sample is
+// three multiplies, no divisions and no clock reads. Derivative acts on the
+// measurement and the integral is clamped to the output range.
+//
+// In Q16_16 the folded gains must stay within ±32767: kd / dt grows as the
+// period shrinks, so setTunings() rejects gains that would not fit rather
+// than clipping them.
+template <typename T, unsigned long SampleTimeMs>
+class PIDCore {
+private:
+    T kp;
+    T kiPerSample;      // ki * dt
+    T kdPerSample;      // kd / dt
+    T outputMin, outputMax;
+
+    T integral;
+    T lastInput;
+    T output;
+
+    T clamp(T value) {
+        if (value > outputMax) return outputMax;
+        if (value < outputMin) return outputMin;
+        return value;
+    }
+
+public:
+    static constexpr float SAMPLE_SECONDS = SampleTimeMs / 1000.0f;
+
+    PIDCore() {
+        integral = T();
+        lastInput = T();
+        output = T();
+        setOutputLimits(0, 100);
+        setTunings(0, 0, 0);
+    }
+
+    // false, keeping the previous gains, for negative gains or folded
+    // gains the number type cannot hold
+    bool setTunings(float kpValue, float kiValue, float kdValue) {
+        if (kpValue < 0 || kiValue < 0 || kdValue < 0) return false;
+        if (!NumericTraits<T>::fits(kpValue) || !NumericTraits<T>::fits(kiValue * SAMPLE_SECONDS) ||
+            !NumericTraits<T>::fits(kdValue / SAMPLE_SECONDS)) {
+            return false;
+        }
+
+        kp = NumericTraits<T>::fromFloat(kpValue);
+        kiPerSample = NumericTraits<T>::fromFloat(kiValue * SAMPLE_SECONDS);
+        kdPerSample = NumericTraits<T>::fromFloat(kdValue / SAMPLE_SECONDS);
+        return true;
+    }
+
+    void setOutputLimits(float min, float max) {
+        if (min >= max) return;
+
+        outputMin = NumericTraits<T>::fromFloat(min);
+        outputMax = NumericTraits<T>::fromFloat(max);
+        integral = clamp(integral);
+        output = clamp(output);
+    }
+
+    // Bumpless start: continue from currentOutput at this input
+    void initialize(T input, T currentOutput, T feedForward = T()) {
+        lastInput = input;
+        output = clamp(currentOutput);
+        integral = clamp(output - feedForward);
+    }
+
+    T compute(T setpoint, T input, T feedForward = T()) {
+        T error = setpoint - input;
+
+        integral = clamp(integral + kiPerSample * error);
+        T derivative = input - lastInput;
+        lastInput = input;
+
+        output = clamp(kp * error + integral - kdPerSample * derivative + feedForward);
+        return output;
+    }
+
+    T getOutput() { return output; }
+    T getIntegral() { return integral; }
+    float getKp() { return NumericTraits<T>::toFloat(kp); }
+};
+
+// Number type for fast loops, selected at compile time
+#if PID_CORE_FIXED_POINT
+typedef Q16_16 PIDNumber;
+#else
+typedef float PIDNumber;
+#endif
+
+#endif // PID_CORE_H
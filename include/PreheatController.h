@@ -0,0 +1,66 @@
+#ifndef PREHEAT_CONTROLLER_H
+#define PREHEAT_CONTROLLER_H
+
+#include <Arduino.h>
+#include "Config.h"
+#include "HAL.h"
+
+// Model-predictive preheat.
+//
+// Runs the heater flat out while the bath is far from the target and
+// predicts where the measured temperature will coast to once power is cut:
+// with a first-order lag between heater, water and probe the remaining rise
+// is dT/dt * timeConstant. As soon as that prediction reaches the target the
+// output drops to the holding power; when the coast has peaked the controller
+// hands over to the PID. The time constant is learned from every coast.
+class PreheatController {
+public:
+    enum Phase {
+        PHASE_IDLE,
+        PHASE_HEATING,      // full power, watching the predicted coast
+        PHASE_COASTING,     // holding power until the measured peak
+        PHASE_DONE          // ready to hand over to the PID
+    };
+
+private:
+    Phase phase;
+    float timeConstant;         // s, learned plant/probe lag
+    float holdingPower;         // % output while coasting
+    float output;
+
+    // Slope estimation over a ring of PREHEAT_SAMPLE_INTERVAL samples
+    float samples[PREHEAT_SLOPE_SAMPLES];
+    int sampleIndex;
+    int sampleCount;
+    unsigned long lastSampleTime;
+    float slope;                // °C/s
+
+    // Coast bookkeeping for learning the time constant
+    float cutTemperature;
+    float cutSlope;
+    float peakTemperature;
+    unsigned long peakTime;
+
+    void addSample(float input);
+    void learnTimeConstant();
+
+public:
+    PreheatController();
+
+    void start(float input, float target);
+    float compute(float input, float target);
+    void cancel();
+
+    void setHoldingPower(float power) { holdingPower = constrain(power, 0, 100); }
+    void setTimeConstant(float seconds);
+
+    Phase getPhase() { return phase; }
+    bool isActive() { return phase == PHASE_HEATING || phase == PHASE_COASTING; }
+    bool isDone() { return phase == PHASE_DONE; }
+    float getOutput() { return output; }
+    float getSlope() { return slope; }
+    float getTimeConstant() { return timeConstant; }
+    float getPredictedTemperature(float input) { return input + slope * timeConstant; }
+};
+
+#endif // PREHEAT_CONTROLLER_H
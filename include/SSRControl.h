@@ -3,7 +3,26 @@
 
 #include <Arduino.h>
 #include "Config.h"
+#include "HAL.h"
 
+// Time-proportioning SSR drive over a PID_WINDOW_SIZE window.
+//
+// With the timer the on and off edges are alarms on HAL::timer(): each edge
+// sets the pin and arms the next one at an absolute time, so edges land to
+// the microsecond however long loop() or the control task takes. Without it
+// update() compares the window position on every call and the edges move
+// by up to one loop iteration.
+//
+// In sigma-delta mode the window is replaced by burst firing: every
+// SSR_SIGMA_DELTA_CYCLES mains cycles an accumulator decides whether the
+// next cycles conduct, so 3 % power is 3 cycles in every 100 spread evenly
+// rather than a 150 ms block every 5 s. Decisions come from the timer, from
+// the zero-cross input when synchronized, or from update() as a fallback.
+// A zero-cross SSR still only switches at zero crossings; syncing just keeps
+// each decision a whole number of half-cycles. When the edges stop for
+// SSR_ZERO_CROSS_TIMEOUT half-cycles, update() drives the pin low and takes
+// the decisions itself until they return, so a lost detector cannot leave
+// the heater on.
 class SSRControl {
 private:
     uint8_t ssrPin;
@@ -11,20 +30,37 @@ private:
     unsigned long windowSize;
     float powerPercentage;
     float onTime;
-    bool enabled;
-    bool safetyLock;
+    volatile bool enabled;
+    volatile bool safetyLock;
     
-    // PWM parameters for fine control
-    bool usePWM;
-    int pwmChannel;
-    int pwmFrequency;
-    int pwmResolution;
+    // Timer-driven window, shared with the alarm interrupt
+    bool timerDriven;
+    volatile uint32_t onTimeUs;
+    volatile uint32_t windowSizeUs;
+    uint64_t windowStartUs;     // touched by the interrupt only
+    static SSRControl* instance;
+    
+    // Sigma-delta burst firing
+    bool sigmaDelta;
+    bool zeroCrossSync;
+    uint32_t cycleUs;               // time between decisions
+    volatile uint16_t level;        // power in 0.01 % steps
+    uint16_t accumulator;           // touched by the decision path only
+    uint8_t halfCycles;             // zero crossings since the last decision
+    unsigned long lastDecisionUs;   // polled fallback
+    
+    // Zero-cross watchdog
+    volatile uint32_t zeroCrossEdges;   // counted by the interrupt
+    volatile bool zeroCrossLost;        // update() decides while set
+    uint32_t seenEdges;
+    unsigned long lastEdgeUs;           // when update() last saw the count move
     
 public:
     SSRControl();
     
     void begin();
-    void begin(uint8_t pin);
+    void begin(uint8_t pin, bool useTimer = SSR_USE_TIMER);
+    void setModulation(bool useSigmaDelta, bool syncToZeroCross);  // before begin()
     void update();
     
     void setPower(float power);  // 0-100 or 0-windowSize
@@ -35,12 +71,25 @@ public:
     float getPowerPercentage();
     bool isEnabled();
     bool isSafetyLocked();
+    bool isTimerDriven() { return timerDriven; }
+    bool isSigmaDelta() { return sigmaDelta; }
+    bool isZeroCrossSynced() { return zeroCrossSync; }
+    bool isZeroCrossLost() { return zeroCrossLost; }
     
     void emergencyStop();
     void test();
     
 private:
-    void setPinState(bool state);
+    void IRAM_ATTR setPinState(bool state);
+    void retrigger();
+    bool watchZeroCross();
+    // Interrupt context, in IRAM like everything they call
+    void IRAM_ATTR timerEdge();
+    void IRAM_ATTR sigmaDeltaEdge();
+    void IRAM_ATTR zeroCrossEdge();
+    void IRAM_ATTR decideCycle();
+    static void IRAM_ATTR onTimer();
+    static void IRAM_ATTR onZeroCross();
 };
 
 #endif // SSR_CONTROL_H
\ No newline at end of file
@@ -0,0 +1,52 @@
+#ifndef SEQ_LOCK_H
+#define SEQ_LOCK_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// Single-writer sequence lock: the latest value of a plain struct, shared
+// with any number of readers on other tasks without a mutex.
+//
+// The writer bumps the sequence to odd, copies the value in and bumps it to
+// even again. A reader copies the value out between two loads of the
+// sequence and keeps the copy only if both were the same even number. The
+// writer never waits. Readers retry a few times and then give up rather
+// than spin: a reader that preempted the writer on the same core would
+// otherwise spin forever.
+template <typename T>
+class SeqLock {
+private:
+    T value;
+    std::atomic<uint32_t> sequence;
+
+    static const int READ_ATTEMPTS = 8;
+
+public:
+    SeqLock() : value(), sequence(0) {}
+
+    // Writer side
+    void write(const T& item) {
+        uint32_t s = sequence.load(std::memory_order_relaxed);
+        sequence.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        value = item;
+        sequence.store(s + 2, std::memory_order_release);
+    }
+
+    // Reader side: false if no consistent copy could be taken, or nothing
+    // was ever written
+    bool read(T& item) const {
+        for (int attempt = 0; attempt < READ_ATTEMPTS; attempt++) {
+            uint32_t before = sequence.load(std::memory_order_acquire);
+            if (before & 1) continue;
+            item = value;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence.load(std::memory_order_relaxed) == before) {
+                return before != 0;
+            }
+        }
+        return false;
+    }
+};
+
+#endif // SEQ_LOCK_H
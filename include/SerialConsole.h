@@ -0,0 +1,28 @@
+#ifndef SERIAL_CONSOLE_H
+#define SERIAL_CONSOLE_H
+
+#include <Arduino.h>
+#include "Config.h"
+#include "CommandBus.h"
+
+// Command frontend on the USB serial port: one command per line in
+// CommandBus text form, with the value after '=' or a space ("target=56.5",
+// "time 7200", "pid 2,0.5,1", "start"). Each line is answered with "ok" or
+// "error: ...". update() only reads what has already arrived.
+class SerialConsole {
+private:
+    CommandBus* commandBus;
+    char line[SERIAL_LINE_SIZE];
+    size_t length;
+    bool overflowed;            // rest of an overlong line is discarded
+
+    void handleLine();
+
+public:
+    SerialConsole();
+
+    void begin(CommandBus* bus);
+    void update();
+};
+
+#endif // SERIAL_CONSOLE_H
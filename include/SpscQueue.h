@@ -0,0 +1,71 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// Lock-free single-producer/single-consumer ring for passing values between
+// two tasks (or a task and an ISR) without a mutex.
+//
+// The producer only writes tail, the consumer only writes head; each side
+// publishes with a release store and observes the other with an acquire
+// load, so an element is fully written before it becomes visible. One slot
+// stays empty to tell full from empty. Neither side ever blocks: push()
+// fails when the ring is full and pop() when it is empty.
+template <typename T, size_t N>
+class SpscQueue {
+private:
+    T items[N];
+    std::atomic<size_t> head;   // next slot to read
+    std::atomic<size_t> tail;   // next slot to write
+
+public:
+    SpscQueue() : head(0), tail(0) {}
+
+    // Producer side
+    bool push(const T& item) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t next = (t + 1) % N;
+        if (next == head.load(std::memory_order_acquire)) {
+            return false;
+        }
+        items[t] = item;
+        tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool pop(T& item) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = items[h];
+        head.store((h + 1) % N, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: the oldest element, left in the queue
+    bool peek(T& item) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        item = items[h];
+        return true;
+    }
+
+    // Consumer side: drains the queue keeping only the newest element
+    bool popLatest(T& item) {
+        bool any = false;
+        while (pop(item)) {
+            any = true;
+        }
+        return any;
+    }
+
+    bool isEmpty() { return head.load(std::memory_order_acquire) == tail.load(std::memory_order_acquire); }
+    size_t capacity() { return N - 1; }
+};
+
+#endif // SPSC_QUEUE_H
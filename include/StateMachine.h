@@ -3,7 +3,9 @@
 
 #include <Arduino.h>
 #include "Config.h"
+#include "HAL.h"
 #include "Encoder.h"
+#include "CommandBus.h"
 
 class StateMachine {
 private:
@@ -19,12 +21,23 @@ private:
     bool alarmActive;
     ErrorCode lastError;
     
+    // Core probe, SENSOR_ERROR_TEMP when not fitted
+    float coreTemperature;
+    bool coreInBand;
+    unsigned long coreInBandSince;
+    
+    CommandBus* commandBus;
+    
 public:
     StateMachine();
     
     void begin();
+    // Takes queued remote commands first, then runs the current state
     void update(float currentTemp, Encoder& encoder);
     
+    void setCommandBus(CommandBus* bus) { commandBus = bus; }
+    void applyCommand(const Command& command);
+    
     SystemState getCurrentState() { return currentState; }
     SystemState getPreviousState() { return previousState; }
     CookingParameters getCookingParameters() { return cookingParams; }
@@ -40,9 +53,19 @@ public:
     void pauseCooking();
     void resumeCooking();
     
+    // PID auto-tuning around the current target temperature
+    void startAutoTune();
+    void applyTuning(float kp, float ki, float kd);
+    
+    // Food core temperature; a cook finishes early once the core has held
+    // the target for CORE_HOLD_TIME
+    void setCoreTemperature(float temp) { coreTemperature = temp; }
+    float getCoreTemperature() { return coreTemperature; }
+    
     void setError(ErrorCode error);
     void clearError();
     bool hasError() { return lastError != ERROR_NONE; }
+    ErrorCode getLastError() { return lastError; }
     
     void enableAlarm(bool enable);
     bool isAlarmActive() { return alarmActive; }
@@ -55,8 +78,10 @@ private:
     void handleCookingState(float currentTemp, Encoder& encoder);
     void handleFinishedState(float currentTemp, Encoder& encoder);
     void handleErrorState(float currentTemp, Encoder& encoder);
+    void handleAutoTuneState(float currentTemp, Encoder& encoder);
     
     bool checkTemperatureReached(float current, float target, float tolerance = 1.0);
+    bool isCoreDone();
     void updateAlarm(float currentTemp);
 };
 
@@ -0,0 +1,72 @@
+#ifndef TASKS_H
+#define TASKS_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "Config.h"
+
+// Fixed-period task with a priority, pinned to a core.
+//
+// On the ESP32 this is a FreeRTOS task released by vTaskDelayUntil()
+// (src/TasksFreeRTOS.cpp); on the host a std::thread sleeping until the next
+// release on the steady clock (native/src/SimTasks.cpp), so release jitter
+// can be measured on a workstation. The period grid is kept: a late run does
+// not shift later releases.
+struct TaskStats {
+    unsigned long runs;
+    unsigned long maxJitterUs;      // worst deviation of a start-to-start interval from the period
+    float meanJitterUs;
+    unsigned long maxRunUs;         // worst body execution time
+    unsigned long overruns;         // bodies that took longer than the period
+};
+
+class PeriodicTask {
+private:
+    const char* name;
+    void (*body)();
+    unsigned long periodMs;
+    uint8_t priority;
+    int8_t core;                    // -1: no affinity
+    uint32_t stackSize;
+
+    void* volatile handle;          // TaskHandle_t or std::thread*
+    std::atomic<bool> running;
+
+    // Written by the task, read by others for diagnostics only
+    TaskStats stats;
+    double jitterSum;
+
+    void record(unsigned long intervalUs, unsigned long runUs) {
+        unsigned long periodUs = periodMs * 1000;
+        unsigned long jitter = intervalUs > periodUs ? intervalUs - periodUs : periodUs - intervalUs;
+        stats.runs++;
+        jitterSum += jitter;
+        stats.meanJitterUs = jitterSum / stats.runs;
+        if (jitter > stats.maxJitterUs) stats.maxJitterUs = jitter;
+        if (runUs > stats.maxRunUs) stats.maxRunUs = runUs;
+        if (runUs > periodUs) stats.overruns++;
+    }
+
+    static void entry(void* param);
+
+public:
+    PeriodicTask(const char* name, void (*body)(), unsigned long periodMs,
+                 uint8_t priority, int8_t core, uint32_t stackSize = TASK_STACK_SIZE)
+        : name(name), body(body), periodMs(periodMs), priority(priority), core(core),
+          stackSize(stackSize), handle(nullptr), running(false) {
+        resetStats();
+    }
+
+    bool start();
+    void stop();        // returns once the body is no longer running
+    bool isRunning() { return running; }
+
+    const char* getName() { return name; }
+    TaskStats getStats() { return stats; }
+    void resetStats() {
+        stats = TaskStats{0, 0, 0, 0, 0};
+        jitterSum = 0;
+    }
+};
+
+#endif // TASKS_H
@@ -0,0 +1,39 @@
+#ifndef TEMPERATURE_KALMAN_H
+#define TEMPERATURE_KALMAN_H
+
+#include <Arduino.h>
+#include "Config.h"
+
+// Kalman filter on a single probe with a constant-rate model.
+//
+// The state is temperature and its rate of change; the process noise is a
+// random walk in the rate (KALMAN_RATE_NOISE, °C²/s³), the measurement noise
+// the probe's own noise plus the quantization of its current resolution.
+// The rate estimate gives the PID a derivative that does not jump by a whole
+// LSB per sample the way a difference of DS18B20 readings does.
+class TemperatureKalman {
+private:
+    float temperature;          // °C
+    float rate;                 // °C/s
+    float p00, p01, p11;        // covariance (symmetric)
+    float rateNoise;
+    float measurementNoise;
+    unsigned long lastTime;
+    bool initialized;
+
+public:
+    TemperatureKalman();
+
+    void reset();
+    void setNoise(float rateVariance, float measurementVariance);
+
+    // resolution: DS18B20 bits of this reading, for its quantization noise
+    void update(float measurement, uint8_t resolution, unsigned long timeMs);
+
+    bool isInitialized() { return initialized; }
+    float getTemperature() { return temperature; }
+    float getRate() { return rate; }
+    float getTemperatureVariance() { return p00; }
+};
+
+#endif // TEMPERATURE_KALMAN_H
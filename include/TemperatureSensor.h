@@ -1,36 +1,58 @@
 #ifndef TEMPERATURE_SENSOR_H
 #define TEMPERATURE_SENSOR_H
 
-#include <OneWire.h>
-#include <DallasTemperature.h>
 #include "Config.h"
+#include "HAL.h"
+#include "OneWireScheduler.h"
+#include "TemperatureKalman.h"
+#include "WindowStatistics.h"
 
+// Reads up to TEMP_SENSOR_COUNT DS18B20s on ONE_WIRE_BUS through a
+// OneWireScheduler, so update() costs at most one read and one convert and
+// the getters only return cached values. Probes take the roles SENSOR_BATH,
+// SENSOR_HEATER_OUTLET and SENSOR_CORE by ROM code, never by bus order,
+// which follows the codes rather than the wiring; a role whose probe is not
+// found stays absent. Calibration, filtering and the statistics apply to
+// the bath probe.
 class TemperatureSensor {
 private:
-    OneWire* oneWire;
-    DallasTemperature* sensors;
-    DeviceAddress sensorAddress;
-    float lastTemperature;
+    HalOneWire* sensors;
+    OneWireScheduler scheduler;
+    OneWireAddress roleAddress[TEMP_SENSOR_COUNT];  // all zeros while unbound
+    int roleSlot[TEMP_SENSOR_COUNT];    // scheduler slot of each role, -1 if absent
+    int slotRole[TEMP_SENSOR_COUNT];
+    float lastTemperature[TEMP_SENSOR_COUNT];
+    bool readingValid[TEMP_SENSOR_COUNT];
+    int activeSensors;
     float temperatureOffset;  // Calibration offset
-    unsigned long lastReadTime;
     bool sensorFound;
     bool isCalibrated;
     
-    // Moving average filter
+    // Moving average filter and window statistics, O(1) per reading
     static const int FILTER_SIZE = 10;
-    float tempHistory[FILTER_SIZE];
-    int historyIndex;
-    bool historyFilled;
+    WindowStatistics<FILTER_SIZE> statistics;
+    
+    // Temperature and dT/dt estimate for the PID
+    TemperatureKalman kalman;
     
 public:
     TemperatureSensor();
     ~TemperatureSensor();
     
+    // Binds a role to a probe before begin(); the SENSOR_*_ADDRESS values
+    // in Config.h are the defaults
+    void setRoleAddress(int role, const OneWireAddress address);
+    
     bool begin();
     void update();
     float getTemperature();
+    float getTemperature(int index);      // SENSOR_ERROR_TEMP if absent or failing
+    bool hasSensor(int index);
+    int getActiveSensorCount() { return activeSensors; }
     float getRawTemperature();
     float getFilteredTemperature();
+    float getEstimatedTemperature();      // Kalman, falls back to the last reading
+    float getTemperatureRate();           // °C/s, 0 until the filter has data
     bool isConnected();
     bool hasError();
     
@@ -41,21 +63,26 @@ public:
     
     // Sensor management
     int getSensorCount();
-    void printAddress(DeviceAddress deviceAddress);
-    bool getSensorAddress(DeviceAddress& address, int index = 0);
+    void printAddress(const OneWireAddress deviceAddress);
+    bool getSensorAddress(OneWireAddress address, int index = 0);
     void setResolution(uint8_t resolution);
     uint8_t getResolution();
     
+    // Bath probe resolution from the control error: 10/11-bit while
+    // preheating far from the target, TEMP_RESOLUTION otherwise
+    void adaptResolution(float error, bool preheating);
+    
     // Statistics
     float getMinTemperature();
     float getMaxTemperature();
     float getAverageTemperature();
+    float getTemperatureStdDev();
     void resetStatistics();
     
 private:
-    void updateMovingAverage(float newTemp);
-    float calculateMovingAverage();
     bool validateReading(float temp);
+    int findRole(const OneWireAddress address);
+    static bool isBound(const OneWireAddress address);
 };
 
 #endif // TEMPERATURE_SENSOR_H
\ No newline at end of file
@@ -2,39 +2,103 @@
 #define WEB_INTERFACE_H
 
 #include <WiFi.h>
-#include <WebServer.h>
-#include <ArduinoJson.h>
+#include <WebSocketsServer.h>
 #include "Config.h"
+#include "HAL.h"
+#include "AsyncHttpServer.h"
+#include "ControlStatus.h"
+#include "JsonWriter.h"
+#include "SeqLock.h"
+#include "CommandBus.h"
 
+// Dashboard over HTTP plus a push channel on WEBSOCKET_PORT.
+//
+// HTTP runs on AsyncHttpServer, whose handlers are called from the network
+// task as requests complete, so update() never waits on a browser.
+//
+// State goes out over the WebSocket only when a value changes at the
+// resolution the page shows (0.1 °C, 1 %, 1 s), at most every
+// WEBSOCKET_MIN_INTERVAL, and only the changed fields. Each update is
+// serialized once into a fixed buffer and broadcast to every viewer; a new
+// viewer gets one full snapshot. Text frames from viewers are commands in
+// CommandBus text form, "<action>" or "<action>=<value>".
+//
+// GET /status returns the full ControlStatus as JSON. update() publishes
+// each status through a sequence lock, the handler takes a consistent copy
+// from the network task and serializes it into a fixed buffer: no heap per
+// request.
+//
+// POST /control?action=<action>[&value=<value>] and POST /settings with any
+// of target, time and kp+ki+kd post commands to the CommandBus and answer
+// 202 once queued: the control task applies them on its next tick. GET
+// /settings returns the current target, time and gains.
+//
+// GET /logs lists the log files as JSON; GET /logs?file=<name> streams one
+// as it stands on flash, chunked and one response buffer at a time, with
+// single byte ranges for resuming or fetching only what was added since
+// the last sync. &format=csv decodes a binary log on the way out.
+//
+// GET /history?file=<name>.bin&last=<s>&points=<n> (or from=<s>&to=<s>,
+// seconds into the session) returns that stretch of a binary log reduced
+// to n points with LogHistory, as {"points":[[s,temp,target,power],...]}.
 class WebInterface {
 private:
-    WebServer* server;
+    // Pushed values at display resolution
+    struct PushState {
+        int state;
+        long currentTemp;           // 0.1 °C
+        long targetTemp;            // 0.1 °C
+        unsigned long remainingTime;
+        int power;                  // %
+    };
+    
+    AsyncHttpServer* server;
+    WebSocketsServer* socket;
     bool wifiConnected;
     String localIP;
     
+    PushState pushed;
+    bool pushedAny;
+    uint32_t snapshotPending;       // viewers waiting for a full snapshot, one bit each
+    unsigned long lastPushTime;
+    char pushBuffer[WEBSOCKET_BUFFER_SIZE];
+    CommandBus* commandBus;
+    
+    SeqLock<ControlStatus> sharedStatus;
+    char statusBuffer[STATUS_BUFFER_SIZE];     // network task only
+    
 public:
     WebInterface();
     ~WebInterface();
     
     bool begin();
-    void update(SystemState state, float currentTemp, float targetTemp, 
-               unsigned long remainingTime, float power);
+    void update(const ControlStatus& status);
+    
+    void setCommandBus(CommandBus* bus) { commandBus = bus; }
     
     bool isConnected() { return wifiConnected; }
+    uint8_t getViewerCount() { return socket != nullptr ? socket->connectedClients() : 0; }
     String getIP() { return localIP; }
     
+    // /status document into buffer; returns the length, 0 if it did not fit
+    static size_t serializeStatus(const ControlStatus& status, char* buffer, size_t size);
+    
 private:
     bool connectWiFi();
     void setupRoutes();
-    void handleRoot();
-    void handleStatus();
-    void handleControl();
-    void handleSettings();
-    void handleNotFound();
-    
-    String generateHTML();
-    String generateJSON(SystemState state, float currentTemp, float targetTemp, 
-                       unsigned long remainingTime, float power);
+    void handleRoot(HttpRequest& request);
+    void handleStatus(HttpRequest& request);
+    void handleControl(HttpRequest& request);
+    void handleSettings(HttpRequest& request);
+    void handleLogs(HttpRequest& request);
+    void handleHistory(HttpRequest& request);
+    void handleNotFound(HttpRequest& request);
+    
+    void handleSocketEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t length);
+    void handleCommand(const uint8_t* text, size_t length);
+    void sendPostResult(HttpRequest& request, const Command* commands, int count);
+    void pushState(const ControlStatus& status);
+    size_t serializeState(const PushState& state, const PushState* previous);
 };
 
 #endif // WEB_INTERFACE_H
\ No newline at end of file
@@ -0,0 +1,121 @@
+#ifndef WINDOW_STATISTICS_H
+#define WINDOW_STATISTICS_H
+
+#include <Arduino.h>
+
+// Mean, variance, minimum and maximum over the last N samples, all updated
+// incrementally so every getter is O(1).
+//
+// The mean comes from a running sum and the variance from Welford's update
+// adapted to a sliding window (the outgoing sample is removed as the new one
+// is added). Minimum and maximum use monotonic deques of ring indices: each
+// sample is pushed and popped at most once, so add() is amortized O(1).
+// Rounding drift in the running sums is cleared by an exact recomputation
+// once per wrap of the ring, which keeps the amortized cost constant.
+template <int N>
+class WindowStatistics {
+private:
+    float samples[N];
+    int head;                   // next slot to write
+    int count;
+    unsigned long added;        // total samples, gives each one a sequence number
+
+    float sum;
+    float mean;
+    float m2;                   // sum of squared deviations from the mean
+
+    // Monotonic deques of sequence numbers, oldest at the front
+    unsigned long minQueue[N];
+    unsigned long maxQueue[N];
+    int minFront, minSize;
+    int maxFront, maxSize;
+
+    float at(unsigned long sequence) { return samples[sequence % N]; }
+
+    void push(unsigned long* queue, int& front, int& size, unsigned long sequence, bool keepSmaller) {
+        // Drop entries that can never be the extreme again
+        while (size > 0) {
+            float back = at(queue[(front + size - 1) % N]);
+            if (keepSmaller ? back < at(sequence) : back > at(sequence)) break;
+            size--;
+        }
+        queue[(front + size) % N] = sequence;
+        size++;
+    }
+
+    void expire(unsigned long* queue, int& front, int& size, unsigned long oldest) {
+        while (size > 0 && queue[front] < oldest) {
+            front = (front + 1) % N;
+            size--;
+        }
+    }
+
+    void recompute() {
+        sum = 0;
+        for (int i = 0; i < count; i++) {
+            sum += samples[i];
+        }
+        mean = sum / count;
+        m2 = 0;
+        for (int i = 0; i < count; i++) {
+            float d = samples[i] - mean;
+            m2 += d * d;
+        }
+    }
+
+public:
+    WindowStatistics() { reset(); }
+
+    void reset() {
+        head = 0;
+        count = 0;
+        added = 0;
+        sum = 0;
+        mean = 0;
+        m2 = 0;
+        minFront = minSize = 0;
+        maxFront = maxSize = 0;
+    }
+
+    void add(float value) {
+        if (count == N) {
+            // Replace the oldest sample in the Welford sums
+            float old = samples[head];
+            samples[head] = value;
+            float oldMean = mean;
+            sum += value - old;
+            mean += (value - old) / N;
+            m2 += (value - old) * (value - mean + old - oldMean);
+            if (m2 < 0) m2 = 0;
+        } else {
+            samples[head] = value;
+            count++;
+            sum += value;
+            float delta = value - mean;
+            mean += delta / count;
+            m2 += delta * (value - mean);
+        }
+
+        unsigned long sequence = added++;
+        head = (head + 1) % N;
+        if (head == 0) {
+            recompute();
+        }
+
+        unsigned long oldest = added > (unsigned long)N ? added - N : 0;
+        expire(minQueue, minFront, minSize, oldest);
+        expire(maxQueue, maxFront, maxSize, oldest);
+        push(minQueue, minFront, minSize, sequence, true);
+        push(maxQueue, maxFront, maxSize, sequence, false);
+    }
+
+    int getCount() { return count; }
+    bool isFull() { return count == N; }
+    float getMean() { return mean; }
+    float getVariance() { return count > 1 ? m2 / (count - 1) : 0; }
+    float getStandardDeviation() { return sqrtf(getVariance()); }
+    float getMin() { return minSize > 0 ? at(minQueue[minFront]) : 0; }
+    float getMax() { return maxSize > 0 ? at(maxQueue[maxFront]) : 0; }
+};
+
+#endif // WINDOW_STATISTICS_H
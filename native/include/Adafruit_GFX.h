@@ -0,0 +1,98 @@
+#ifndef NATIVE_ADAFRUIT_GFX_H
+#define NATIVE_ADAFRUIT_GFX_H
+
+#include <Arduino.h>
+
+// Subset of Adafruit_GFX used by Display. Text rendering uses the same
+// 6x8 cell metrics as the built-in font but draws a filled block per glyph,
+// which keeps the pixel-pushing cost realistic without shipping a font.
+class Adafruit_GFX : public Print {
+protected:
+    int16_t WIDTH, HEIGHT;
+    int16_t _width, _height;
+    int16_t cursor_x, cursor_y;
+    uint16_t textcolor;
+    uint8_t textsize;
+    uint8_t rotation;
+
+public:
+    Adafruit_GFX(int16_t w, int16_t h)
+        : WIDTH(w), HEIGHT(h), _width(w), _height(h), cursor_x(0), cursor_y(0),
+          textcolor(1), textsize(1), rotation(0) {}
+
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
+
+    void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+        int16_t dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+        int16_t dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+        int16_t err = dx + dy;
+        while (true) {
+            drawPixel(x0, y0, color);
+            if (x0 == x1 && y0 == y1) break;
+            int16_t e2 = 2 * err;
+            if (e2 >= dy) { err += dy; x0 += sx; }
+            if (e2 <= dx) { err += dx; y0 += sy; }
+        }
+    }
+
+    void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+        drawLine(x, y, x + w - 1, y, color);
+        drawLine(x, y + h - 1, x + w - 1, y + h - 1, color);
+        drawLine(x, y, x, y + h - 1, color);
+        drawLine(x + w - 1, y, x + w - 1, y + h - 1, color);
+    }
+
+    virtual void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+        for (int16_t j = y; j < y + h; j++) {
+            for (int16_t i = x; i < x + w; i++) drawPixel(i, j, color);
+        }
+    }
+
+    void fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+        for (int16_t y = -r; y <= r; y++) {
+            for (int16_t x = -r; x <= r; x++) {
+                if (x * x + y * y <= r * r) drawPixel(x0 + x, y0 + y, color);
+            }
+        }
+    }
+
+    void setCursor(int16_t x, int16_t y) { cursor_x = x; cursor_y = y; }
+    void setTextColor(uint16_t color) { textcolor = color; }
+    void setTextSize(uint8_t size) { textsize = size > 0 ? size : 1; }
+
+    void setRotation(uint8_t r) {
+        rotation = r & 3;
+        _width = (rotation & 1) ? HEIGHT : WIDTH;
+        _height = (rotation & 1) ? WIDTH : HEIGHT;
+    }
+
+    int16_t width() const { return _width; }
+    int16_t height() const { return _height; }
+
+    void getTextBounds(const char* str, int16_t x, int16_t y,
+                       int16_t* x1, int16_t* y1, uint16_t* w, uint16_t* h) {
+        *x1 = x;
+        *y1 = y;
+        *w = (uint16_t)(strlen(str) * 6 * textsize);
+        *h = (uint16_t)(8 * textsize);
+    }
+
+    void getTextBounds(const String& str, int16_t x, int16_t y,
+                       int16_t* x1, int16_t* y1, uint16_t* w, uint16_t* h) {
+        getTextBounds(str.c_str(), x, y, x1, y1, w, h);
+    }
+
+    using Print::write;
+    size_t write(uint8_t c) override {
+        if (c == '\n') {
+            cursor_x = 0;
+            cursor_y += 8 * textsize;
+        } else if (c != '\r') {
+            fillRect(cursor_x, cursor_y, 5 * textsize, 7 * textsize, textcolor);
+            cursor_x += 6 * textsize;
+        }
+        return 1;
+    }
+};
+
+#endif // NATIVE_ADAFRUIT_GFX_H
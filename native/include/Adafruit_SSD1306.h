@@ -0,0 +1,120 @@
+#ifndef NATIVE_ADAFRUIT_SSD1306_H
+#define NATIVE_ADAFRUIT_SSD1306_H
+
+#include <Adafruit_GFX.h>
+#include <Wire.h>
+
+#define SSD1306_BLACK           0
+#define SSD1306_WHITE           1
+#define SSD1306_INVERSE         2
+#define SSD1306_SWITCHCAPVCC    0x02
+#define SSD1306_EXTERNALVCC     0x01
+
+// SSD1306 stand-in with a real 1bpp framebuffer. display() pushes the whole
+// buffer over Wire in the same 32-byte chunks as the Adafruit driver, so the
+// flush cost shows up on the simulated I2C bus.
+class Adafruit_SSD1306 : public Adafruit_GFX {
+private:
+    TwoWire* wire;
+    uint8_t* buffer;
+    uint8_t i2caddr;
+
+    void command(uint8_t c) {
+        wire->beginTransmission(i2caddr);
+        wire->write((uint8_t)0x00);
+        wire->write(c);
+        wire->endTransmission();
+    }
+
+public:
+    Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* twi, int8_t rst_pin = -1)
+        : Adafruit_GFX(w, h), wire(twi), buffer(nullptr), i2caddr(0) {
+        (void)rst_pin;
+    }
+
+    ~Adafruit_SSD1306() { free(buffer); }
+
+    bool begin(uint8_t vcs = SSD1306_SWITCHCAPVCC, uint8_t addr = 0) {
+        (void)vcs;
+        if (buffer == nullptr) {
+            buffer = (uint8_t*)malloc(WIDTH * ((HEIGHT + 7) / 8));
+            if (buffer == nullptr) return false;
+        }
+        i2caddr = addr;
+        clearDisplay();
+        command(0xAE);  // display off
+        command(0xA8);  // multiplex
+        command(HEIGHT - 1);
+        command(0xAF);  // display on
+        return true;
+    }
+
+    void clearDisplay() {
+        memset(buffer, 0, WIDTH * ((HEIGHT + 7) / 8));
+    }
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+        if (x < 0 || x >= width() || y < 0 || y >= height()) return;
+        switch (rotation) {
+            case 1: { int16_t t = x; x = WIDTH - y - 1; y = t; break; }
+            case 2: x = WIDTH - x - 1; y = HEIGHT - y - 1; break;
+            case 3: { int16_t t = x; x = y; y = HEIGHT - t - 1; break; }
+        }
+        uint8_t& cell = buffer[x + (y / 8) * WIDTH];
+        uint8_t bit = (uint8_t)(1 << (y & 7));
+        if (color == SSD1306_WHITE) cell |= bit;
+        else if (color == SSD1306_BLACK) cell &= (uint8_t)~bit;
+        else cell ^= bit;
+    }
+
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override {
+        if (rotation != 0) {
+            Adafruit_GFX::fillRect(x, y, w, h, color);
+            return;
+        }
+
+        // Clip, then set whole page bytes per column like the real driver
+        if (x < 0) { w += x; x = 0; }
+        if (y < 0) { h += y; y = 0; }
+        if (x + w > WIDTH) w = WIDTH - x;
+        if (y + h > HEIGHT) h = HEIGHT - y;
+        if (w <= 0 || h <= 0) return;
+
+        for (int16_t page = y / 8; page <= (y + h - 1) / 8; page++) {
+            int16_t top = std::max<int16_t>(y, page * 8);
+            int16_t bottom = std::min<int16_t>(y + h, page * 8 + 8);
+            uint8_t mask = (uint8_t)(((1 << (bottom - top)) - 1) << (top & 7));
+            uint8_t* row = &buffer[page * WIDTH + x];
+            for (int16_t i = 0; i < w; i++) {
+                if (color == SSD1306_WHITE) row[i] |= mask;
+                else if (color == SSD1306_BLACK) row[i] &= (uint8_t)~mask;
+                else row[i] ^= mask;
+            }
+        }
+    }
+
+    void display() {
+        command(0x22);  // page address
+        command(0);
+        command(0xFF);
+        command(0x21);  // column address
+        command(0);
+        command(WIDTH - 1);
+
+        size_t count = WIDTH * ((HEIGHT + 7) / 8);
+        const uint8_t* ptr = buffer;
+        while (count > 0) {
+            size_t chunk = count > 31 ? 31 : count;
+            wire->beginTransmission(i2caddr);
+            wire->write((uint8_t)0x40);
+            wire->write(ptr, chunk);
+            wire->endTransmission();
+            ptr += chunk;
+            count -= chunk;
+        }
+    }
+
+    uint8_t* getBuffer() { return buffer; }
+};
+
+#endif // NATIVE_ADAFRUIT_SSD1306_H
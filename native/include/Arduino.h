@@ -0,0 +1,276 @@
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+// Minimal Arduino core stand-in for the native (Linux) build.
+//
+// Only the language-level pieces the firmware uses are provided here
+// (String, Print, Serial, F(), PROGMEM, constrain...). Anything that touches
+// hardware goes through HAL.h and is implemented by the simulated backends.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <cmath>
+#include <cstdlib>
+#include <string>
+#include <algorithm>
+
+using std::abs;
+using std::min;
+using std::max;
+
+#define HIGH            0x1
+#define LOW             0x0
+
+#define INPUT           0x01
+#define OUTPUT          0x03
+#define INPUT_PULLUP    0x05
+
+#define RISING          0x01
+#define FALLING         0x02
+#define CHANGE          0x03
+
+#define PI              3.1415926535897932384626433832795
+
+#define DEC             10
+#define HEX             16
+#define OCT             8
+#define BIN             2
+
+#define IRAM_ATTR
+#define PROGMEM
+#define PSTR(s)                 (s)
+#define pgm_read_byte(addr)     (*(const uint8_t*)(addr))
+#define memcpy_P                memcpy
+#define strlen_P                strlen
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper*>(string_literal))
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+class String {
+private:
+    std::string buffer;
+
+public:
+    String() {}
+    String(const char* cstr) : buffer(cstr != nullptr ? cstr : "") {}
+    String(const std::string& str) : buffer(str) {}
+    String(const __FlashStringHelper* str) : buffer(reinterpret_cast<const char*>(str)) {}
+    explicit String(char c) : buffer(1, c) {}
+    explicit String(int value, unsigned char base = 10) { fromLong(value, base); }
+    explicit String(long value, unsigned char base = 10) { fromLong(value, base); }
+    explicit String(unsigned char value, unsigned char base = 10) { fromUnsigned(value, base); }
+    explicit String(unsigned int value, unsigned char base = 10) { fromUnsigned(value, base); }
+    explicit String(unsigned long value, unsigned char base = 10) { fromUnsigned(value, base); }
+    explicit String(float value, unsigned char decimals = 2) { fromDouble(value, decimals); }
+    explicit String(double value, unsigned char decimals = 2) { fromDouble(value, decimals); }
+
+    const char* c_str() const { return buffer.c_str(); }
+    unsigned int length() const { return buffer.length(); }
+    bool isEmpty() const { return buffer.empty(); }
+    void reserve(unsigned int size) { buffer.reserve(size); }
+    char charAt(unsigned int index) const { return index < buffer.length() ? buffer[index] : 0; }
+    char operator[](unsigned int index) const { return charAt(index); }
+
+    String& operator+=(const String& rhs) { buffer += rhs.buffer; return *this; }
+    String& operator+=(const char* rhs) { buffer += rhs; return *this; }
+    String& operator+=(char c) { buffer += c; return *this; }
+    bool concat(const String& rhs) { buffer += rhs.buffer; return true; }
+    bool concat(const char* rhs) { buffer += rhs; return true; }
+    bool concat(const char* rhs, unsigned int length) { buffer.append(rhs, length); return true; }
+    bool concat(char c) { buffer += c; return true; }
+
+    bool operator==(const String& rhs) const { return buffer == rhs.buffer; }
+    bool operator==(const char* rhs) const { return buffer == rhs; }
+    bool operator!=(const String& rhs) const { return buffer != rhs.buffer; }
+    bool operator!=(const char* rhs) const { return buffer != rhs; }
+    bool operator<(const String& rhs) const { return buffer < rhs.buffer; }
+    bool equals(const String& rhs) const { return buffer == rhs.buffer; }
+
+    bool startsWith(const String& prefix) const {
+        return buffer.compare(0, prefix.buffer.length(), prefix.buffer) == 0;
+    }
+
+    bool endsWith(const String& suffix) const {
+        return buffer.length() >= suffix.buffer.length() &&
+               buffer.compare(buffer.length() - suffix.buffer.length(),
+                              suffix.buffer.length(), suffix.buffer) == 0;
+    }
+
+    int indexOf(char c, unsigned int from = 0) const {
+        size_t pos = buffer.find(c, from);
+        return pos == std::string::npos ? -1 : (int)pos;
+    }
+
+    int indexOf(const String& str, unsigned int from = 0) const {
+        size_t pos = buffer.find(str.buffer, from);
+        return pos == std::string::npos ? -1 : (int)pos;
+    }
+
+    String substring(unsigned int from) const {
+        return from < buffer.length() ? String(buffer.substr(from)) : String();
+    }
+
+    String substring(unsigned int from, unsigned int to) const {
+        if (from > to) std::swap(from, to);
+        if (from >= buffer.length()) return String();
+        return String(buffer.substr(from, to - from));
+    }
+
+    void trim() {
+        size_t first = buffer.find_first_not_of(" \t\r\n");
+        size_t last = buffer.find_last_not_of(" \t\r\n");
+        buffer = first == std::string::npos ? std::string() : buffer.substr(first, last - first + 1);
+    }
+
+    void toLowerCase() {
+        for (char& c : buffer) c = (char)tolower((unsigned char)c);
+    }
+
+    long toInt() const { return strtol(buffer.c_str(), nullptr, 10); }
+    float toFloat() const { return strtof(buffer.c_str(), nullptr); }
+
+    friend String operator+(const String& lhs, const String& rhs) {
+        String result(lhs);
+        result += rhs;
+        return result;
+    }
+
+    friend String operator+(const String& lhs, const char* rhs) {
+        String result(lhs);
+        result += rhs;
+        return result;
+    }
+
+    friend String operator+(const char* lhs, const String& rhs) {
+        String result(lhs);
+        result += rhs;
+        return result;
+    }
+
+private:
+    void fromLong(long value, unsigned char base) {
+        if (value < 0 && base == 10) {
+            buffer = "-";
+            appendUnsigned((unsigned long)(-value), base);
+        } else {
+            appendUnsigned((unsigned long)value, base);
+        }
+    }
+
+    void fromUnsigned(unsigned long value, unsigned char base) {
+        appendUnsigned(value, base);
+    }
+
+    void appendUnsigned(unsigned long value, unsigned char base) {
+        char digits[66];
+        int index = 0;
+        do {
+            unsigned long digit = value % base;
+            digits[index++] = (char)(digit < 10 ? '0' + digit : 'a' + digit - 10);
+            value /= base;
+        } while (value > 0);
+        while (index > 0) buffer += digits[--index];
+    }
+
+    void fromDouble(double value, unsigned char decimals) {
+        char text[48];
+        snprintf(text, sizeof(text), "%.*f", decimals, value);
+        buffer = text;
+    }
+};
+
+class Print {
+public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t b) = 0;
+
+    virtual size_t write(const uint8_t* buffer, size_t size) {
+        size_t written = 0;
+        while (size--) written += write(*buffer++);
+        return written;
+    }
+
+    size_t write(const char* str) {
+        return str == nullptr ? 0 : write((const uint8_t*)str, strlen(str));
+    }
+
+    virtual void flush() {}
+
+    size_t print(const __FlashStringHelper* str) { return write(reinterpret_cast<const char*>(str)); }
+    size_t print(const String& str) { return write((const uint8_t*)str.c_str(), str.length()); }
+    size_t print(const char* str) { return write(str); }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(unsigned char value, int base = DEC) { return print((unsigned long)value, base); }
+    size_t print(int value, int base = DEC) { return print((long)value, base); }
+    size_t print(unsigned int value, int base = DEC) { return print((unsigned long)value, base); }
+    size_t print(long value, int base = DEC) { return print(String(value, (unsigned char)base)); }
+    size_t print(unsigned long value, int base = DEC) { return print(String(value, (unsigned char)base)); }
+    size_t print(long long value, int base = DEC) { return print((long)value, base); }
+    size_t print(unsigned long long value, int base = DEC) { return print((unsigned long)value, base); }
+    size_t print(double value, int digits = 2) { return print(String(value, (unsigned char)digits)); }
+
+    size_t println() { return write("\r\n"); }
+
+    template <typename T>
+    size_t println(const T& value) {
+        size_t n = print(value);
+        return n + println();
+    }
+
+    template <typename T>
+    size_t println(const T& value, int format) {
+        size_t n = print(value, format);
+        return n + println();
+    }
+
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+// Console stand-in for the UART; output can be muted for benchmark runs and
+// input is whatever the runner feeds in
+class HardwareSerial : public Print {
+private:
+    bool muted;
+    std::string input;
+    size_t inputPosition;
+
+public:
+    HardwareSerial() : muted(false), inputPosition(0) {}
+
+    void begin(unsigned long baud) { (void)baud; }
+    void mute(bool state) { muted = state; }
+    bool isMuted() { return muted; }
+
+    // Native only: bytes for the firmware to read
+    void feed(const char* text) { input += text; }
+
+    int available() { return (int)(input.size() - inputPosition); }
+    int read() { return inputPosition < input.size() ? (uint8_t)input[inputPosition++] : -1; }
+
+    using Print::write;
+    size_t write(uint8_t b) override {
+        if (!muted) fputc(b, stdout);
+        return 1;
+    }
+
+    size_t write(const uint8_t* buffer, size_t size) override {
+        if (!muted) fwrite(buffer, 1, size, stdout);
+        return size;
+    }
+
+    void flush() override { fflush(stdout); }
+    operator bool() { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif // NATIVE_ARDUINO_H
@@ -0,0 +1,61 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include <Arduino.h>
+#include <chrono>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Host micro-benchmarks, run with `program --bench=<name>`.
+//
+// Ticks are TSC cycles on x86 (constant-rate, close to core cycles on a
+// fixed-frequency core) and nanoseconds elsewhere.
+inline uint64_t benchmarkTicks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+inline const char* benchmarkTickUnit() {
+#if defined(__x86_64__) || defined(__i386__)
+    return "cycles";
+#else
+    return "ns";
+#endif
+}
+
+// Heap use of the whole runner, counted by replacing the global operator
+// new: allocations made, and the most bytes live at once since the last
+// heapResetPeak()
+unsigned long heapAllocations();
+size_t heapLiveBytes();
+size_t heapPeakBytes();
+void heapResetPeak();
+
+// A TCP connection to the simulated server on 127.0.0.1, whose reads give
+// up after timeoutSeconds; -1 if it is refused
+int connectLoopback(uint16_t port, int timeoutSeconds);
+
+// Returns the process exit status; unknown names return 2
+int runBenchmark(const char* name);
+
+int benchmarkPid();
+int benchmarkOneWire();
+int benchmarkTasks();
+int benchmarkSsr();
+int benchmarkSigmaDelta();
+int benchmarkPush();
+int benchmarkHttp();
+int benchmarkStatus();
+int benchmarkMqtt();
+int benchmarkLog();
+int benchmarkFlash();
+int benchmarkLogs();
+int benchmarkHistory();
+int benchmarkLogPolicy();
+
+#endif // BENCHMARKS_H
@@ -0,0 +1,36 @@
+#ifndef COOK_METRICS_H
+#define COOK_METRICS_H
+
+#include <Arduino.h>
+
+// Control-quality figures for a simulated cook, sampled once per loop()
+// from the true water temperature.
+class CookMetrics {
+private:
+    float settleBand;
+    float target;
+    double startTime;
+    double reachedTime;
+    double lastOutsideBand;
+    float maxTemp;
+    float minAfterReach;
+    double sumSquaredError;
+    double errorSamples;
+    bool reached;
+
+public:
+    explicit CookMetrics(float band = 0.5);
+
+    void begin(float targetTemp, double now);
+    void sample(float waterTemp, double now);
+
+    bool hasReached() { return reached; }
+    double getTimeToSetpoint() { return reached ? reachedTime - startTime : -1; }
+    double getSettlingTime() { return reached ? lastOutsideBand - startTime : -1; }
+    float getOvershoot() { return reached ? maxTemp - target : 0; }
+    float getUndershoot() { return reached ? target - minAfterReach : 0; }
+    float getRmsError();
+    void print();
+};
+
+#endif // COOK_METRICS_H
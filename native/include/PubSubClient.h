@@ -0,0 +1,228 @@
+#ifndef NATIVE_PUB_SUB_CLIENT_H
+#define NATIVE_PUB_SUB_CLIENT_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <functional>
+#include <deque>
+#include <map>
+#include <vector>
+
+// PubSubClient (knolleary/pubsubclient) stand-in talking to an in-process
+// broker instead of a TCP connection.
+//
+// MqttBroker::instance() keeps every publish in order, holds retained
+// messages and queues messages for subscribed clients, which receive them
+// from their own loop() like the library does. setOnline(false) takes the
+// broker down: connected clients are dropped, a retained will replaces the
+// retained message on its topic, and connect() fails until it is back.
+
+#define MQTT_CONNECTION_TIMEOUT     -4
+#define MQTT_CONNECTION_LOST        -3
+#define MQTT_CONNECT_FAILED         -2
+#define MQTT_DISCONNECTED           -1
+#define MQTT_CONNECTED               0
+
+class PubSubClient;
+
+class MqttBroker {
+public:
+    struct Message {
+        String topic;
+        String payload;
+        bool retained;
+    };
+
+private:
+    bool online;
+    std::vector<Message> log;
+    std::map<std::string, String> retainedMessages;
+    std::vector<PubSubClient*> clients;
+
+    MqttBroker() : online(true) {}
+
+public:
+    static MqttBroker& instance() {
+        static MqttBroker broker;
+        return broker;
+    }
+
+    void setOnline(bool state);
+    bool isOnline() { return online; }
+
+    void attach(PubSubClient* client) { clients.push_back(client); }
+    void detach(PubSubClient* client) {
+        for (size_t i = 0; i < clients.size(); i++) {
+            if (clients[i] == client) {
+                clients.erase(clients.begin() + i);
+                break;
+            }
+        }
+    }
+
+    // From a client, or from the outside world with sender nullptr
+    void publish(const char* topic, const uint8_t* payload, size_t length, bool retained,
+                 PubSubClient* sender = nullptr);
+    void publish(const char* topic, const char* payload) {
+        publish(topic, (const uint8_t*)payload, strlen(payload), false);
+    }
+
+    const std::vector<Message>& getLog() { return log; }
+    void clearLog() { log.clear(); }
+    bool getRetained(const char* topic, String& payload) {
+        auto found = retainedMessages.find(topic);
+        if (found == retainedMessages.end()) return false;
+        payload = found->second;
+        return true;
+    }
+};
+
+class PubSubClient {
+public:
+    typedef std::function<void(char* topic, uint8_t* payload, unsigned int length)> Callback;
+
+private:
+    friend class MqttBroker;
+
+    struct Delivery {
+        String topic;
+        String payload;
+    };
+
+    bool isConnected;
+    int connectionState;
+    uint16_t bufferSize;
+    Callback callback;
+    std::vector<String> subscriptions;
+    std::deque<Delivery> inbox;
+    String willTopic;
+    String willMessage;
+    bool willRetain;
+
+    void drop() {
+        isConnected = false;
+        connectionState = MQTT_CONNECTION_LOST;
+        subscriptions.clear();
+        inbox.clear();
+    }
+
+public:
+    explicit PubSubClient(WiFiClient& client)
+        : isConnected(false), connectionState(MQTT_DISCONNECTED), bufferSize(256), willRetain(false) {
+        (void)client;
+        MqttBroker::instance().attach(this);
+    }
+
+    ~PubSubClient() { MqttBroker::instance().detach(this); }
+
+    PubSubClient& setServer(const char* domain, uint16_t port) {
+        (void)domain;
+        (void)port;
+        return *this;
+    }
+    PubSubClient& setCallback(Callback handler) {
+        callback = handler;
+        return *this;
+    }
+    bool setBufferSize(uint16_t size) {
+        bufferSize = size;
+        return true;
+    }
+    uint16_t getBufferSize() { return bufferSize; }
+    PubSubClient& setSocketTimeout(uint16_t timeout) {
+        (void)timeout;
+        return *this;
+    }
+
+    bool connect(const char* id, const char* user, const char* pass, const char* will = nullptr,
+                 uint8_t willQos = 0, bool retain = false, const char* message = nullptr) {
+        (void)id;
+        (void)user;
+        (void)pass;
+        (void)willQos;
+        if (!MqttBroker::instance().isOnline()) {
+            connectionState = MQTT_CONNECTION_TIMEOUT;
+            return false;
+        }
+        willTopic = will != nullptr ? will : "";
+        willMessage = message != nullptr ? message : "";
+        willRetain = retain;
+        isConnected = true;
+        connectionState = MQTT_CONNECTED;
+        return true;
+    }
+    bool connect(const char* id) { return connect(id, nullptr, nullptr); }
+
+    void disconnect() {
+        isConnected = false;
+        connectionState = MQTT_DISCONNECTED;
+        subscriptions.clear();
+        inbox.clear();
+    }
+
+    bool connected() { return isConnected; }
+    int state() { return connectionState; }
+
+    bool publish(const char* topic, const uint8_t* payload, unsigned int length, bool retained = false) {
+        // The library refuses packets larger than its buffer
+        if (!isConnected || 5 + 2 + strlen(topic) + length > bufferSize) return false;
+        MqttBroker::instance().publish(topic, payload, length, retained, this);
+        return true;
+    }
+    bool publish(const char* topic, const char* payload, bool retained = false) {
+        return publish(topic, (const uint8_t*)payload, strlen(payload), retained);
+    }
+
+    bool subscribe(const char* topic) {
+        if (!isConnected) return false;
+        subscriptions.push_back(String(topic));
+        return true;
+    }
+
+    bool loop() {
+        if (!isConnected) return false;
+        while (!inbox.empty()) {
+            Delivery delivery = inbox.front();
+            inbox.pop_front();
+            if (callback) {
+                std::vector<char> topic(delivery.topic.c_str(), delivery.topic.c_str() + delivery.topic.length() + 1);
+                callback(topic.data(), (uint8_t*)delivery.payload.c_str(), delivery.payload.length());
+            }
+        }
+        return true;
+    }
+};
+
+inline void MqttBroker::setOnline(bool state) {
+    online = state;
+    if (online) return;
+    for (PubSubClient* client : clients) {
+        if (!client->isConnected) continue;
+        if (client->willTopic.length() > 0 && client->willRetain) {
+            retainedMessages[client->willTopic.c_str()] = client->willMessage;
+        }
+        client->drop();
+    }
+}
+
+inline void MqttBroker::publish(const char* topic, const uint8_t* payload, size_t length, bool retained,
+                                PubSubClient* sender) {
+    (void)sender;
+    Message message = {String(topic), String(), retained};
+    message.payload.concat((const char*)payload, length);
+    log.push_back(message);
+    if (retained) {
+        retainedMessages[topic] = message.payload;
+    }
+    for (PubSubClient* client : clients) {
+        if (!client->isConnected) continue;
+        for (const String& subscription : client->subscriptions) {
+            if (subscription == topic) {
+                client->inbox.push_back({message.topic, message.payload});
+                break;
+            }
+        }
+    }
+}
+
+#endif // NATIVE_PUB_SUB_CLIENT_H
@@ -0,0 +1,314 @@
+#ifndef SIM_HAL_H
+#define SIM_HAL_H
+
+#include "../../include/HAL.h"
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Simulated HAL backends for the native build.
+//
+// Time is virtual: nothing advances unless the firmware calls delay() or a
+// host tool calls advance(), so loop() runs as fast as the workstation can
+// execute it while every module still sees consistent millis()/micros().
+
+class SimClock : public HalClock {
+public:
+    typedef std::function<void(uint64_t fromMicros, uint64_t toMicros)> AdvanceListener;
+
+    // Something that happens at a known instant, like a timer alarm or a
+    // mains zero crossing. Advances are split at each event, so listeners
+    // see the outputs change at the exact time.
+    class EventSource {
+    public:
+        virtual ~EventSource() {}
+        virtual bool nextEvent(uint64_t& dueMicros) = 0;
+        virtual void fireEvent() = 0;
+    };
+
+private:
+    std::atomic<uint64_t> nowMicros;    // read from both task threads in --bench=tasks
+    std::vector<AdvanceListener> listeners;
+    std::vector<EventSource*> sources;
+
+    EventSource* nextSource(uint64_t limit, uint64_t& due);
+
+    void advanceTo(uint64_t to);
+
+public:
+    SimClock();
+
+    unsigned long millis() override;
+    unsigned long micros() override;
+    void delay(unsigned long ms) override;
+
+    void advanceMicros(uint64_t us);
+    void advance(unsigned long ms) { advanceMicros((uint64_t)ms * 1000); }
+    uint64_t nowUs() { return nowMicros; }
+    void reset();
+
+    // Called on every advance so plant models can integrate over the exact
+    // interval during which the outputs held their state
+    void addListener(AdvanceListener listener);
+    void clearListeners();
+
+    void addEventSource(EventSource* source);
+    void removeEventSource(EventSource* source);
+};
+
+class SimTimer : public HalTimer, public SimClock::EventSource {
+private:
+    void (*callback)();
+    uint64_t alarm;
+    bool armed;
+    bool firing;
+    unsigned long fired;
+
+public:
+    SimTimer();
+
+    void begin(void (*callback)()) override;
+    uint64_t nowMicros() override;
+    void alarmAt(uint64_t timeUs) override;
+    void cancel() override;
+
+    // Host side
+    bool nextEvent(uint64_t& dueMicros) override;
+    void fireEvent() override;
+    bool isArmed() { return armed; }
+    unsigned long getFiredCount() { return fired; }
+    void reset();
+};
+
+// Zero-cross detector on a mains supply: a short pulse on the input pin at
+// every zero crossing, 2 * frequency per second
+class SimZeroCross : public SimClock::EventSource {
+private:
+    uint8_t pin;
+    uint64_t halfCycle;         // us
+    uint64_t next;
+    bool running;
+
+public:
+    SimZeroCross();
+
+    void start(uint8_t pin, float frequencyHz);     // first crossing half a cycle from now
+    void stop();
+    bool isRunning() { return running; }
+    uint64_t getHalfCycle() { return halfCycle; }
+
+    bool nextEvent(uint64_t& dueMicros) override;
+    void fireEvent() override;
+};
+
+class SimGpio : public HalGpio {
+public:
+    static const int PIN_COUNT = 40;
+
+private:
+    uint8_t modes[PIN_COUNT];
+    uint8_t levels[PIN_COUNT];
+    void (*handlers[PIN_COUNT])();
+    int interruptModes[PIN_COUNT];
+    unsigned long writeCount[PIN_COUNT];
+
+public:
+    SimGpio();
+
+    void pinMode(uint8_t pin, uint8_t mode) override;
+    void digitalWrite(uint8_t pin, uint8_t value) override;
+    int digitalRead(uint8_t pin) override;
+    void attachInterrupt(uint8_t pin, void (*handler)(), int mode) override;
+    void detachInterrupt(uint8_t pin) override;
+
+    // Host side: drive an input pin, firing any attached interrupt
+    void setInput(uint8_t pin, uint8_t level);
+    uint8_t getLevel(uint8_t pin);
+    uint8_t getMode(uint8_t pin);
+    unsigned long getWriteCount(uint8_t pin);
+    void reset();
+};
+
+class SimOneWire : public HalOneWire {
+public:
+    typedef std::function<float(void)> TemperatureSource;
+
+    struct Device {
+        OneWireAddress address;
+        uint8_t resolution;
+        bool connected;
+        float temperature;          // used when no source is attached
+        TemperatureSource source;
+        float latched;              // scratchpad contents
+        float pending;              // conversion in progress
+        unsigned long conversionStart;
+        bool converting;
+    };
+
+private:
+    std::vector<Device> devices;
+    uint8_t busPin;
+    bool waitForConversion;
+    bool chargeBusTime;
+    unsigned long transactions;
+    uint64_t busMicros;
+
+    Device* find(const OneWireAddress address);
+    void completeConversions(unsigned long now);
+    void startConversion(Device& device, unsigned long now);
+    void transaction(int bytes);
+
+public:
+    SimOneWire();
+
+    void begin(uint8_t pin) override;
+    int getDeviceCount() override;
+    bool getAddress(OneWireAddress address, int index) override;
+    bool isConnected(const OneWireAddress address) override;
+    void setResolution(const OneWireAddress address, uint8_t bits) override;
+    uint8_t getResolution(const OneWireAddress address) override;
+    void setWaitForConversion(bool wait) override;
+    void requestTemperatures() override;
+    bool requestTemperature(const OneWireAddress address) override;
+    float getTempC(const OneWireAddress address) override;
+
+    // Host side. With bus time charging enabled every transaction advances
+    // the SimClock by its standard-speed duration (reset plus 70 us slots).
+    int addDevice(float initialTemperature);
+    void setTemperature(int index, float temperature);
+    void setSource(int index, TemperatureSource source);
+    void setConnected(int index, bool connected);
+    Device& getDevice(int index) { return devices[index]; }
+    void clearDevices();
+    void setChargeBusTime(bool charge) { chargeBusTime = charge; }
+    unsigned long getTransactions() { return transactions; }
+    uint64_t getBusMicros() { return busMicros; }
+    void resetCounters();
+
+    static unsigned long conversionTime(uint8_t resolution);
+    static float quantize(float temperature, uint8_t resolution);
+};
+
+class SimI2C : public HalI2C {
+private:
+    uint32_t frequency;
+    bool chargeBusTime;
+    unsigned long transactions;
+    unsigned long bytesWritten;
+    std::map<uint8_t, bool> presentDevices;
+
+public:
+    SimI2C();
+
+    bool begin(int sda, int scl) override;
+    void setClock(uint32_t frequency) override;
+    uint8_t write(uint8_t address, const uint8_t* data, size_t length) override;
+    size_t read(uint8_t address, uint8_t* data, size_t length) override;
+
+    // Host side. With bus time charging enabled every transfer advances the
+    // SimClock by its on-the-wire duration (9 clocks per byte plus address).
+    void addDevice(uint8_t address) { presentDevices[address] = true; }
+    void setChargeBusTime(bool charge) { chargeBusTime = charge; }
+    unsigned long getTransactions() { return transactions; }
+    unsigned long getBytesWritten() { return bytesWritten; }
+    void resetCounters();
+};
+
+// In-memory SPIFFS with a flash cost model for a W25Q32-class chip: file
+// data reaches flash a 256-byte page at a time, flush() also programs the
+// partly filled page and the file's index page, and every 16 pages
+// programmed cost one 4 KB sector erase for garbage collection. With flash
+// time charging enabled the SimClock advances by the program and erase
+// times, so the caller sees the stall.
+class SimFileSystem : public HalFileSystem {
+public:
+    typedef std::vector<uint8_t> Blob;
+
+private:
+    std::map<std::string, std::shared_ptr<Blob>> files;
+    size_t capacity;
+    bool mounted;
+
+    bool chargeFlashTime;
+    unsigned long pagesProgrammed;
+    unsigned long sectorsErased;
+    unsigned long pagesSinceErase;
+    uint64_t flashMicros;
+
+public:
+    SimFileSystem();
+
+    bool begin(bool formatOnFail) override;
+    HalFile* open(const char* path, const char* mode) override;
+    bool exists(const char* path) override;
+    bool remove(const char* path) override;
+    void listFiles(std::function<void(const char* path, size_t size)> callback) override;
+    size_t usedBytes() override;
+    size_t totalBytes() override;
+
+    // Host side
+    void setCapacity(size_t bytes) { capacity = bytes; }
+    const Blob* getContents(const char* path);
+    void format();
+
+    // Called by open files as their data reaches flash
+    void program(unsigned long pages);
+    void setChargeFlashTime(bool charge) { chargeFlashTime = charge; }
+    unsigned long getPagesProgrammed() { return pagesProgrammed; }
+    unsigned long getSectorsErased() { return sectorsErased; }
+    uint64_t getFlashMicros() { return flashMicros; }
+    void resetCounters();
+};
+
+// Loopback stand-in for AsyncTCP. After enableLoopback(), begin() opens a
+// real listening socket on 127.0.0.1 at an ephemeral port (getPort()) and a
+// poll() thread delivers the listener callbacks, as the ESP32 network task
+// would; clients are ordinary sockets. Without it begin() only records the
+// listener and nothing connects, so runs stay self-contained.
+class SimTcpServer : public HalTcpServer {
+private:
+    bool loopback;
+    std::atomic<bool> running;
+    int listenFd;
+    uint16_t port;
+    Listener* listener;
+    void* thread;                       // std::thread*
+    int fds[HTTP_MAX_CONNECTIONS];
+    bool wantWrite[HTTP_MAX_CONNECTIONS];
+    uint64_t lastActivity[HTTP_MAX_CONNECTIONS];    // ms, steady clock
+
+    void run();
+    void drop(int connection);
+
+public:
+    SimTcpServer();
+    ~SimTcpServer();
+
+    bool begin(uint16_t port, Listener* listener) override;
+    size_t write(int connection, const uint8_t* data, size_t length) override;
+    void close(int connection) override;
+
+    // Host side
+    void enableLoopback(bool enable) { loopback = enable; }
+    uint16_t getPort() { return port; }
+    void end();
+};
+
+// Access to the concrete simulated backends behind HAL::clock() etc.
+class SimHal {
+public:
+    static SimClock& clock();
+    static SimGpio& gpio();
+    static SimOneWire& oneWire();
+    static SimI2C& i2c();
+    static SimFileSystem& fs();
+    static SimTimer& timer();
+    static SimZeroCross& zeroCross();
+    static SimTcpServer& tcpServer();
+    static void reset();
+};
+
+#endif // SIM_HAL_H
@@ -0,0 +1,85 @@
+#ifndef WATER_BATH_H
+#define WATER_BATH_H
+
+#include "SimHal.h"
+
+// Lumped thermal model of a sous vide water bath for the native build.
+//
+// The bath integrates on every SimClock advance using the SSR pin level the
+// firmware left on SimGpio, and feeds the DS18B20 on SimOneWire through a
+// first-order probe lag. Quantization to the configured resolution happens
+// in SimOneWire, so TemperatureSensor sees exactly what the real part reports.
+//
+// Optionally the heater is its own thermal mass coupled to the water, read
+// by a heater outlet probe, and a food core follows the water through its
+// own time constant for a core probe.
+class WaterBath {
+public:
+    struct Parameters {
+        float heaterWatts;          // SSR load
+        float waterLiters;
+        float vesselHeatCapacity;   // J/K of pot, lid and immersed hardware
+        float lossCoefficient;      // W/K to ambient
+        float ambientTemp;          // °C
+        float initialTemp;          // °C
+        float probeTimeConstant;    // s, stainless DS18B20 probe in stirred water
+        uint8_t ssrPin;
+        int sensorIndex;            // SimOneWire device fed by this bath
+        
+        float heaterHeatCapacity;   // J/K of element and housing, 0 heats the water directly
+        float heaterTransfer;       // W/K from heater to water
+        float outletTimeConstant;   // s, outlet probe lag
+        int outletSensorIndex;      // -1 without an outlet probe
+        float coreTimeConstant;     // s, food core lag behind the water
+        float coreInitialTemp;      // °C, e.g. straight from the fridge
+        int coreSensorIndex;        // -1 without a core probe
+    };
+
+private:
+    Parameters params;
+    float waterTemp;
+    float probeTemp;
+    float heaterTemp;
+    float outletProbeTemp;
+    float coreTemp;
+    float heaterScale;
+    double heaterOnSeconds;
+    double elapsedSeconds;
+    double energyJoules;
+    bool attached;
+
+    float heatCapacity();
+
+public:
+    WaterBath();
+    explicit WaterBath(const Parameters& parameters);
+
+    static Parameters defaultParameters();
+
+    // Hook into SimClock and SimOneWire
+    void attach();
+
+    // Advance the model by dt seconds with the heater held on or off
+    void step(double dt, bool heaterOn);
+
+    float getWaterTemperature() { return waterTemp; }
+    float getProbeTemperature() { return probeTemp; }
+    float getHeaterTemperature() { return heaterTemp; }
+    float getCoreTemperature() { return coreTemp; }
+    double getHeaterOnSeconds() { return heaterOnSeconds; }
+    double getElapsedSeconds() { return elapsedSeconds; }
+    double getEnergyJoules() { return energyJoules; }
+    float getDutyCycle();
+
+    // Steady-state heater duty needed to hold a temperature
+    float holdingDuty(float temperature);
+
+    void setAmbientTemperature(float temperature) { params.ambientTemp = temperature; }
+    // Fraction of rated heater power delivered, e.g. 0.85 for a mains sag
+    void setHeaterScale(float scale) { heaterScale = scale; }
+    void setWaterTemperature(float temperature) { waterTemp = temperature; }
+    void setProbeTemperature(float temperature) { probeTemp = temperature; }
+    const Parameters& getParameters() { return params; }
+};
+
+#endif // WATER_BATH_H
@@ -0,0 +1,141 @@
+#ifndef NATIVE_WEBSOCKETS_SERVER_H
+#define NATIVE_WEBSOCKETS_SERVER_H
+
+#include <Arduino.h>
+#include <functional>
+#include <deque>
+#include <vector>
+
+// WebSocketsServer (links2004/arduinoWebSockets) stand-in. There is no
+// socket: clients connect, send and leave by queueing events with
+// connect()/send()/disconnect(), and loop() delivers them where the library
+// would. Outgoing frames are counted per client.
+// Servers register by port, so a benchmark can reach the one the firmware
+// created with onPort(WEBSOCKET_PORT).
+
+#ifndef WEBSOCKETS_SERVER_CLIENT_MAX
+#define WEBSOCKETS_SERVER_CLIENT_MAX 8
+#endif
+
+typedef enum {
+    WStype_ERROR,
+    WStype_DISCONNECTED,
+    WStype_CONNECTED,
+    WStype_TEXT,
+    WStype_BIN
+} WStype_t;
+
+class WebSocketsServer {
+public:
+    typedef std::function<void(uint8_t num, WStype_t type, uint8_t* payload, size_t length)> WebSocketServerEvent;
+
+    struct ClientStats {
+        unsigned long frames;
+        unsigned long bytes;
+        String lastFrame;
+    };
+
+private:
+    struct Event {
+        uint8_t num;
+        WStype_t type;
+        String payload;
+    };
+
+    uint16_t port;
+    bool started;
+    WebSocketServerEvent callback;
+    std::deque<Event> pending;
+    bool connected[WEBSOCKETS_SERVER_CLIENT_MAX];
+    ClientStats stats[WEBSOCKETS_SERVER_CLIENT_MAX];
+    unsigned long broadcasts;
+
+    static std::vector<WebSocketsServer*>& registry() {
+        static std::vector<WebSocketsServer*> servers;
+        return servers;
+    }
+
+    void deliver(uint8_t num, const char* payload, size_t length) {
+        stats[num].frames++;
+        stats[num].bytes += length;
+        stats[num].lastFrame = String();
+        stats[num].lastFrame.concat(payload, length);
+    }
+
+public:
+    explicit WebSocketsServer(uint16_t port) : port(port), started(false), broadcasts(0) {
+        for (int i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
+            connected[i] = false;
+            stats[i] = ClientStats{0, 0, String()};
+        }
+        registry().push_back(this);
+    }
+
+    ~WebSocketsServer() {
+        std::vector<WebSocketsServer*>& servers = registry();
+        for (size_t i = 0; i < servers.size(); i++) {
+            if (servers[i] == this) {
+                servers.erase(servers.begin() + i);
+                break;
+            }
+        }
+    }
+
+    void begin() { started = true; }
+    void close() { started = false; }
+    void onEvent(WebSocketServerEvent handler) { callback = handler; }
+
+    void loop() {
+        while (started && !pending.empty()) {
+            Event event = pending.front();
+            pending.pop_front();
+            if (event.type == WStype_CONNECTED) connected[event.num] = true;
+            if (event.type == WStype_DISCONNECTED) connected[event.num] = false;
+            if (callback) {
+                callback(event.num, event.type, (uint8_t*)event.payload.c_str(), event.payload.length());
+            }
+        }
+    }
+
+    bool sendTXT(uint8_t num, const char* payload, size_t length = 0) {
+        if (num >= WEBSOCKETS_SERVER_CLIENT_MAX || !connected[num]) return false;
+        deliver(num, payload, length ? length : strlen(payload));
+        return true;
+    }
+
+    bool broadcastTXT(const char* payload, size_t length = 0) {
+        if (length == 0) length = strlen(payload);
+        broadcasts++;
+        for (uint8_t num = 0; num < WEBSOCKETS_SERVER_CLIENT_MAX; num++) {
+            if (connected[num]) deliver(num, payload, length);
+        }
+        return true;
+    }
+
+    uint8_t connectedClients(bool ping = false) {
+        (void)ping;
+        uint8_t count = 0;
+        for (int i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
+            if (connected[i]) count++;
+        }
+        return count;
+    }
+
+    // Native-only: client traffic, delivered by the next loop()
+    void connect(uint8_t num) { pending.push_back({num, WStype_CONNECTED, String("/")}); }
+    void disconnect(uint8_t num) { pending.push_back({num, WStype_DISCONNECTED, String()}); }
+    void send(uint8_t num, const String& text) { pending.push_back({num, WStype_TEXT, text}); }
+
+    const ClientStats& getClientStats(uint8_t num) { return stats[num]; }
+    unsigned long getBroadcasts() { return broadcasts; }
+    uint16_t getPort() { return port; }
+
+    static WebSocketsServer* onPort(uint16_t port) {
+        for (WebSocketsServer* server : registry()) {
+            if (server->port == port) return server;
+        }
+        return nullptr;
+    }
+};
+
+#endif // NATIVE_WEBSOCKETS_SERVER_H
@@ -0,0 +1,62 @@
+#ifndef NATIVE_WIFI_H
+#define NATIVE_WIFI_H
+
+#include <Arduino.h>
+
+// Station-mode WiFi stand-in: the native build is always "connected" on
+// the loopback address.
+
+typedef enum {
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+class IPAddress {
+private:
+    uint8_t octets[4];
+
+public:
+    IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) {
+        octets[0] = a;
+        octets[1] = b;
+        octets[2] = c;
+        octets[3] = d;
+    }
+
+    String toString() const {
+        char text[16];
+        snprintf(text, sizeof(text), "%u.%u.%u.%u", octets[0], octets[1], octets[2], octets[3]);
+        return String(text);
+    }
+};
+
+class WiFiClass {
+private:
+    wl_status_t currentStatus;
+
+public:
+    WiFiClass() : currentStatus(WL_IDLE_STATUS) {}
+
+    wl_status_t begin(const char* ssid, const char* password) {
+        (void)ssid;
+        (void)password;
+        currentStatus = WL_CONNECTED;
+        return currentStatus;
+    }
+
+    void disconnect() { currentStatus = WL_DISCONNECTED; }
+    wl_status_t status() { return currentStatus; }
+    IPAddress localIP() { return IPAddress(127, 0, 0, 1); }
+};
+
+// TCP client handle for libraries that take a Client&; the native
+// stand-ins that use it never open a socket
+class WiFiClient {
+};
+
+extern WiFiClass WiFi;
+
+#endif // NATIVE_WIFI_H
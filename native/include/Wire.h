@@ -0,0 +1,37 @@
+#ifndef NATIVE_WIRE_H
+#define NATIVE_WIRE_H
+
+#include <Arduino.h>
+
+// TwoWire stand-in that forwards every transaction to HAL::i2c(), so
+// libraries written against Wire end up on the simulated I2C backend.
+class TwoWire {
+private:
+    static const size_t BUFFER_LENGTH = 128;
+
+    uint8_t txAddress;
+    uint8_t txBuffer[BUFFER_LENGTH];
+    size_t txLength;
+    uint8_t rxBuffer[BUFFER_LENGTH];
+    size_t rxLength;
+    size_t rxIndex;
+
+public:
+    TwoWire();
+
+    bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0);
+    void setClock(uint32_t frequency);
+
+    void beginTransmission(uint8_t address);
+    size_t write(uint8_t data);
+    size_t write(const uint8_t* data, size_t length);
+    uint8_t endTransmission(bool sendStop = true);
+
+    size_t requestFrom(uint8_t address, size_t length, bool sendStop = true);
+    int available();
+    int read();
+};
+
+extern TwoWire Wire;
+
+#endif // NATIVE_WIRE_H
@@ -0,0 +1,89 @@
+#include "../include/Benchmarks.h"
+#include <arpa/inet.h>
+#include <atomic>
+#include <malloc.h>
+#include <netinet/in.h>
+#include <new>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static std::atomic<unsigned long> allocations(0);
+static std::atomic<size_t> liveBytes(0);
+static std::atomic<size_t> peakBytes(0);
+
+void* operator new(size_t size) {
+    void* block = malloc(size != 0 ? size : 1);
+    if (block == nullptr) throw std::bad_alloc();
+    allocations++;
+    size_t live = liveBytes += malloc_usable_size(block);
+    size_t peak = peakBytes.load();
+    while (live > peak && !peakBytes.compare_exchange_weak(peak, live)) {}
+    return block;
+}
+
+void operator delete(void* block) noexcept {
+    if (block == nullptr) return;
+    liveBytes -= malloc_usable_size(block);
+    free(block);
+}
+
+void operator delete(void* block, size_t) noexcept {
+    operator delete(block);
+}
+
+unsigned long heapAllocations() { return allocations; }
+size_t heapLiveBytes() { return liveBytes; }
+size_t heapPeakBytes() { return peakBytes; }
+void heapResetPeak() { peakBytes = liveBytes.load(); }
+
+int connectLoopback(uint16_t port, int timeoutSeconds) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    timeval timeout = {timeoutSeconds, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    if (connect(fd, (sockaddr*)&address, sizeof(address)) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+struct BenchmarkEntry {
+    const char* name;
+    int (*run)();
+};
+
+static const BenchmarkEntry BENCHMARKS[] = {
+    {"pid", benchmarkPid},
+    {"onewire", benchmarkOneWire},
+    {"tasks", benchmarkTasks},
+    {"ssr", benchmarkSsr},
+    {"sigma-delta", benchmarkSigmaDelta},
+    {"push", benchmarkPush},
+    {"http", benchmarkHttp},
+    {"status", benchmarkStatus},
+    {"mqtt", benchmarkMqtt},
+    {"log", benchmarkLog},
+    {"flash", benchmarkFlash},
+    {"logs", benchmarkLogs},
+    {"history", benchmarkHistory},
+    {"logpolicy", benchmarkLogPolicy},
+};
+
+int runBenchmark(const char* name) {
+    for (const BenchmarkEntry& entry : BENCHMARKS) {
+        if (strcmp(entry.name, name) == 0) {
+            return entry.run();
+        }
+    }
+
+    fprintf(stderr, "unknown benchmark: %s (available:", name);
+    for (const BenchmarkEntry& entry : BENCHMARKS) {
+        fprintf(stderr, " %s", entry.name);
+    }
+    fprintf(stderr, ")\n");
+    return 2;
+}
@@ -0,0 +1,54 @@
+#include "../include/CookMetrics.h"
+
+CookMetrics::CookMetrics(float band) {
+    settleBand = band;
+    begin(0, 0);
+}
+
+void CookMetrics::begin(float targetTemp, double now) {
+    target = targetTemp;
+    startTime = now;
+    reachedTime = now;
+    lastOutsideBand = now;
+    maxTemp = -1000;
+    minAfterReach = 1000;
+    sumSquaredError = 0;
+    errorSamples = 0;
+    reached = false;
+}
+
+void CookMetrics::sample(float waterTemp, double now) {
+    float error = waterTemp - target;
+
+    if (!reached && error >= 0) {
+        reached = true;
+        reachedTime = now;
+    }
+
+    if (fabs(error) > settleBand) {
+        lastOutsideBand = now;
+    }
+
+    if (reached) {
+        if (waterTemp > maxTemp) maxTemp = waterTemp;
+        if (waterTemp < minAfterReach) minAfterReach = waterTemp;
+        sumSquaredError += error * error;
+        errorSamples++;
+    }
+}
+
+float CookMetrics::getRmsError() {
+    return errorSamples > 0 ? (float)sqrt(sumSquaredError / errorSamples) : 0;
+}
+
+void CookMetrics::print() {
+    if (!reached) {
+        printf("setpoint          : not reached\n");
+        return;
+    }
+    printf("time to setpoint  : %.0f s\n", getTimeToSetpoint());
+    printf("overshoot         : %.3f C\n", getOvershoot());
+    printf("undershoot        : %.3f C\n", getUndershoot());
+    printf("settling (+-%.1fC) : %.0f s\n", settleBand, getSettlingTime());
+    printf("rms error         : %.3f C\n", getRmsError());
+}
@@ -0,0 +1,205 @@
+// Latency of DataLogger::logData() when SPIFFS stalls the caller for every
+// page it programs: the previous logger, which wrote and flushed each entry
+// from logData(), against the staging ring committed by the log task.
+//
+// SimFileSystem charges W25Q32 page program and sector erase times to the
+// SimClock, so the virtual time a call takes is the stall loop() would see.
+// Six hours of binary logging at DATA_LOG_INTERVAL, with commit() run every
+// LOG_TASK_PERIOD as the log task would. Every 10 s the power is "cut": the
+// file as it stands is decoded, and the age of the newest sample that
+// survived is the data a power failure at that moment would have lost.
+
+#include "../include/Benchmarks.h"
+#include "../include/SimHal.h"
+#include "../../include/DataLogger.h"
+#include <algorithm>
+#include <vector>
+
+static const unsigned long RUN_SECONDS = 6 * 3600UL;
+static const unsigned long CUT_EVERY = 10;          // seconds between power cuts
+
+// The logData() of the previous DataLogger: encode, write, flush per entry
+class DirectLogger {
+private:
+    HalFile* file;
+    LogEncoder encoder;
+    unsigned long startTime;
+
+public:
+    DirectLogger() : file(nullptr), startTime(0) {}
+
+    void begin(const char* path) {
+        file = HAL::fs().open(path, "w");
+        startTime = HAL::clock().millis();
+        uint8_t header[LOG_HEADER_SIZE];
+        file->write(header, encoder.begin(header, startTime));
+        file->flush();
+    }
+
+    void logData(float temp, float target, float power, unsigned long remaining) {
+        LogEntry entry = {HAL::clock().millis() - startTime, temp, target, power, remaining};
+        encoder.add(entry);
+        file->write(encoder.data(), encoder.available());
+        encoder.consume();
+        file->flush();
+    }
+
+    void end() {
+        encoder.finish();
+        file->write(encoder.data(), encoder.available());
+        file->close();
+        delete file;
+    }
+};
+
+struct RunResult {
+    std::vector<uint64_t> callMicros;       // logData(), flash time included
+    std::vector<uint64_t> commitMicros;     // commit() calls that wrote
+    unsigned long pages;
+    unsigned long erases;
+    unsigned long maxLossMs;
+    unsigned long samples;
+    unsigned long decoded;
+    double hostNs;
+};
+
+// Samples in a log as it stands in flash, and the time of the newest one
+static unsigned long decodeFile(const char* path, unsigned long& newest, bool& complete) {
+    newest = 0;
+    complete = false;
+    const SimFileSystem::Blob* log = SimHal::fs().getContents(path);
+    if (log == nullptr) return 0;
+    size_t offset = 0;
+    LogDecoder decoder([&](uint8_t* buffer, size_t size) {
+        size_t count = min(size, log->size() - offset);
+        memcpy(buffer, log->data() + offset, count);
+        offset += count;
+        return (int)count;
+    });
+
+    unsigned long count = 0;
+    if (!decoder.begin()) return 0;
+    newest = decoder.getHeader().startTime;
+    LogEntry entry;
+    while (decoder.next(entry)) {
+        newest = decoder.getHeader().startTime + entry.timestamp;
+        count++;
+    }
+    complete = decoder.isComplete();
+    return count;
+}
+
+// A steady cook: DS18B20 steps around the target, power wandering
+static void sample(unsigned long i, float& temp, float& power) {
+    temp = 56.0f + 0.0625f * (float)((i * 7919 / 13) % 5) - 0.125f;
+    power = 14.0f + 4.0f * sinf(i / 97.0f) + 0.1f * (float)(i % 7);
+}
+
+template <typename Log, typename Commit>
+static RunResult run(const char* path, Log log, Commit commit) {
+    RunResult result = {};
+    SimHal::fs().resetCounters();
+    unsigned long start = HAL::clock().millis();
+    double hostNs = 0;
+
+    for (unsigned long i = 0; i < RUN_SECONDS * 1000 / DATA_LOG_INTERVAL; i++) {
+        // Commits on the log task's grid until the next sample is due
+        unsigned long due = start + i * DATA_LOG_INTERVAL;
+        while (HAL::clock().millis() < due) {
+            uint64_t before = SimHal::clock().nowUs();
+            unsigned long pages = SimHal::fs().getPagesProgrammed();
+            commit();
+            if (SimHal::fs().getPagesProgrammed() != pages) {
+                result.commitMicros.push_back(SimHal::clock().nowUs() - before);
+            }
+            unsigned long next = HAL::clock().millis() + LOG_TASK_PERIOD;
+            SimHal::clock().advance(min(next, due) - HAL::clock().millis());
+        }
+
+        float temp, power;
+        sample(i, temp, power);
+        uint64_t before = SimHal::clock().nowUs();
+        auto wallStart = std::chrono::steady_clock::now();
+        log(temp, 56.0f, power, RUN_SECONDS - i * DATA_LOG_INTERVAL / 1000);
+        hostNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - wallStart).count();
+        result.callMicros.push_back(SimHal::clock().nowUs() - before);
+        result.samples++;
+
+        // A binary record is durable only once the next one completes its
+        // last byte, so the bound is LOG_COMMIT_INTERVAL plus the log task
+        // period and two samples
+        if (i > 0 && i % (CUT_EVERY * 1000 / DATA_LOG_INTERVAL) == 0) {
+            unsigned long newest;
+            bool complete;
+            decodeFile(path, newest, complete);
+            result.maxLossMs = max(result.maxLossMs, HAL::clock().millis() - newest);
+        }
+    }
+
+    result.pages = SimHal::fs().getPagesProgrammed();
+    result.erases = SimHal::fs().getSectorsErased();
+    result.hostNs = hostNs / result.samples;
+    std::sort(result.callMicros.begin(), result.callMicros.end());
+    std::sort(result.commitMicros.begin(), result.commitMicros.end());
+    return result;
+}
+
+static void print(const char* name, const RunResult& result) {
+    const std::vector<uint64_t>& calls = result.callMicros;
+    size_t n = calls.size();
+    double hours = RUN_SECONDS / 3600.0;
+    printf("%-9s logData()  : p50 %6.2f ms, p99 %6.2f ms, max %6.2f ms (host CPU %.0f ns)\n", name,
+           calls[n / 2] / 1000.0, calls[n * 99 / 100] / 1000.0, calls[n - 1] / 1000.0, result.hostNs);
+    if (!result.commitMicros.empty()) {
+        const std::vector<uint64_t>& commits = result.commitMicros;
+        printf("%-9s log task   : %u commits, p50 %.2f ms, max %.2f ms\n", name, (unsigned)commits.size(),
+               commits[commits.size() / 2] / 1000.0, commits.back() / 1000.0);
+    }
+    printf("%-9s flash wear : %.0f pages programmed and %.0f sectors erased per hour\n", name,
+           result.pages / hours, result.erases / hours);
+    printf("%-9s power cut  : at most %.1f s of samples lost; %lu of %lu samples in the file\n", name,
+           result.maxLossMs / 1000.0, result.decoded, result.samples);
+}
+
+int benchmarkFlash() {
+    Serial.mute(true);
+    SimHal::fs().begin(true);
+    SimHal::fs().setChargeFlashTime(true);
+
+    DirectLogger direct;
+    String directPath = "/log_direct.bin";
+    direct.begin(directPath.c_str());
+    RunResult before = run(directPath.c_str(),
+        [&](float t, float target, float p, unsigned long r) { direct.logData(t, target, p, r); },
+        [] {});
+    direct.end();
+    unsigned long newest;
+    bool directComplete;
+    before.decoded = decodeFile(directPath.c_str(), newest, directComplete);
+
+    DataLogger logger;
+    logger.setBinary(true);
+    logger.begin();
+    String stagedPath = logger.getCurrentLogFileName();
+    RunResult after = run(stagedPath.c_str(),
+        [&](float t, float target, float p, unsigned long r) { logger.logData(t, target, p, r); },
+        [&] { logger.commit(); });
+    logger.endSession();
+    logger.commit();
+    bool stagedComplete;
+    after.decoded = decodeFile(stagedPath.c_str(), newest, stagedComplete);
+
+    printf("run                  : %lu h of binary logging at %d ms per sample\n",
+           RUN_SECONDS / 3600, DATA_LOG_INTERVAL);
+    print("per-entry", before);
+    print("staged", after);
+    printf("staged config        : %d byte ring, %d byte pages, %d ms commit interval, %lu dropped\n",
+           LOG_STAGING_SIZE, LOG_PAGE_SIZE, LOG_COMMIT_INTERVAL, logger.getDroppedEntries());
+
+    bool ok = directComplete && stagedComplete && before.decoded == before.samples &&
+              after.decoded == after.samples && logger.getDroppedEntries() == 0 &&
+              after.maxLossMs <= LOG_COMMIT_INTERVAL + LOG_TASK_PERIOD + 2 * DATA_LOG_INTERVAL;
+    printf("check                : %s\n", ok ? "both logs complete, loss within LOG_COMMIT_INTERVAL" : "FAILED");
+    return ok ? 0 : 1;
+}
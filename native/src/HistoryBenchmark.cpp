@@ -0,0 +1,252 @@
+// Cost of a dashboard chart query, "the last two hours at 300 points",
+// against cooks of growing length: LogHistory seeking with the session's
+// .idx, against decoding from the header as without one, against fetching
+// the whole log as a client had to before.
+//
+// DataLogger writes each session, index included, with SimClock advancing
+// a sample at a time. The cook preheats, holds with sensor noise and has
+// the lid opened every three hours. Every query is checked against a plain
+// buffered LTTB over the decoded samples with the same buckets: the
+// streaming one must keep exactly the same points.
+
+#include "../include/Benchmarks.h"
+#include "../include/SimHal.h"
+#include "../../include/DataLogger.h"
+#include "../../include/LogHistory.h"
+#include <vector>
+
+static const unsigned long COOK_HOURS[] = {6, 24, 48};
+static const unsigned long QUERY_SECONDS = 2 * 3600UL;
+static const int QUERY_POINTS = 300;
+
+static void sample(unsigned long i, float& temp, float& power) {
+    float seconds = i * DATA_LOG_INTERVAL / 1000.0f;
+    float hold = 56.0f + 0.0625f * (float)((i * 7919 / 13) % 5) - 0.125f;
+    temp = seconds < 1800 ? 20.0f + (hold - 20.0f) * seconds / 1800 : hold;
+    power = seconds < 1800 ? 100.0f : 14.0f + 4.0f * sinf(i / 97.0f);
+    // Lid open for two minutes every three hours, then recovery
+    float sinceLid = fmodf(seconds, 3 * 3600.0f);
+    if (seconds > 3600 && sinceLid < 120) {
+        temp -= 3.0f * sinceLid / 120;
+    } else if (seconds > 3600 && sinceLid < 600) {
+        temp -= 3.0f * (600 - sinceLid) / 480;
+        power = 100.0f;
+    }
+}
+
+static String writeCook(unsigned long hours) {
+    DataLogger logger;
+    logger.setBinary(true);
+    logger.begin();
+    String path = logger.getCurrentLogFileName();
+    for (unsigned long i = 0; i < hours * 3600 * 1000 / DATA_LOG_INTERVAL; i++) {
+        float temp, power;
+        sample(i, temp, power);
+        logger.logData(temp, 56.0f, power, hours * 3600 - i * DATA_LOG_INTERVAL / 1000);
+        logger.commit();
+        SimHal::clock().advance(DATA_LOG_INTERVAL);
+    }
+    logger.endSession();
+    logger.commit();
+    return path;
+}
+
+// Every sample of a log, decoded from the header
+static std::vector<LogEntry> decodeAll(const char* path) {
+    const SimFileSystem::Blob* log = SimHal::fs().getContents(path);
+    size_t offset = 0;
+    LogDecoder decoder([&](uint8_t* buffer, size_t size) {
+        size_t count = min(size, log->size() - offset);
+        memcpy(buffer, log->data() + offset, count);
+        offset += count;
+        return (int)count;
+    });
+    std::vector<LogEntry> entries;
+    LogEntry entry;
+    if (!decoder.begin()) return entries;
+    while (decoder.next(entry)) entries.push_back(entry);
+    return entries;
+}
+
+// LogHistory's time bucket of a sample
+static int bucketOf(unsigned long time, unsigned long first, unsigned long to, int buckets) {
+    if (time <= first || to == first) return 0;
+    return (int)((uint64_t)(time - first - 1) * buckets / (to - first));
+}
+
+// Textbook LTTB over samples in memory, with LogHistory's time buckets
+static std::vector<unsigned long> reference(const std::vector<LogEntry>& all, unsigned long from,
+                                            unsigned long to, int points) {
+    std::vector<LogEntry> range;
+    for (const LogEntry& entry : all) {
+        if (entry.timestamp >= from && entry.timestamp <= to) range.push_back(entry);
+    }
+    std::vector<unsigned long> kept;
+    if (range.empty()) return kept;
+    const LogEntry& first = range.front();
+    kept.push_back(first.timestamp);
+    if (range.size() == 1) return kept;
+
+    int buckets = points - 2;
+    std::vector<std::vector<LogEntry>> groups;
+    for (size_t i = 1; i + 1 < range.size(); i++) {
+        int bucket = bucketOf(range[i].timestamp, first.timestamp, to, buckets);
+        if (groups.empty() || bucket != bucketOf(groups.back()[0].timestamp, first.timestamp, to, buckets)) {
+            groups.push_back(std::vector<LogEntry>());
+        }
+        groups.back().push_back(range[i]);
+    }
+
+    LogEntry a = first;
+    for (size_t g = 0; g < groups.size(); g++) {
+        float cTime, cTemp;
+        if (g + 1 < groups.size()) {
+            uint64_t timeSum = 0;
+            float tempSum = 0;
+            for (const LogEntry& entry : groups[g + 1]) {
+                timeSum += entry.timestamp - first.timestamp;
+                tempSum += entry.temperature;
+            }
+            cTime = (float)timeSum / groups[g + 1].size() / 1000.0f;
+            cTemp = tempSum / groups[g + 1].size();
+        } else {
+            cTime = (range.back().timestamp - first.timestamp) / 1000.0f;
+            cTemp = range.back().temperature;
+        }
+        float aTime = (a.timestamp - first.timestamp) / 1000.0f;
+        float best = -1;
+        LogEntry chosen = groups[g][0];
+        for (const LogEntry& b : groups[g]) {
+            float bTime = (b.timestamp - first.timestamp) / 1000.0f;
+            float area = fabsf((aTime - cTime) * (b.temperature - a.temperature) -
+                               (aTime - bTime) * (cTemp - a.temperature));
+            if (area > best) {
+                best = area;
+                chosen = b;
+            }
+        }
+        kept.push_back(chosen.timestamp);
+        a = chosen;
+    }
+    kept.push_back(range.back().timestamp);
+    return kept;
+}
+
+struct QueryResult {
+    std::vector<unsigned long> kept;
+    unsigned long decoded;
+    size_t jsonBytes;
+    double microseconds;
+    float lowest;
+};
+
+static QueryResult run(const char* path, unsigned long from, unsigned long to, int points) {
+    QueryResult result = {{}, 0, 0, 0, 1000.0f};
+    auto start = std::chrono::steady_clock::now();
+    LogHistory history;
+    history.open(path);
+    history.query(from, to, points);
+    LogEntry entry;
+    char text[64];
+    while (history.next(entry)) {
+        result.kept.push_back(entry.timestamp);
+        result.jsonBytes += LogHistory::formatJSON(entry, text, sizeof(text)) + 1;
+        if (entry.timestamp > 3600000) result.lowest = min(result.lowest, entry.temperature);
+    }
+    result.microseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count() / 1000.0;
+    // query() on; decodedByOpen() counts the tail open() decodes
+    result.decoded = history.getDecoded();
+    return result;
+}
+
+static unsigned long decodedByOpen(const char* path) {
+    LogHistory history;
+    history.open(path);
+    return history.getDecoded();
+}
+
+int benchmarkHistory() {
+    Serial.mute(true);
+    SimHal::fs().setCapacity(16UL * 1024 * 1024);
+    SimHal::fs().begin(true);
+    bool ok = true;
+
+    printf("query                 : last %lu h at %d points, LOG_INDEX_INTERVAL %d s\n", QUERY_SECONDS / 3600,
+           QUERY_POINTS, LOG_INDEX_INTERVAL / 1000);
+    for (unsigned long hours : COOK_HOURS) {
+        String path = writeCook(hours);
+        String indexPath = path.substring(0, path.length() - 4) + ".idx";
+        std::vector<LogEntry> all = decodeAll(path.c_str());
+        unsigned long end = all.back().timestamp;
+        unsigned long from = end - QUERY_SECONDS * 1000;
+        size_t logBytes = SimHal::fs().getContents(path.c_str())->size();
+        size_t indexBytes = SimHal::fs().getContents(indexPath.c_str())->size();
+
+        QueryResult indexed = run(path.c_str(), from, end, QUERY_POINTS);
+        unsigned long openCost = decodedByOpen(path.c_str());
+        QueryResult whole = run(path.c_str(), 0, end, QUERY_POINTS);
+
+        // The same queries without the index
+        SimFileSystem::Blob index = *SimHal::fs().getContents(indexPath.c_str());
+        SimHal::fs().remove(indexPath.c_str());
+        QueryResult unindexed = run(path.c_str(), from, end, QUERY_POINTS);
+        HalFile* restore = HAL::fs().open(indexPath.c_str(), "w");
+        restore->write(index.data(), index.size());
+        restore->close();
+        delete restore;
+
+        bool same = indexed.kept == reference(all, from, end, QUERY_POINTS) && unindexed.kept == indexed.kept &&
+                    whole.kept == reference(all, 0, end, QUERY_POINTS) &&
+                    (int)indexed.kept.size() <= QUERY_POINTS && (int)whole.kept.size() <= QUERY_POINTS;
+        ok &= same;
+
+        // A client without the query fetched the whole log, as CSV before
+        size_t csvBytes = 0;
+        char line[64];
+        for (const LogEntry& entry : all) csvBytes += LogDecoder::formatCSV(entry, line, sizeof(line));
+
+        float lowest = 1000.0f;
+        for (const LogEntry& entry : all) {
+            if (entry.timestamp > 3600000) lowest = min(lowest, entry.temperature);
+        }
+        printf("%2lu h cook            : %6u samples, .bin %u bytes, .idx %u bytes (%.1f %%)\n", hours,
+               (unsigned)all.size(), (unsigned)logBytes, (unsigned)indexBytes, 100.0 * indexBytes / logBytes);
+        printf("  last 2 h, indexed   : %3u points, %5u bytes JSON, %6lu samples decoded (%lu by open), %7.0f us\n",
+               (unsigned)indexed.kept.size(), (unsigned)indexed.jsonBytes, indexed.decoded, openCost,
+               indexed.microseconds);
+        printf("  last 2 h, no index  : %3u points, %5u bytes JSON, %6lu samples decoded, %7.0f us\n",
+               (unsigned)unindexed.kept.size(), (unsigned)unindexed.jsonBytes, unindexed.decoded,
+               unindexed.microseconds);
+        printf("  whole cook          : %3u points, %5u bytes JSON, %6lu samples decoded, %7.0f us; "
+               "lid dips to %.2f C kept (log %.2f C)\n",
+               (unsigned)whole.kept.size(), (unsigned)whole.jsonBytes, whole.decoded, whole.microseconds,
+               whole.lowest, lowest);
+        printf("  fetching the log    : %u bytes binary, %u bytes CSV; LTTB matches reference: %s\n",
+               (unsigned)logBytes, (unsigned)csvBytes, same ? "yes" : "NO");
+    }
+
+    // Degenerate ranges: a single instant, on and between samples, and a
+    // window holding one sample, where the buckets span no time at all
+    String path = writeCook(1);
+    std::vector<LogEntry> all = decodeAll(path.c_str());
+    unsigned long at = all[all.size() / 2].timestamp;
+    struct { unsigned long from, to; size_t points; } narrow[] = {
+        {at, at, 1},
+        {at + 1, at + 1, 0},
+        {at, at + DATA_LOG_INTERVAL - 1, 1},
+        {at - DATA_LOG_INTERVAL + 1, at + DATA_LOG_INTERVAL - 1, 1},
+        {at, at + DATA_LOG_INTERVAL, 2},
+    };
+    bool narrowOk = true;
+    for (const auto& range : narrow) {
+        QueryResult result = run(path.c_str(), range.from, range.to, QUERY_POINTS);
+        narrowOk &= result.kept.size() == range.points &&
+                    result.kept == reference(all, range.from, range.to, QUERY_POINTS);
+    }
+    printf("narrow ranges         : from == to and one-sample windows %s\n", narrowOk ? "match" : "MISMATCH");
+    ok &= narrowOk;
+
+    printf("check                 : %s\n", ok ? "streaming LTTB identical to the buffered reference" : "FAILED");
+    return ok ? 0 : 1;
+}
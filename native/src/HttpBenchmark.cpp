@@ -0,0 +1,190 @@
+// Control-loop jitter while dashboard clients load the web server over
+// loopback TCP: the synchronous WebServer pattern, where handleClient() in
+// loop() accepts a client and reads its request to completion, against
+// AsyncHttpServer running from the network thread.
+//
+// Each client stands in for a phone on WiFi: its request arrives
+// WIFI_LATENCY_US after the connection opens. It loads / once and then
+// polls /status once a second, as the old dashboard did. Virtual time
+// follows the loop period.
+
+#include "../include/Benchmarks.h"
+#include "../include/SimHal.h"
+#include "../../include/Tasks.h"
+#include <arpa/inet.h>
+#include <atomic>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <thread>
+#include <algorithm>
+#include <unistd.h>
+#include <vector>
+
+// Firmware entry points from SC_ESP32.ino, linked in through main.cpp
+void setup();
+void controlStep();
+void uiStep();
+
+static const unsigned long RUN_TIME = 5000;         // ms of wall-clock time per configuration
+static const unsigned long WIFI_LATENCY_US = 20000;     // busy 2.4 GHz, phone in power save
+static const unsigned long POLL_INTERVAL_MS = 1000;
+static const int CLIENT_COUNTS[] = {0, 10, 30};
+
+struct ClientTotals {
+    std::atomic<unsigned long> ok;
+    std::atomic<unsigned long> failed;
+};
+
+static bool fetch(uint16_t port, const char* path) {
+    int fd = connectLoopback(port, 2);
+    if (fd < 0) return false;
+    std::this_thread::sleep_for(std::chrono::microseconds(WIFI_LATENCY_US));
+
+    char request[128];
+    int length = snprintf(request, sizeof(request),
+                          "GET %s HTTP/1.1\r\nHost: sousvide\r\nConnection: close\r\n\r\n", path);
+    bool ok = send(fd, request, length, MSG_NOSIGNAL) == length;
+
+    // Read to the close, keeping the status line
+    char status[16] = "";
+    char buffer[2048];
+    size_t total = 0;
+    ssize_t received;
+    while (ok && (received = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        if (total == 0) memcpy(status, buffer, received < 15 ? received : 15);
+        total += received;
+    }
+    close(fd);
+    return ok && strncmp(status, "HTTP/1.1 200", 12) == 0;
+}
+
+static void client(uint16_t port, unsigned offsetMs, std::atomic<bool>* stop, ClientTotals* totals) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(offsetMs));
+    const char* path = "/";
+    auto next = std::chrono::steady_clock::now();
+    while (!*stop) {
+        (fetch(port, path) ? totals->ok : totals->failed)++;
+        path = "/status";
+        next += std::chrono::milliseconds(POLL_INTERVAL_MS);
+        while (!*stop && std::chrono::steady_clock::now() < next) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+}
+
+// --- The synchronous pattern: one client per loop(), read to completion
+
+static int syncListenFd = -1;
+static std::string syncPage(3000, ' ');
+
+static void serveSynchronously() {
+    int fd = accept(syncListenFd, nullptr, nullptr);
+    if (fd < 0) return;
+
+    // WebServer waits up to HTTP_MAX_DATA_WAIT for the request
+    timeval timeout = {5, 0};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    char request[512];
+    size_t length = 0;
+    ssize_t received;
+    request[0] = '\0';
+    while (strstr(request, "\r\n\r\n") == nullptr && length < sizeof(request) - 1 &&
+           (received = recv(fd, request + length, sizeof(request) - 1 - length, 0)) > 0) {
+        length += received;
+        request[length] = '\0';
+    }
+
+    bool root = strncmp(request, "GET / ", 6) == 0;
+    const char* body = root ? syncPage.c_str() : "{\"status\":\"ok\"}";
+    char header[160];
+    int headerLength = snprintf(header, sizeof(header),
+                                "HTTP/1.1 200 OK\r\nContent-Type: %s\r\nContent-Length: %u\r\nConnection: close\r\n\r\n",
+                                root ? "text/html" : "application/json", (unsigned)strlen(body));
+    send(fd, header, headerLength, MSG_NOSIGNAL);
+    send(fd, body, strlen(body), MSG_NOSIGNAL);
+    close(fd);
+}
+
+static uint16_t openSyncServer() {
+    syncListenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(address);
+    bind(syncListenFd, (sockaddr*)&address, sizeof(address));
+    listen(syncListenFd, 64);
+    getsockname(syncListenFd, (sockaddr*)&address, &length);
+    return ntohs(address.sin_port);
+}
+
+// Loop start times, for percentiles of the start-to-start deviation
+static std::vector<std::chrono::steady_clock::time_point> starts;
+
+static void syncLoop() {
+    starts.push_back(std::chrono::steady_clock::now());
+    controlStep();
+    uiStep();
+    serveSynchronously();
+    SimHal::clock().advance(CONTROL_TASK_PERIOD);
+}
+
+static void asyncLoop() {
+    starts.push_back(std::chrono::steady_clock::now());
+    controlStep();
+    uiStep();
+    SimHal::clock().advance(CONTROL_TASK_PERIOD);
+}
+
+static void measure(const char* name, void (*body)(), uint16_t port, int clients) {
+    std::atomic<bool> stop(false);
+    ClientTotals totals;
+    totals.ok = 0;
+    totals.failed = 0;
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < clients; i++) {
+        threads.emplace_back(client, port, (unsigned)(i * POLL_INTERVAL_MS / clients), &stop, &totals);
+    }
+
+    starts.clear();
+    starts.reserve(RUN_TIME / CONTROL_TASK_PERIOD * 2);
+    PeriodicTask loopTask("loop", body, CONTROL_TASK_PERIOD, CONTROL_TASK_PRIORITY, -1);
+    loopTask.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(RUN_TIME));
+    stop = true;
+    for (std::thread& thread : threads) thread.join();
+    loopTask.stop();
+
+    std::vector<long> jitter;
+    for (size_t i = 1; i < starts.size(); i++) {
+        long interval = std::chrono::duration_cast<std::chrono::microseconds>(starts[i] - starts[i - 1]).count();
+        jitter.push_back(labs(interval - CONTROL_TASK_PERIOD * 1000L));
+    }
+    std::sort(jitter.begin(), jitter.end());
+    size_t late = jitter.end() - std::upper_bound(jitter.begin(), jitter.end(), 2000L);
+    printf("%-6s %3d clients: jitter p50 %5ld us, p99 %6ld us, max %6ld us, %4.1f %% over 2 ms; "
+           "%lu requests ok, %lu failed\n",
+           name, clients, jitter[jitter.size() / 2], jitter[jitter.size() * 99 / 100], jitter.back(),
+           late * 100.0 / jitter.size(), (unsigned long)totals.ok, (unsigned long)totals.failed);
+}
+
+int benchmarkHttp() {
+    Serial.mute(true);
+    SimHal::tcpServer().enableLoopback(true);
+    setup();
+    uint16_t asyncPort = SimHal::tcpServer().getPort();
+    uint16_t syncPort = openSyncServer();
+
+    printf("loop period           : %d ms, %lu ms per configuration, %lu us WiFi latency\n",
+           CONTROL_TASK_PERIOD, RUN_TIME, WIFI_LATENCY_US);
+    for (int clients : CLIENT_COUNTS) {
+        measure("sync", syncLoop, syncPort, clients);
+    }
+    for (int clients : CLIENT_COUNTS) {
+        measure("async", asyncLoop, asyncPort, clients);
+    }
+
+    close(syncListenFd);
+    SimHal::tcpServer().end();
+    return 0;
+}
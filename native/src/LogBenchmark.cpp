@@ -0,0 +1,170 @@
+// Bytes per logged sample over a two-day cook at DATA_LOG_INTERVAL: the
+// binary format (LogCodec.h) against the CSV DataLogger wrote before.
+//
+// The sketch's own logger writes the binary session while the benchmark
+// feeds the same samples to a second DataLogger in CSV mode. The
+// filesystem is enlarged so the CSV run is not cut short; what fits is
+// then projected onto the real SPIFFS partition. The binary log is decoded
+// back and every sample compared with what was logged, both whole and cut
+// off mid-record as after a power loss.
+
+#include "../include/Benchmarks.h"
+#include "../include/SimHal.h"
+#include "../include/WaterBath.h"
+#include "../../include/StateMachine.h"
+#include "../../include/DataLogger.h"
+#include "../../include/LogPolicy.h"
+#include "../../include/ControlStatus.h"
+#include <vector>
+
+// Firmware entry points and state from SC_ESP32.ino, linked in through main.cpp
+void setup();
+void loop();
+extern StateMachine stateMachine;
+extern DataLogger dataLogger;
+extern LogPolicy logPolicy;
+extern ControlStatus uiStatus;
+extern unsigned long lastLogTime;
+
+static const unsigned long COOK_SECONDS = 48 * 3600UL;
+static const size_t PARTITION_BYTES = 1378241;     // SimFileSystem default
+
+struct Errors {
+    unsigned long samples;
+    float temperature;
+    float target;
+    float power;
+    unsigned long time;
+    unsigned long remainingMismatches;
+};
+
+// Decodes a log held in memory, up to length bytes, against what was logged
+static Errors check(const SimFileSystem::Blob& log, size_t length, const std::vector<LogEntry>& logged,
+                    LogHeader& header, bool& complete) {
+    size_t offset = 0;
+    LogDecoder decoder([&](uint8_t* buffer, size_t size) {
+        size_t count = min(size, length - offset);
+        memcpy(buffer, log.data() + offset, count);
+        offset += count;
+        return (int)count;
+    });
+
+    Errors errors = {0, 0, 0, 0, 0, 0};
+    complete = false;
+    if (!decoder.begin()) return errors;
+    header = decoder.getHeader();
+
+    LogEntry entry;
+    while (decoder.next(entry) && errors.samples < logged.size()) {
+        // Logged with the absolute time; the decoder returns it session-relative
+        LogEntry expected = logged[errors.samples++];
+        expected.timestamp -= header.startTime;
+        errors.temperature = max(errors.temperature, fabsf(entry.temperature - expected.temperature));
+        errors.target = max(errors.target, fabsf(entry.targetTemp - expected.targetTemp));
+        errors.power = max(errors.power, fabsf(entry.power - expected.power));
+        errors.time = max(errors.time, (unsigned long)labs((long)(entry.timestamp - expected.timestamp)));
+        if (entry.remainingTime != expected.remainingTime) errors.remainingMismatches++;
+    }
+    complete = decoder.isComplete();
+    return errors;
+}
+
+int benchmarkLog() {
+    Serial.mute(true);
+    SimHal::fs().setCapacity(64UL * 1024 * 1024);
+
+    WaterBath::Parameters params = WaterBath::defaultParameters();
+    WaterBath bath(params);
+    SimHal::oneWire().setTemperature(params.sensorIndex, params.initialTemp);
+    bath.attach();
+    setup();
+    String binaryName = dataLogger.getCurrentLogFileName();
+
+    DataLogger csvLogger;
+    csvLogger.setBinary(false);
+    csvLogger.begin();
+
+    // Every sample, so a loop() that logs has logged uiStatus itself;
+    // LogPolicy's thinning is measured by --bench=logpolicy
+    logPolicy.setAdaptive(false);
+    stateMachine.setCookingTime(COOK_SECONDS);
+    stateMachine.startCooking();
+
+    std::vector<LogEntry> logged;
+    logged.reserve(COOK_SECONDS * 1000 / DATA_LOG_INTERVAL + 1);
+    int lastCount = 0;
+    while (stateMachine.getCurrentState() != STATE_FINISHED && stateMachine.getCurrentState() != STATE_ERROR) {
+        loop();
+        if (dataLogger.getEntryCount() == lastCount) continue;
+        lastCount = dataLogger.getEntryCount();
+
+        // The sketch just logged uiStatus; log the same sample as CSV
+        LogEntry entry = {lastLogTime, uiStatus.currentTemp, uiStatus.targetTemp,
+                          uiStatus.power, uiStatus.remainingTime};
+        logged.push_back(entry);
+        csvLogger.logData(entry.temperature, entry.targetTemp, entry.power, entry.remainingTime);
+        csvLogger.commit();
+    }
+    dataLogger.endSession();
+    dataLogger.commit();
+    csvLogger.endSession();
+    csvLogger.commit();
+
+    size_t csvBytes = 0, csvFiles = 0;
+    SimHal::fs().listFiles([&](const char* path, size_t size) {
+        if (strncmp(path, "/log_", 5) == 0 && strstr(path, ".csv") != nullptr) {
+            csvBytes += size;
+            csvFiles++;
+        }
+    });
+
+    const SimFileSystem::Blob& log = *SimHal::fs().getContents(binaryName.c_str());
+    LogHeader header;
+    bool complete, truncatedComplete;
+    Errors errors = check(log, log.size(), logged, header, complete);
+    // Cut in the middle of the run, as a power loss would leave the file
+    size_t cut = log.size() / 2 + 3;
+    Errors truncated = check(log, cut, logged, header, truncatedComplete);
+
+    // Encoder cost per sample, over the logged data
+    LogEncoder encoder;
+    volatile uint8_t sink = 0;
+    uint64_t start = benchmarkTicks();
+    auto wallStart = std::chrono::steady_clock::now();
+    for (const LogEntry& entry : logged) {
+        encoder.add(entry);
+        sink = encoder.data()[0];
+        encoder.consume();
+    }
+    double encodeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - wallStart).count() / (double)logged.size();
+    double encodeTicks = (double)(benchmarkTicks() - start) / logged.size();
+    (void)sink;
+
+    size_t samples = logged.size();
+    double csvPerSample = (double)csvBytes / samples;
+    double binaryPerSample = (double)(log.size() - LOG_HEADER_SIZE) / samples;
+    double samplesPerDay = 86400000.0 / DATA_LOG_INTERVAL;
+    bool roundTrip = complete && errors.samples == samples && errors.remainingMismatches == 0 &&
+                     errors.temperature <= 0.5f / (1 << LOG_TEMPERATURE_BITS) &&
+                     errors.target <= 0.5f / (1 << LOG_TEMPERATURE_BITS) &&
+                     errors.power <= 0.5f / (1 << LOG_POWER_BITS) && errors.time <= LOG_TIME_UNIT / 2;
+    bool truncatedOk = !truncatedComplete && truncated.samples > 0 && truncated.samples < samples &&
+                       truncated.remainingMismatches == 0 && truncated.temperature <= errors.temperature;
+
+    printf("cook                  : %lu h at %d ms per sample, %u samples\n",
+           COOK_SECONDS / 3600, DATA_LOG_INTERVAL, (unsigned)samples);
+    printf("CSV                   : %u bytes in %u files, %.1f bytes per sample\n",
+           (unsigned)csvBytes, (unsigned)csvFiles, csvPerSample);
+    printf("binary                : %u bytes in 1 file, %.2f bytes per sample (%.1fx smaller)\n",
+           (unsigned)log.size(), binaryPerSample, csvPerSample / binaryPerSample);
+    printf("SPIFFS %u bytes  : CSV %.1f days, binary %.1f days\n", (unsigned)PARTITION_BYTES,
+           (PARTITION_BYTES - LOG_MIN_FREE_SPACE) / csvPerSample / samplesPerDay,
+           (PARTITION_BYTES - LOG_MIN_FREE_SPACE) / binaryPerSample / samplesPerDay);
+    printf("round trip            : %s; max error temp %.4f C, target %.4f C, power %.3f %%, time %lu ms\n",
+           roundTrip ? "ok" : "FAILED", errors.temperature, errors.target, errors.power, errors.time);
+    printf("cut off at %-10u : %s, %u samples recovered, no end marker\n", (unsigned)cut,
+           truncatedOk ? "ok" : "FAILED", (unsigned)truncated.samples);
+    printf("encode                : %.0f ns, %.0f %s per sample\n", encodeNs, encodeTicks, benchmarkTickUnit());
+    return roundTrip && truncatedOk ? 0 : 1;
+}
@@ -0,0 +1,240 @@
+// Bytes logged against fidelity for a whole cook: the previous sketch, which
+// logged every sample while cooking and nothing else, every sample across
+// preheat, cooking and the cool-down after it, and LogPolicy's deadband and
+// bursts over the same states.
+//
+// A PIDController with the tuned gains and the Kalman rate holds the
+// simulated 10 L bath, read through a DS18B20 quantized to 1/16 C with one
+// step of noise. The cook preheats from 20 C to 56 C, has the lid opened at
+// 2 h, the setpoint raised to 60 C at 4 h and finishes at 6 h, followed by
+// 30 minutes of cooling.
+// Each log is encoded with LogEncoder as DataLogger would write it, then
+// drawn as a chart would, straight lines through the logged samples, and
+// compared with every sample of the stream.
+
+#include "../include/Benchmarks.h"
+#include "../include/SimHal.h"
+#include "../include/WaterBath.h"
+#include "../../include/PIDController.h"
+#include "../../include/TemperatureKalman.h"
+#include "../../include/LogPolicy.h"
+#include <vector>
+
+static const unsigned long COOK_SECONDS = 6 * 3600UL;
+static const unsigned long LID_AT = 2 * 3600UL;            // s into the cook
+static const unsigned long SETPOINT_AT = 4 * 3600UL;
+static const unsigned long COOL_SECONDS = 1800;
+static const float TARGET = 56.0f;
+static const float RAISED_TARGET = 60.0f;
+
+struct Sample {
+    ControlStatus status;
+    unsigned long time;         // ms
+};
+
+// The status stream at DATA_LOG_INTERVAL, idle for a minute either side
+static std::vector<Sample> simulate() {
+    WaterBath bath;
+    PIDController pid;
+    TemperatureKalman kalman;
+    pid.begin(84.196f, 1.18481f, 3988.773f);
+    pid.setOutputLimits(0, 100);
+    pid.enableAntiWindup(true);
+
+    std::vector<Sample> stream;
+    SystemState state = STATE_IDLE;
+    float target = TARGET;
+    unsigned long cookStart = 0, finishedAt = 0;
+    unsigned long noise = 12345;
+    float power = 0;
+    for (unsigned long i = 0;; i++) {
+        unsigned long seconds = i * DATA_LOG_INTERVAL / 1000;
+        if (state == STATE_IDLE && seconds == 60 && finishedAt == 0) state = STATE_PREHEAT;
+
+        noise = noise * 1103515245 + 12345;
+        float measured = roundf(bath.getProbeTemperature() * 16 + (float)((noise >> 16) % 3) - 1) / 16;
+        kalman.update(measured, 12, HAL::clock().millis());
+
+        if (state == STATE_PREHEAT && measured >= target - 0.5f) {
+            state = STATE_COOKING;
+            cookStart = seconds;
+        }
+        if (state == STATE_COOKING) {
+            unsigned long cooked = seconds - cookStart;
+            if (cooked == LID_AT) bath.setWaterTemperature(bath.getWaterTemperature() - 3.0f);
+            if (cooked == SETPOINT_AT) target = RAISED_TARGET;
+            if (cooked >= COOK_SECONDS) {
+                state = STATE_FINISHED;
+                finishedAt = seconds;
+            }
+        }
+        if (state == STATE_FINISHED && seconds - finishedAt >= COOL_SECONDS) state = STATE_IDLE;
+        if (finishedAt != 0 && state == STATE_IDLE && seconds - finishedAt >= COOL_SECONDS + 60) break;
+
+        if (state == STATE_PREHEAT || state == STATE_COOKING) {
+            pid.setMode(true);
+            pid.setSetpoint(target);
+            power = pid.compute(measured, kalman.getRate());
+        } else {
+            pid.setMode(false);
+            power = 0;
+        }
+
+        Sample sample = {};
+        sample.time = 5000 + i * DATA_LOG_INTERVAL;
+        sample.status.state = state;
+        sample.status.currentTemp = measured;
+        sample.status.targetTemp = target;
+        sample.status.power = power;
+        sample.status.remainingTime = state == STATE_COOKING ? COOK_SECONDS - (seconds - cookStart) : 0;
+        stream.push_back(sample);
+
+        // The SSR's share of the interval, then off
+        double dt = DATA_LOG_INTERVAL / 1000.0;
+        bath.step(dt * power / 100, true);
+        bath.step(dt * (1 - power / 100), false);
+        SimHal::clock().advance(DATA_LOG_INTERVAL);
+    }
+    return stream;
+}
+
+struct Fidelity {
+    unsigned long covered;
+    unsigned long missing;      // samples no logged line passes
+    double squares;
+    float maxError;
+};
+
+struct PolicyResult {
+    std::vector<LogEntry> logged;
+    size_t bytes;
+    Fidelity phases[3];         // preheat, cooking, finished
+    float lidLowest;            // lowest temperature logged in the 10 min after the lid
+};
+
+static int phaseOf(SystemState state) {
+    return state == STATE_PREHEAT ? 0 : state == STATE_COOKING ? 1 : state == STATE_FINISHED ? 2 : -1;
+}
+
+template <typename Offer>
+static PolicyResult run(const std::vector<Sample>& stream, Offer offer) {
+    PolicyResult result = {};
+    result.lidLowest = 1000.0f;
+    for (const Sample& sample : stream) offer(sample, result.logged);
+
+    // Bytes on flash, as DataLogger writes the session
+    LogEncoder encoder;
+    uint8_t header[LOG_HEADER_SIZE];
+    result.bytes = encoder.begin(header, 0);
+    for (const LogEntry& entry : result.logged) {
+        encoder.add(entry);
+        result.bytes += encoder.available();
+        encoder.consume();
+    }
+    encoder.finish();
+    result.bytes += encoder.available();
+
+    // Straight lines through the logged samples against every sample
+    size_t segment = 0;
+    const std::vector<LogEntry>& logged = result.logged;
+    unsigned long lidTime = 0;
+    for (const Sample& sample : stream) {
+        int phase = phaseOf(sample.status.state);
+        if (phase < 0) continue;
+        Fidelity& fidelity = result.phases[phase];
+        while (segment + 1 < logged.size() && logged[segment + 1].timestamp <= sample.time) segment++;
+        if (logged.empty() || logged[segment].timestamp > sample.time ||
+            (segment + 1 >= logged.size() && logged[segment].timestamp != sample.time)) {
+            fidelity.missing++;
+            continue;
+        }
+        float drawn = logged[segment].temperature;
+        if (logged[segment].timestamp != sample.time) {
+            const LogEntry& a = logged[segment];
+            const LogEntry& b = logged[segment + 1];
+            drawn += (b.temperature - a.temperature) * (sample.time - a.timestamp) / (b.timestamp - a.timestamp);
+        }
+        float error = fabsf(drawn - sample.status.currentTemp);
+        fidelity.covered++;
+        fidelity.squares += error * error;
+        fidelity.maxError = max(fidelity.maxError, error);
+
+        if (sample.status.state == STATE_COOKING && sample.status.remainingTime == COOK_SECONDS - LID_AT) {
+            lidTime = sample.time;
+        }
+    }
+    for (const LogEntry& entry : logged) {
+        if (lidTime != 0 && entry.timestamp >= lidTime && entry.timestamp < lidTime + 600000) {
+            result.lidLowest = min(result.lidLowest, entry.temperature);
+        }
+    }
+    return result;
+}
+
+static void print(const char* name, const PolicyResult& result, const PolicyResult& reference) {
+    static const char* PHASES[] = {"preheat", "cooking", "finished"};
+    printf("%-12s : %6u samples, %6u bytes (%5.1f %% of every sample)\n", name,
+           (unsigned)result.logged.size(), (unsigned)result.bytes, 100.0 * result.bytes / reference.bytes);
+    for (int phase = 0; phase < 3; phase++) {
+        const Fidelity& fidelity = result.phases[phase];
+        if (fidelity.covered == 0) {
+            printf("  %-10s : not logged (%lu samples)\n", PHASES[phase], fidelity.missing);
+            continue;
+        }
+        printf("  %-10s : drawn within %.3f C of every sample, rms %.3f C\n", PHASES[phase],
+               fidelity.maxError, sqrt(fidelity.squares / fidelity.covered));
+    }
+    if (result.lidLowest < 1000.0f) {
+        printf("  lid opened : lowest %.2f C logged (stream %.2f C)\n", result.lidLowest, reference.lidLowest);
+    }
+}
+
+int benchmarkLogPolicy() {
+    Serial.mute(true);
+    std::vector<Sample> stream = simulate();
+
+    // The previous sketch: every sample, only while cooking
+    PolicyResult cooking = run(stream, [](const Sample& sample, std::vector<LogEntry>& logged) {
+        if (sample.status.state != STATE_COOKING) return;
+        LogEntry entry = {sample.time, sample.status.currentTemp, sample.status.targetTemp,
+                          sample.status.power, sample.status.remainingTime};
+        logged.push_back(entry);
+    });
+
+    LogPolicy everyPolicy;
+    everyPolicy.setAdaptive(false);
+    LogPolicy adaptivePolicy;
+    auto through = [](LogPolicy& policy) {
+        return [&policy](const Sample& sample, std::vector<LogEntry>& logged) {
+            policy.offer(sample.status, sample.time);
+            LogEntry entry;
+            while (policy.next(entry)) logged.push_back(entry);
+        };
+    };
+    PolicyResult every = run(stream, through(everyPolicy));
+    PolicyResult adaptive = run(stream, through(adaptivePolicy));
+
+    printf("cook                 : %lu s preheat, %lu h hold, lid at %lu h, %.0f -> %.0f C at %lu h, "
+           "%lu min cooling\n", every.phases[0].covered, COOK_SECONDS / 3600, LID_AT / 3600, TARGET,
+           RAISED_TARGET, SETPOINT_AT / 3600, COOL_SECONDS / 60);
+    printf("policy               : deadband %.2f C / %.0f %%, heartbeat %d s, bursts of %d s at %d ms\n",
+           LOG_DEADBAND_TEMP, LOG_DEADBAND_POWER, LOG_HEARTBEAT / 1000, LOG_BURST_DURATION / 1000,
+           DATA_LOG_INTERVAL);
+    print("cooking only", cooking, every);
+    print("every sample", every, every);
+    print("adaptive", adaptive, every);
+
+    // Every logged sample is one of the stream's, in order, and the
+    // deadband bound holds everywhere the line is drawn
+    bool ordered = true;
+    for (size_t i = 1; i < adaptive.logged.size(); i++) {
+        ordered &= adaptive.logged[i].timestamp > adaptive.logged[i - 1].timestamp;
+    }
+    bool ok = ordered && adaptive.bytes < every.bytes && adaptive.lidLowest == every.lidLowest;
+    for (int phase = 0; phase < 3; phase++) {
+        ok &= adaptive.phases[phase].missing == 0 && adaptive.phases[phase].maxError < 2 * LOG_DEADBAND_TEMP;
+    }
+    printf("check                : %s\n", ok ? "all states logged, lines within two deadbands, lid dip kept"
+                                             : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,313 @@
+// Downloading a two-day log from GET /logs over loopback TCP, the way a
+// sync client would: the whole file chunked, then resumed from an offset
+// with Range, then only the bytes appended since the last sync.
+//
+// Every body is checked byte for byte against the file in SimFileSystem,
+// and the CSV view against the log decoded locally. The heap peak of each
+// download is taken from the runner's operator new with the client's own
+// buffers reserved beforehand, so what shows is the server's: the
+// previous DataLogger::exportToCSV() held the whole CSV in one String.
+
+#include "../include/Benchmarks.h"
+#include "../include/SimHal.h"
+#include "../../include/WebInterface.h"
+#include "../../include/LogCodec.h"
+#include <sys/socket.h>
+#include <string>
+#include <unistd.h>
+
+static const unsigned long LOG_SECONDS = 48 * 3600UL;
+static const char* LOG_NAME = "log_1000.bin";
+
+struct Response {
+    int code;
+    std::string headers;
+    std::string body;
+    bool chunked;
+    size_t chunks;
+    size_t largestChunk;
+    size_t peakHeap;            // most bytes allocated at once while it was served
+};
+
+// A buffered reader over one connection, so responses can follow each
+// other on a keep-alive connection
+class Reader {
+private:
+    int fd;
+    char buffer[1460];
+    size_t length;
+    size_t offset;
+
+public:
+    Reader(int fd) : fd(fd), length(0), offset(0) {}
+
+    bool fill() {
+        if (offset < length) return true;
+        ssize_t received = recv(fd, buffer, sizeof(buffer), 0);
+        if (received <= 0) return false;
+        length = received;
+        offset = 0;
+        return true;
+    }
+
+    bool line(std::string& text) {
+        text.clear();
+        while (fill()) {
+            char c = buffer[offset++];
+            text += c;
+            if (c == '\n') return true;
+        }
+        return false;
+    }
+
+    bool bytes(std::string& out, size_t count) {
+        while (count > 0 && fill()) {
+            size_t part = min(count, length - offset);
+            out.append(buffer + offset, part);
+            offset += part;
+            count -= part;
+        }
+        return count == 0;
+    }
+
+    void rest(std::string& out) {
+        while (fill()) {
+            out.append(buffer + offset, length - offset);
+            offset = length;
+        }
+    }
+};
+
+static std::string headerValue(const std::string& headers, const char* name) {
+    std::string key = std::string("\r\n") + name + ": ";
+    size_t start = headers.find(key);
+    if (start == std::string::npos) return "";
+    start += key.size();
+    return headers.substr(start, headers.find("\r\n", start) - start);
+}
+
+static bool receive(Reader& reader, bool head, Response& response) {
+    static std::string text;
+    text.reserve(256);
+    response.headers.clear();
+    response.body.clear();
+    response.chunks = 0;
+    response.largestChunk = 0;
+    if (!reader.line(text) || sscanf(text.c_str(), "HTTP/1.1 %d", &response.code) != 1) return false;
+    response.headers = "\r\n";
+    while (reader.line(text) && text != "\r\n") {
+        response.headers += text;
+    }
+    response.chunked = headerValue(response.headers, "Transfer-Encoding") == "chunked";
+    std::string length = headerValue(response.headers, "Content-Length");
+    bool ok = true;
+    if (head) {
+        // No body
+    } else if (response.chunked) {
+        while ((ok = reader.line(text))) {
+            size_t size = strtoul(text.c_str(), nullptr, 16);
+            if (size == 0) {
+                ok = reader.line(text);
+                break;
+            }
+            response.chunks++;
+            response.largestChunk = max(response.largestChunk, size);
+            if (!(ok = reader.bytes(response.body, size) && reader.line(text))) break;
+        }
+    } else if (!length.empty()) {
+        ok = reader.bytes(response.body, strtoul(length.c_str(), nullptr, 10));
+    } else {
+        reader.rest(response.body);
+    }
+    return ok;
+}
+
+// One request on its own connection
+static bool fetch(uint16_t port, const char* request, Response& response, double* seconds = nullptr) {
+    response.headers.reserve(1024);
+    response.body.reserve(8 << 20);
+    size_t idle = heapLiveBytes();
+    heapResetPeak();
+    int fd = connectLoopback(port, 5);
+    if (fd < 0) return false;
+    Reader reader(fd);
+    auto start = std::chrono::steady_clock::now();
+    bool ok = send(fd, request, strlen(request), MSG_NOSIGNAL) == (ssize_t)strlen(request) &&
+              receive(reader, strncmp(request, "HEAD", 4) == 0, response);
+    if (seconds != nullptr) {
+        *seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    close(fd);
+    response.peakHeap = heapPeakBytes() - idle;
+    return ok;
+}
+
+static std::string getRequest(const char* target, const char* headers = "") {
+    char request[256];
+    snprintf(request, sizeof(request), "GET %s HTTP/1.1\r\nHost: sousvide\r\n%s\r\n", target, headers);
+    return request;
+}
+
+// A steady cook at DATA_LOG_INTERVAL, written the way the log task would;
+// the session stays open so it can grow between syncs
+static LogEncoder encoder;
+static unsigned long logged = 0;
+
+static void writeLog(const char* path, unsigned long seconds) {
+    HalFile* file = HAL::fs().open(path, logged == 0 ? "w" : "a");
+    if (logged == 0) {
+        uint8_t header[LOG_HEADER_SIZE];
+        file->write(header, encoder.begin(header, 1000));
+    }
+    for (unsigned long end = logged + seconds * 1000 / DATA_LOG_INTERVAL; logged < end; logged++) {
+        unsigned long i = logged;
+        LogEntry entry = {i * DATA_LOG_INTERVAL, 56.0f + 0.0625f * (float)((i * 7919 / 13) % 5) - 0.125f, 56.0f,
+                          14.0f + 4.0f * sinf(i / 97.0f), LOG_SECONDS - i * DATA_LOG_INTERVAL / 1000};
+        encoder.add(entry);
+        file->write(encoder.data(), encoder.available());
+        encoder.consume();
+    }
+    file->close();
+    delete file;
+}
+
+static std::string contents(const char* path) {
+    const SimFileSystem::Blob* blob = SimHal::fs().getContents(path);
+    return blob != nullptr ? std::string(blob->begin(), blob->end()) : std::string();
+}
+
+static std::string decodeToCsv(const std::string& log) {
+    size_t offset = 0;
+    LogDecoder decoder([&](uint8_t* buffer, size_t size) {
+        size_t count = min(size, log.size() - offset);
+        memcpy(buffer, log.data() + offset, count);
+        offset += count;
+        return (int)count;
+    });
+    std::string csv = LOG_CSV_HEADER "\r\n";
+    if (!decoder.begin()) return "";
+    LogEntry entry;
+    char line[64];
+    while (decoder.next(entry)) {
+        csv.append(line, LogDecoder::formatCSV(entry, line, sizeof(line)));
+    }
+    return csv;
+}
+
+static bool report(const char* name, bool ok, const Response& response, const char* detail = "") {
+    printf("%-22s: %s, %d, %7u bytes, heap +%u bytes%s\n", name, ok ? "ok    " : "FAILED", response.code,
+           (unsigned)response.body.size(), (unsigned)response.peakHeap, detail);
+    return ok;
+}
+
+int benchmarkLogs() {
+    Serial.mute(true);
+    SimHal::fs().begin(true);
+    SimHal::tcpServer().enableLoopback(true);
+    char path[40];
+    snprintf(path, sizeof(path), "/%s", LOG_NAME);
+    writeLog(path, LOG_SECONDS - 600);
+    HalFile* csvLog = HAL::fs().open("/log_900.csv", "w");
+    csvLog->println(LOG_CSV_HEADER);
+    csvLog->close();
+    delete csvLog;
+
+    WebInterface web;
+    web.begin();
+    uint16_t port = SimHal::tcpServer().getPort();
+    std::string file = contents(path);
+    char target[96], headers[128], detail[96];
+    Response response;
+    bool ok = true;
+
+    // The list
+    ok &= fetch(port, getRequest("/logs").c_str(), response);
+    snprintf(detail, sizeof(detail), "{\"name\":\"%s\",\"size\":%u}", LOG_NAME, (unsigned)file.size());
+    ok &= report("list", response.code == 200 && response.body.front() == '[' && response.body.back() == ']' &&
+                 response.body.find(detail) != std::string::npos &&
+                 response.body.find("log_900.csv") != std::string::npos, response, "");
+
+    // The whole file, chunked
+    double seconds;
+    snprintf(target, sizeof(target), "/logs?file=%s", LOG_NAME);
+    ok &= fetch(port, getRequest(target).c_str(), response, &seconds);
+    snprintf(detail, sizeof(detail), "; %u chunks of up to %u bytes, %.1f MB/s on loopback",
+             (unsigned)response.chunks, (unsigned)response.largestChunk, file.size() / seconds / 1e6);
+    ok &= report("full (chunked)", response.code == 200 && response.chunked && response.body == file &&
+                 response.largestChunk <= HTTP_RESPONSE_BUFFER_SIZE, response, detail);
+
+    // Interrupted at a third, resumed from there with an open range
+    size_t cut = file.size() / 3;
+    snprintf(headers, sizeof(headers), "Range: bytes=0-%u\r\n", (unsigned)cut - 1);
+    ok &= fetch(port, getRequest(target, headers).c_str(), response);
+    std::string resumed = response.body;
+    ok &= report("first third (206)", response.code == 206 && response.body == file.substr(0, cut) &&
+                 headerValue(response.headers, "Content-Range") ==
+                 "bytes 0-" + std::to_string(cut - 1) + "/" + std::to_string(file.size()), response);
+    snprintf(headers, sizeof(headers), "Range: bytes=%u-\r\n", (unsigned)cut);
+    ok &= fetch(port, getRequest(target, headers).c_str(), response);
+    resumed += response.body;
+    ok &= report("resumed (206)", response.code == 206 && resumed == file, response);
+
+    // Incremental sync: only what the logger appended since
+    size_t synced = file.size();
+    writeLog(path, 600);
+    file = contents(path);
+    snprintf(headers, sizeof(headers), "Range: bytes=%u-\r\n", (unsigned)synced);
+    ok &= fetch(port, getRequest(target, headers).c_str(), response);
+    ok &= report("appended since sync", response.code == 206 && response.body == file.substr(synced), response);
+
+    // Suffix, beyond the end, and several ranges (answered whole)
+    ok &= fetch(port, getRequest(target, "Range: bytes=-700\r\n").c_str(), response);
+    ok &= report("last 700 bytes (206)", response.code == 206 && response.body == file.substr(file.size() - 700),
+                 response);
+    snprintf(headers, sizeof(headers), "Range: bytes=%u-\r\n", (unsigned)file.size());
+    ok &= fetch(port, getRequest(target, headers).c_str(), response);
+    ok &= report("past the end (416)", response.code == 416 &&
+                 headerValue(response.headers, "Content-Range") == "bytes */" + std::to_string(file.size()),
+                 response);
+    ok &= fetch(port, getRequest(target, "Range: bytes=0-9,20-29\r\n").c_str(), response);
+    ok &= report("two ranges (200)", response.code == 200 && response.body == file, response);
+
+    // HTTP/1.0 has no chunks: the body ends with the connection
+    snprintf(headers, sizeof(headers), "GET %s HTTP/1.0\r\n\r\n", target);
+    ok &= fetch(port, headers, response);
+    ok &= report("HTTP/1.0 (close)", response.code == 200 && !response.chunked && response.body == file, response);
+
+    // Decoded on the fly
+    snprintf(target, sizeof(target), "/logs?file=%s&format=csv", LOG_NAME);
+    ok &= fetch(port, getRequest(target).c_str(), response);
+    std::string csv = decodeToCsv(file);
+    snprintf(detail, sizeof(detail), "; exportToCSV() held %u bytes", (unsigned)csv.size());
+    ok &= report("CSV (chunked)", response.code == 200 && response.chunked && response.body == csv, response,
+                 detail);
+
+    // Two streams back to back on one keep-alive connection
+    {
+        snprintf(target, sizeof(target), "/logs?file=%s", LOG_NAME);
+        std::string requests = getRequest(target, "Range: bytes=100-199\r\n") + getRequest(target);
+        Response first;
+        first.headers.reserve(1024);
+        first.body.reserve(1 << 20);
+        size_t idle = heapLiveBytes();
+        heapResetPeak();
+        int fd = connectLoopback(port, 5);
+        Reader reader(fd);
+        bool sent = send(fd, requests.data(), requests.size(), MSG_NOSIGNAL) == (ssize_t)requests.size();
+        bool pipelined = sent && receive(reader, false, first) && receive(reader, false, response);
+        close(fd);
+        response.peakHeap = heapPeakBytes() - idle;
+        ok &= report("pipelined range + full", pipelined && first.code == 206 &&
+                     first.body == file.substr(100, 100) && response.code == 200 && response.body == file, response);
+    }
+
+    // Names that are not logs never reach the filesystem
+    ok &= fetch(port, getRequest("/logs?file=..%2Fconfig.json").c_str(), response);
+    ok &= report("bad name (400)", response.code == 400, response);
+    ok &= fetch(port, getRequest("/logs?file=log_1.bin").c_str(), response);
+    ok &= report("missing (404)", response.code == 404, response);
+
+    SimHal::tcpServer().end();
+    printf("check                 : %s\n", ok ? "all downloads match the file" : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,175 @@
+// MQTT telemetry through a three-hour cook with two broker outages, against
+// the in-process broker: what arrives, what is lost, and what batching
+// saves over publishing each value on its own topic.
+//
+// The cook is started and retargeted over MQTT_TOPIC_COMMAND. The first
+// outage fits the offline ring, the second is longer than it. Every
+// telemetry message is checked afterwards: sequence numbers must run
+// without gaps except where the ring overwrote samples, and every sample
+// taken must be delivered, dropped or still buffered.
+
+#include "../include/Benchmarks.h"
+#include "../include/SimHal.h"
+#include "../include/WaterBath.h"
+#include "../../include/StateMachine.h"
+#include "../../include/MqttClient.h"
+#include <PubSubClient.h>
+#include <string>
+
+// Firmware entry points and state from SC_ESP32.ino, linked in through main.cpp
+void setup();
+void loop();
+extern StateMachine stateMachine;
+extern CommandBus commandBus;
+extern MqttClient mqttClient;
+
+static const unsigned long RUN_MINUTES = 180;
+
+struct Outage {
+    unsigned long from;     // minutes into the run
+    unsigned long until;
+};
+
+static const Outage OUTAGES[] = {
+    {30, 50},       // 20 min, inside the ring
+    {80, 125},      // 45 min, longer than the ring
+};
+
+// MQTT 3.1.1 PUBLISH at QoS 0: fixed header, remaining length, topic length
+static unsigned long packetBytes(size_t topicLength, size_t payloadLength) {
+    unsigned long remaining = 2 + topicLength + payloadLength;
+    unsigned long lengthBytes = remaining < 128 ? 1 : remaining < 16384 ? 2 : 3;
+    return 1 + lengthBytes + remaining;
+}
+
+// Comma-separated values of "name":[...] in a batch, or empty
+static std::string column(const String& payload, const char* name) {
+    std::string text = payload.c_str();
+    std::string key = std::string("\"") + name + "\":[";
+    size_t start = text.find(key);
+    if (start == std::string::npos) return "";
+    start += key.length();
+    size_t end = text.find(']', start);
+    return end == std::string::npos ? "" : text.substr(start, end - start);
+}
+
+// Value count, and the summed text lengths of the values
+static size_t countValues(const std::string& values, size_t& textLength) {
+    size_t count = 0;
+    textLength = 0;
+    size_t start = 0;
+    while (start < values.length()) {
+        size_t comma = values.find(',', start);
+        if (comma == std::string::npos) comma = values.length();
+        textLength += comma - start;
+        count++;
+        start = comma + 1;
+    }
+    return count;
+}
+
+int benchmarkMqtt() {
+    Serial.mute(true);
+    MqttBroker& broker = MqttBroker::instance();
+
+    WaterBath::Parameters params = WaterBath::defaultParameters();
+    WaterBath bath(params);
+    SimHal::oneWire().setTemperature(params.sensorIndex, params.initialTemp);
+    bath.attach();
+    setup();
+    mqttClient.begin(&commandBus);
+
+    // Commands published before the subscription are lost, as on a broker
+    while (!mqttClient.isConnected()) {
+        loop();
+    }
+    broker.publish(MQTT_TOPIC_COMMAND, "target=56");
+    broker.publish(MQTT_TOPIC_COMMAND, "time=10800");
+    broker.publish(MQTT_TOPIC_COMMAND, "start");
+
+    unsigned long start = HAL::clock().millis();
+    bool retargeted = false;
+    bool retargetApplied = false;
+    bool cooked = false;
+    while (HAL::clock().millis() - start < RUN_MINUTES * 60000) {
+        unsigned long minute = (HAL::clock().millis() - start) / 60000;
+        bool online = true;
+        for (const Outage& outage : OUTAGES) {
+            if (minute >= outage.from && minute < outage.until) online = false;
+        }
+        if (online != broker.isOnline()) broker.setOnline(online);
+
+        if (!retargeted && minute >= 60) {
+            broker.publish(MQTT_TOPIC_COMMAND, "target=57");
+            retargeted = true;
+        }
+        loop();
+        cooked |= stateMachine.getCurrentState() == STATE_COOKING;
+        if (retargeted && !retargetApplied) {
+            retargetApplied = stateMachine.getCookingParameters().targetTemperature == 57.0f;
+        }
+    }
+    // Let the backlog of the second outage drain
+    for (int i = 0; i < 1000 && mqttClient.getBacklog() >= MQTT_BATCH_SIZE; i++) {
+        loop();
+    }
+
+    // Check and account every telemetry message
+    unsigned long telemetryMessages = 0, telemetryBytes = 0, delivered = 0, gap = 0;
+    unsigned long otherMessages = 0, otherBytes = 0;
+    unsigned long unbatchedBytes = 0;
+    unsigned long expectedSequence = 0;
+    bool ordered = true;
+    for (const MqttBroker::Message& message : broker.getLog()) {
+        if (message.topic == MQTT_TOPIC_COMMAND) continue;
+        if (message.topic != MQTT_TOPIC_TELEMETRY) {
+            otherMessages++;
+            otherBytes += packetBytes(message.topic.length(), message.payload.length());
+            continue;
+        }
+
+        const char* sequenceField = strstr(message.payload.c_str(), "\"seq\":");
+        unsigned long sequence = sequenceField != nullptr ? strtoul(sequenceField + 6, nullptr, 10) : 0;
+        if (sequence < expectedSequence) ordered = false;
+        gap += sequence - expectedSequence;
+
+        size_t textLength;
+        size_t samples = countValues(column(message.payload, "t"), textLength);
+        const char* topics[] = {MQTT_TOPIC_TEMP, MQTT_TOPIC_SETPOINT, "sousvide/power", MQTT_TOPIC_STATUS};
+        const char* names[] = {"temp", "target", "power", "state"};
+        for (int field = 0; field < 4; field++) {
+            // One message per value; the text lengths give the average payload
+            size_t count = countValues(column(message.payload, names[field]), textLength);
+            if (count != samples) ordered = false;
+            unbatchedBytes += count * packetBytes(strlen(topics[field]), 0) + textLength;
+        }
+
+        expectedSequence = sequence + samples;
+        delivered += samples;
+        telemetryMessages++;
+        telemetryBytes += packetBytes(message.topic.length(), message.payload.length());
+    }
+
+    MqttClient::Stats stats = mqttClient.getStats();
+    bool accounted = ordered && gap == stats.samplesDropped &&
+                     delivered + stats.samplesDropped + mqttClient.getBacklog() == stats.samples;
+    unsigned long outageSamples = 0;
+    for (const Outage& outage : OUTAGES) {
+        outageSamples += (outage.until - outage.from) * 60000 / MQTT_SAMPLE_INTERVAL;
+    }
+
+    printf("run                   : %lu min, outages 30-50 and 80-125 min, ring %d samples (%lu bytes)\n",
+           RUN_MINUTES, MQTT_BUFFER_SAMPLES, (unsigned long)(MQTT_BUFFER_SAMPLES * 12));
+    printf("samples               : %lu taken, %lu delivered, %lu overwritten, %lu still buffered\n",
+           stats.samples, delivered, stats.samplesDropped, (unsigned long)mqttClient.getBacklog());
+    printf("without the ring      : %lu samples would have been lost\n", outageSamples);
+    printf("sequence check        : %s (gaps %lu samples)\n", accounted ? "every sample accounted for" : "FAILED", gap);
+    printf("batched telemetry     : %lu messages, %lu bytes (%d samples each)\n",
+           telemetryMessages, telemetryBytes, MQTT_BATCH_SIZE);
+    printf("one value per message : %lu messages, %lu bytes\n", delivered * 4, unbatchedBytes);
+    printf("retained state topics : %lu messages, %lu bytes\n", otherMessages, otherBytes);
+    printf("connects              : %lu\n", stats.connects);
+    printf("commands              : %lu accepted, cook %s, retarget to 57 C %s\n", stats.commands,
+           cooked ? "ran" : "did NOT run", retargetApplied ? "applied" : "NOT applied");
+    return accounted && cooked && retargetApplied ? 0 : 1;
+}
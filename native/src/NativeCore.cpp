@@ -0,0 +1,82 @@
+#include <Arduino.h>
+#include <Wire.h>
+#include <WiFi.h>
+#include <stdarg.h>
+#include "../../include/HAL.h"
+
+// Globals and out-of-line pieces of the native Arduino stand-in
+
+HardwareSerial Serial;
+TwoWire Wire;
+WiFiClass WiFi;
+
+size_t Print::printf(const char* format, ...) {
+    char text[256];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    if (length < 0) return 0;
+    if (length >= (int)sizeof(text)) length = sizeof(text) - 1;
+    return write((const uint8_t*)text, length);
+}
+
+TwoWire::TwoWire() {
+    txAddress = 0;
+    txLength = 0;
+    rxLength = 0;
+    rxIndex = 0;
+}
+
+bool TwoWire::begin(int sda, int scl, uint32_t frequency) {
+    if (frequency > 0) {
+        HAL::i2c().setClock(frequency);
+    }
+    return HAL::i2c().begin(sda, scl);
+}
+
+void TwoWire::setClock(uint32_t frequency) {
+    HAL::i2c().setClock(frequency);
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+    txAddress = address;
+    txLength = 0;
+}
+
+size_t TwoWire::write(uint8_t data) {
+    if (txLength >= BUFFER_LENGTH) return 0;
+    txBuffer[txLength++] = data;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t length) {
+    size_t written = 0;
+    while (written < length && write(data[written])) {
+        written++;
+    }
+    return written;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+    (void)sendStop;
+    uint8_t result = HAL::i2c().write(txAddress, txBuffer, txLength);
+    txLength = 0;
+    return result;
+}
+
+size_t TwoWire::requestFrom(uint8_t address, size_t length, bool sendStop) {
+    (void)sendStop;
+    if (length > BUFFER_LENGTH) length = BUFFER_LENGTH;
+    rxLength = HAL::i2c().read(address, rxBuffer, length);
+    rxIndex = 0;
+    return rxLength;
+}
+
+int TwoWire::available() {
+    return (int)(rxLength - rxIndex);
+}
+
+int TwoWire::read() {
+    return rxIndex < rxLength ? rxBuffer[rxIndex++] : -1;
+}
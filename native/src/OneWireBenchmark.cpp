@@ -0,0 +1,91 @@
+// 1-Wire bus time per loop() iteration with three probes: the former
+// broadcast-and-read-all update against TemperatureSensor's scheduler.
+// Bus time is the standard-speed duration SimOneWire accounts for each
+// transaction; the loop runs every millisecond of virtual time.
+
+#include "../include/Benchmarks.h"
+#include "../include/SimHal.h"
+#include "../../include/TemperatureSensor.h"
+
+static const int PROBE_COUNT = 3;
+static const unsigned long RUN_TIME = 60000;    // ms
+
+struct BusProfile {
+    uint64_t worstLoop;         // us of bus time in the busiest iteration
+    uint64_t total;
+    unsigned long transactions;
+};
+
+static void setupProbes() {
+    SimHal::reset();
+    SimOneWire& bus = SimHal::oneWire();
+    bus.clearDevices();
+    for (int i = 0; i < PROBE_COUNT; i++) {
+        bus.addDevice(50.0 + i);
+    }
+}
+
+template <typename Step>
+static BusProfile profile(Step step) {
+    SimOneWire& bus = SimHal::oneWire();
+    bus.resetCounters();
+
+    BusProfile result = {0, 0, 0};
+    for (unsigned long t = 0; t < RUN_TIME; t++) {
+        uint64_t before = bus.getBusMicros();
+        step();
+        result.worstLoop = max(result.worstLoop, bus.getBusMicros() - before);
+        SimHal::clock().advance(1);
+    }
+    result.total = bus.getBusMicros();
+    result.transactions = bus.getTransactions();
+    return result;
+}
+
+static void report(const char* name, const BusProfile& result) {
+    printf("%-22s: worst loop %5.1f ms, %5.1f ms/s on the bus, %lu transactions\n", name,
+           result.worstLoop / 1000.0, result.total / 1000.0 / (RUN_TIME / 1000),
+           result.transactions);
+}
+
+int benchmarkOneWire() {
+    // Previous update(): every interval read each probe's scratchpad, then
+    // broadcast the next conversion; hasError() added a presence check
+    setupProbes();
+    SimOneWire& bus = SimHal::oneWire();
+    bus.begin(ONE_WIRE_BUS);
+    bus.setWaitForConversion(false);
+    OneWireAddress addresses[PROBE_COUNT];
+    for (int i = 0; i < PROBE_COUNT; i++) {
+        bus.getAddress(addresses[i], i);
+    }
+    unsigned long lastRead = 0;
+    BusProfile broadcast = profile([&]() {
+        unsigned long now = HAL::clock().millis();
+        if (now - lastRead >= TEMP_READ_INTERVAL) {
+            for (int i = 0; i < PROBE_COUNT; i++) {
+                bus.getTempC(addresses[i]);
+            }
+            bus.requestTemperatures();
+            bus.isConnected(addresses[SENSOR_BATH]);
+            lastRead = now;
+        }
+    });
+
+    setupProbes();
+    TemperatureSensor sensor;
+    for (int i = 0; i < PROBE_COUNT; i++) {
+        sensor.setRoleAddress(i, bus.getDevice(i).address);
+    }
+    sensor.begin();
+    BusProfile scheduled = profile([&]() {
+        sensor.update();
+        sensor.hasError();
+    });
+
+    printf("probes                : %d, %d-bit, %d ms interval\n", PROBE_COUNT, TEMP_RESOLUTION,
+           TEMP_READ_INTERVAL);
+    report("broadcast + read all", broadcast);
+    report("scheduled", scheduled);
+    return 0;
+}
@@ -0,0 +1,127 @@
+// Cycles per PID sample: PIDController::compute() against PIDCore<float>
+// and PIDCore<Q16_16> on the same input sequence, with the firmware's
+// default gains and a 1 s sample period.
+
+#include "../include/Benchmarks.h"
+#include "../include/SimHal.h"
+#include "../../include/PIDController.h"
+#include "../../include/PIDCore.h"
+
+static const int INPUT_COUNT = 4096;        // power of two, indexed with a mask
+static const long ITERATIONS = 2000000;
+
+typedef PIDCore<float, PID_SAMPLE_TIME> FloatPID;
+typedef PIDCore<Q16_16, PID_SAMPLE_TIME> FixedPID;
+
+static float floatInputs[INPUT_COUNT];
+static Q16_16 fixedInputs[INPUT_COUNT];
+
+static void makeInputs() {
+    // Slow oscillation around the setpoint, quantized like a 12-bit DS18B20
+    for (int i = 0; i < INPUT_COUNT; i++) {
+        float value = DEFAULT_TARGET_TEMP + 0.8f * sinf(i * 0.01f) + 0.2f * sinf(i * 0.37f);
+        value = roundf(value * 16) / 16;
+        floatInputs[i] = value;
+        fixedInputs[i] = Q16_16::fromFloat(value);
+    }
+}
+
+// Ticks for ITERATIONS of advancing the virtual clock alone, subtracted
+// from the PIDController run which needs millis() to move
+static double clockOverhead() {
+    uint64_t start = benchmarkTicks();
+    for (long i = 0; i < ITERATIONS; i++) {
+        SimHal::clock().advance(PID_SAMPLE_TIME);
+    }
+    return (double)(benchmarkTicks() - start);
+}
+
+struct GainSet {
+    const char* name;
+    float kp, ki, kd;
+};
+
+// Firmware defaults and the gains the relay auto-tuner finds on the
+// simulated 10 L bath (not binary fractions, so rounding shows)
+static const GainSet GAIN_SETS[] = {
+    {"default", DEFAULT_KP, DEFAULT_KI, DEFAULT_KD},
+    {"tuned", 84.196f, 1.18481f, 3988.773f},
+};
+
+static void benchmarkGains(const GainSet& gains, double overhead) {
+    const float setpoint = DEFAULT_TARGET_TEMP;
+    volatile float floatSink = 0;
+    volatile int32_t fixedSink = 0;
+
+    PIDController controller;
+    controller.begin(gains.kp, gains.ki, gains.kd);
+    controller.setOutputLimits(0, 100);
+    controller.enableAntiWindup(true);
+    controller.setSetpoint(setpoint);
+
+    uint64_t start = benchmarkTicks();
+    for (long i = 0; i < ITERATIONS; i++) {
+        SimHal::clock().advance(PID_SAMPLE_TIME);
+        floatSink = controller.compute(floatInputs[i & (INPUT_COUNT - 1)]);
+    }
+    double controllerTicks = (benchmarkTicks() - start - overhead) / ITERATIONS;
+
+    FloatPID floatCore;
+    floatCore.setTunings(gains.kp, gains.ki, gains.kd);
+    start = benchmarkTicks();
+    for (long i = 0; i < ITERATIONS; i++) {
+        floatSink = floatCore.compute(setpoint, floatInputs[i & (INPUT_COUNT - 1)]);
+    }
+    double floatTicks = (double)(benchmarkTicks() - start) / ITERATIONS;
+
+    FixedPID fixedCore;
+    fixedCore.setTunings(gains.kp, gains.ki, gains.kd);
+    Q16_16 fixedSetpoint = Q16_16::fromFloat(setpoint);
+    start = benchmarkTicks();
+    for (long i = 0; i < ITERATIONS; i++) {
+        fixedSink = fixedCore.compute(fixedSetpoint, fixedInputs[i & (INPUT_COUNT - 1)]).getRaw();
+    }
+    double fixedTicks = (double)(benchmarkTicks() - start) / ITERATIONS;
+
+    // Agreement of the fixed-point engine with the float one
+    FloatPID floatCheck;
+    FixedPID fixedCheck;
+    floatCheck.setTunings(gains.kp, gains.ki, gains.kd);
+    fixedCheck.setTunings(gains.kp, gains.ki, gains.kd);
+    float maxDifference = 0;
+    for (int i = 0; i < INPUT_COUNT; i++) {
+        float a = floatCheck.compute(setpoint, floatInputs[i]);
+        float b = fixedCheck.compute(fixedSetpoint, fixedInputs[i]).toFloat();
+        maxDifference = max(maxDifference, fabsf(a - b));
+    }
+    (void)floatSink;
+    (void)fixedSink;
+
+    printf("gains                 : %s (kp=%.3f ki=%.5f kd=%.3f)\n", gains.name, gains.kp, gains.ki, gains.kd);
+    printf("  PIDController       : %.1f %s/compute\n", controllerTicks, benchmarkTickUnit());
+    printf("  PIDCore<float>      : %.1f %s/compute\n", floatTicks, benchmarkTickUnit());
+    printf("  PIDCore<Q16_16>     : %.1f %s/compute\n", fixedTicks, benchmarkTickUnit());
+    printf("  Q16_16 vs float     : max output difference %.4f %%\n", maxDifference);
+}
+
+int benchmarkPid() {
+    makeInputs();
+    double overhead = clockOverhead();
+
+    printf("pid samples           : %ld per engine\n", ITERATIONS);
+    for (const GainSet& gains : GAIN_SETS) {
+        benchmarkGains(gains, overhead);
+    }
+
+    // Folded at a 10 ms period the tuned kd no longer fits Q16_16
+    const GainSet& tuned = GAIN_SETS[1];
+    PIDCore<Q16_16, 10> fastFixed;
+    PIDCore<float, 10> fastFloat;
+    bool rejected = !fastFixed.setTunings(tuned.kp, tuned.ki, tuned.kd) &&
+                    fastFloat.setTunings(tuned.kp, tuned.ki, tuned.kd);
+    bool saturates = Q16_16::fromInt(32000) + Q16_16::fromInt(32000) == Q16_16::fromRaw(INT32_MAX) &&
+                     Q16_16::fromInt(-32000) - Q16_16::fromInt(32000) == Q16_16::fromRaw(INT32_MIN);
+    printf("Q16_16 at 10 ms       : tuned gains %s (kd / dt = %.0f), add/subtract %s\n",
+           rejected ? "rejected" : "NOT REJECTED", tuned.kd / 0.01f, saturates ? "saturate" : "WRAP");
+    return rejected && saturates ? 0 : 1;
+}
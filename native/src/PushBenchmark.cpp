@@ -0,0 +1,69 @@
+// Dashboard traffic during a one-hour cook: the WebSocket push channel
+// against the 1 Hz /status polling it replaces.
+//
+// The firmware runs with the water bath plant. Eight viewers connect to
+// WEBSOCKET_PORT and one of them starts the cook over the socket. Polling is
+// counted as one request per viewer per second, each answered with a full
+// state snapshot behind a minimal WebServer response header.
+
+#include "../include/Benchmarks.h"
+#include "../include/SimHal.h"
+#include "../include/WaterBath.h"
+#include "../../include/StateMachine.h"
+#include <WebSocketsServer.h>
+
+// Firmware entry points and state from SC_ESP32.ino, linked in through main.cpp
+void setup();
+void loop();
+extern StateMachine stateMachine;
+
+static const uint8_t VIEWERS = WEBSOCKETS_SERVER_CLIENT_MAX;
+static const unsigned long COOK_SECONDS = 3600;
+static const char* POLL_HEADER =
+    "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: 80\r\nConnection: close\r\n\r\n";
+
+int benchmarkPush() {
+    Serial.mute(true);
+
+    WaterBath::Parameters params = WaterBath::defaultParameters();
+    WaterBath bath(params);
+    SimHal::oneWire().setTemperature(params.sensorIndex, params.initialTemp);
+    bath.attach();
+    setup();
+
+    WebSocketsServer* socket = WebSocketsServer::onPort(WEBSOCKET_PORT);
+    if (socket == nullptr) {
+        printf("no WebSocket server on port %d\n", WEBSOCKET_PORT);
+        return 1;
+    }
+    for (uint8_t num = 0; num < VIEWERS; num++) {
+        socket->connect(num);
+    }
+    socket->send(0, "target=56");
+    char cookTime[24];
+    snprintf(cookTime, sizeof(cookTime), "time=%lu", COOK_SECONDS);
+    socket->send(0, cookTime);
+    socket->send(0, "start");
+
+    unsigned long start = HAL::clock().millis();
+    unsigned long end = start + (COOK_SECONDS + 4 * 3600) * 1000;
+    while (HAL::clock().millis() < end && stateMachine.getCurrentState() != STATE_FINISHED) {
+        loop();
+    }
+    double seconds = (HAL::clock().millis() - start) / 1000.0;
+
+    const WebSocketsServer::ClientStats& viewer = socket->getClientStats(VIEWERS - 1);
+    unsigned long snapshotBytes = strlen("{\"state\":4,\"currentTemp\":56.0,\"targetTemp\":56.0,"
+                                         "\"remainingTime\":3600,\"power\":15}");
+    double polls = seconds;
+    double pollBytes = polls * (strlen(POLL_HEADER) + snapshotBytes);
+
+    printf("viewers               : %u, %.0f s from start to %s\n", VIEWERS, seconds,
+           stateMachine.getCurrentState() == STATE_FINISHED ? "finished" : "timeout");
+    printf("serializations        : %lu (one broadcast each)\n", socket->getBroadcasts() + 1);
+    printf("push per viewer       : %lu frames, %lu bytes, %.1f bytes/frame, %.2f frames/s\n",
+           viewer.frames, viewer.bytes, (double)viewer.bytes / viewer.frames, viewer.frames / seconds);
+    printf("polling per viewer    : %.0f requests, %.0f bytes\n", polls, pollBytes);
+    printf("last frame            : %s\n", viewer.lastFrame.c_str());
+    return stateMachine.getCurrentState() == STATE_FINISHED ? 0 : 1;
+}
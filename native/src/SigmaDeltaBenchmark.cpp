@@ -0,0 +1,152 @@
+// Heater energy delivered through a zero-cross SSR by the time-proportioning
+// window against sigma-delta burst firing, at bath holding power levels.
+//
+// The SSR is modelled as a zero-cross type: a half-cycle conducts when the
+// control pin is high at the zero crossing that starts it. Mains runs at
+// 50.2 Hz, off the ESP32 crystal, so the unsynchronized modes drift against
+// it. Reported per level: delivered duty, the worst lead or lag of delivered
+// energy against the commanded power (in ms at full power), and the
+// peak-to-peak swing of a 400 J/K heater element coupled to the water at
+// 50 W/K, the --heater-mass plant of the runner.
+
+#include "../include/Benchmarks.h"
+#include "../include/SimHal.h"
+#include "../../include/SSRControl.h"
+
+static const float MAINS_HZ = 50.2;
+static const unsigned long RUN_SECONDS = 200;
+static const float POWER_LEVELS[] = {0.3, 1.1, 2.7, 5.5, 12.3, 50};
+static const double HEATER_WATTS = 1000.0;
+static const double ELEMENT_CAPACITY = 400.0;  // J/K
+static const double ELEMENT_TRANSFER = 50.0;   // W/K
+
+struct Delivery {
+    double duty;            // %
+    double maxLeadMs;       // energy error, ms at full power
+    double elementSwing;    // °C peak to peak
+};
+
+enum Mode { WINDOW, SIGMA_DELTA, SIGMA_DELTA_SYNCED };
+
+static Delivery measure(Mode mode, float power) {
+    SimHal::reset();
+    SimClock& clock = SimHal::clock();
+    SimGpio& gpio = SimHal::gpio();
+    SimZeroCross& mains = SimHal::zeroCross();
+
+    mains.start(ZERO_CROSS_PIN, MAINS_HZ);
+    double halfCycle = mains.getHalfCycle() / 1e6;
+    uint64_t crossing = clock.nowUs() + mains.getHalfCycle();
+
+    unsigned long total = 0, conducted = 0;
+    double maxLead = 0;
+    double element = 0, low = 1e9, high = -1e9;   // °C above the water
+    clock.addListener([&](uint64_t from, uint64_t to) {
+        bool pin = gpio.getLevel(SSR_PIN);
+        for (; crossing >= from && crossing < to; crossing += mains.getHalfCycle()) {
+            total++;
+            if (pin) conducted++;
+            maxLead = max(maxLead, fabs(conducted - total * power / 100.0));
+
+            double heat = pin ? HEATER_WATTS : 0;
+            element += (heat - ELEMENT_TRANSFER * element) * halfCycle / ELEMENT_CAPACITY;
+            if (total * halfCycle > RUN_SECONDS / 2) {
+                low = min(low, element);
+                high = max(high, element);
+            }
+        }
+    });
+
+    SSRControl ssr;
+    ssr.setModulation(mode != WINDOW, mode == SIGMA_DELTA_SYNCED);
+    ssr.begin(SSR_PIN, true);
+    ssr.setPower(power);
+
+    // The alarms and zero crossings do the work; loop() only polls
+    uint64_t end = clock.nowUs() + RUN_SECONDS * 1000000ULL;
+    while (clock.nowUs() < end) {
+        ssr.update();
+        clock.advance(10);
+    }
+
+    Delivery result;
+    result.duty = conducted * 100.0 / total;
+    result.maxLeadMs = maxLead * halfCycle * 1000;
+    result.elementSwing = high - low;
+    return result;
+}
+
+// Zero-cross edges stopping while the pin is high, as with an unplugged
+// sense line: returns how long the pin stayed high, in us (-1 if it never
+// went low within a second), and whether decisions resumed on the edges
+// once they came back
+static long loseZeroCross(bool powerOff, bool& resumed) {
+    SimHal::reset();
+    SimClock& clock = SimHal::clock();
+    SimGpio& gpio = SimHal::gpio();
+    SimZeroCross& mains = SimHal::zeroCross();
+    mains.start(ZERO_CROSS_PIN, MAINS_HZ);
+
+    SSRControl ssr;
+    ssr.setModulation(true, true);
+    ssr.begin(SSR_PIN, true);
+    ssr.setPower(50);
+    while (!gpio.getLevel(SSR_PIN)) {
+        ssr.update();
+        clock.advanceMicros(100);
+    }
+
+    mains.stop();
+    uint64_t stopped = clock.nowUs();
+    if (powerOff) ssr.setPower(0);
+    long high = -1;
+    while (clock.nowUs() - stopped < 1000000) {
+        if (!gpio.getLevel(SSR_PIN)) {
+            high = (long)(clock.nowUs() - stopped);
+            break;
+        }
+        ssr.update();
+        clock.advanceMicros(100);
+    }
+
+    mains.start(ZERO_CROSS_PIN, MAINS_HZ);
+    for (int i = 0; i < 10000; i++) {
+        ssr.update();
+        clock.advanceMicros(100);
+    }
+    resumed = !ssr.isZeroCrossLost();
+    return high;
+}
+
+static void print(const Delivery& d) {
+    printf("  %7.3f %% %6.0f ms %5.2f C", d.duty, d.maxLeadMs, d.elementSwing);
+}
+
+int benchmarkSigmaDelta() {
+    Serial.mute(true);
+    printf("mains                 : %.1f Hz, zero-cross SSR, %lu s per level\n", MAINS_HZ, RUN_SECONDS);
+    printf("window                : %d ms; sigma-delta every %d cycle(s)\n", PID_WINDOW_SIZE, SSR_SIGMA_DELTA_CYCLES);
+    printf("             %-28s%-28s%s\n", "window", "sigma-delta", "sigma-delta on zero cross");
+    printf("commanded");
+    for (int i = 0; i < 3; i++) printf("     duty    lead  swing   ");
+    printf("\n");
+    for (float power : POWER_LEVELS) {
+        printf("%6.1f %%  ", power);
+        print(measure(WINDOW, power));
+        print(measure(SIGMA_DELTA, power));
+        print(measure(SIGMA_DELTA_SYNCED, power));
+        printf("\n");
+    }
+
+    // The pin must not outlive the edges by more than the watchdog timeout
+    long timeout = SSR_ZERO_CROSS_TIMEOUT * 500000L / MAINS_FREQUENCY;
+    bool resumedOn, resumedOff;
+    long heldOn = loseZeroCross(false, resumedOn);
+    long heldOff = loseZeroCross(true, resumedOff);
+    printf("zero cross lost       : pin high %.1f ms after the last edge at 50 %%, %.1f ms after setPower(0)\n",
+           heldOn / 1000.0, heldOff / 1000.0);
+    bool ok = heldOn >= 0 && heldOn <= timeout + 200 && heldOff == 0 && resumedOn && resumedOff;
+    printf("check                 : %s\n", ok ? "pin low within the watchdog timeout, synced again after"
+                                              : "FAILED");
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,691 @@
+#include "../include/SimHal.h"
+
+// ---------------------------------------------------------------------------
+// SimClock
+
+SimClock::SimClock() {
+    nowMicros = 0;
+}
+
+unsigned long SimClock::millis() {
+    return (unsigned long)(nowMicros / 1000);
+}
+
+unsigned long SimClock::micros() {
+    return (unsigned long)nowMicros;
+}
+
+void SimClock::delay(unsigned long ms) {
+    advance(ms);
+}
+
+void SimClock::advanceMicros(uint64_t us) {
+    uint64_t to = nowMicros + us;
+
+    // Stop at every event on the way, like an interrupt would
+    uint64_t due;
+    while (EventSource* source = nextSource(to, due)) {
+        advanceTo(due);
+        source->fireEvent();
+    }
+    advanceTo(to);
+}
+
+SimClock::EventSource* SimClock::nextSource(uint64_t limit, uint64_t& due) {
+    EventSource* earliest = nullptr;
+    for (EventSource* source : sources) {
+        uint64_t time;
+        if (source->nextEvent(time) && time <= limit && (earliest == nullptr || time < due)) {
+            earliest = source;
+            due = time;
+        }
+    }
+    return earliest;
+}
+
+void SimClock::addEventSource(EventSource* source) {
+    if (std::find(sources.begin(), sources.end(), source) == sources.end()) {
+        sources.push_back(source);
+    }
+}
+
+void SimClock::removeEventSource(EventSource* source) {
+    sources.erase(std::remove(sources.begin(), sources.end(), source), sources.end());
+}
+
+void SimClock::advanceTo(uint64_t to) {
+    uint64_t from = nowMicros;
+    if (to <= from) return;
+    nowMicros = to;
+    for (auto& listener : listeners) {
+        listener(from, to);
+    }
+}
+
+void SimClock::reset() {
+    nowMicros = 0;
+}
+
+void SimClock::addListener(AdvanceListener listener) {
+    listeners.push_back(listener);
+}
+
+void SimClock::clearListeners() {
+    listeners.clear();
+}
+
+// ---------------------------------------------------------------------------
+// SimTimer
+
+SimTimer::SimTimer() {
+    reset();
+}
+
+void SimTimer::begin(void (*handler)()) {
+    callback = handler;
+    SimHal::clock().addEventSource(this);
+}
+
+uint64_t SimTimer::nowMicros() {
+    return SimHal::clock().nowUs();
+}
+
+void SimTimer::alarmAt(uint64_t timeUs) {
+    alarm = timeUs;
+    armed = true;
+
+    // A past alarm fires at once, as the interrupt would on hardware;
+    // re-arming from inside the callback waits for the next advance
+    if (timeUs <= nowMicros() && !firing) {
+        fireEvent();
+    }
+}
+
+void SimTimer::cancel() {
+    armed = false;
+}
+
+bool SimTimer::nextEvent(uint64_t& dueMicros) {
+    dueMicros = std::max(alarm, nowMicros());
+    return armed;
+}
+
+void SimTimer::fireEvent() {
+    armed = false;
+    if (callback == nullptr) return;
+    firing = true;
+    fired++;
+    callback();
+    firing = false;
+}
+
+void SimTimer::reset() {
+    SimHal::clock().removeEventSource(this);
+    callback = nullptr;
+    alarm = 0;
+    armed = false;
+    firing = false;
+    fired = 0;
+}
+
+// ---------------------------------------------------------------------------
+// SimZeroCross
+
+SimZeroCross::SimZeroCross() {
+    pin = 0;
+    halfCycle = 10000;
+    next = 0;
+    running = false;
+}
+
+void SimZeroCross::start(uint8_t inputPin, float frequencyHz) {
+    pin = inputPin;
+    halfCycle = (uint64_t)(500000.0 / frequencyHz + 0.5);
+    next = SimHal::clock().nowUs() + halfCycle;
+    running = true;
+    SimHal::clock().addEventSource(this);
+}
+
+void SimZeroCross::stop() {
+    running = false;
+    SimHal::clock().removeEventSource(this);
+}
+
+bool SimZeroCross::nextEvent(uint64_t& dueMicros) {
+    dueMicros = next;
+    return running;
+}
+
+void SimZeroCross::fireEvent() {
+    next += halfCycle;
+    SimHal::gpio().setInput(pin, HIGH);
+    SimHal::gpio().setInput(pin, LOW);
+}
+
+// ---------------------------------------------------------------------------
+// SimGpio
+
+SimGpio::SimGpio() {
+    reset();
+}
+
+void SimGpio::pinMode(uint8_t pin, uint8_t mode) {
+    if (pin >= PIN_COUNT) return;
+    modes[pin] = mode;
+    if (mode == INPUT_PULLUP) {
+        levels[pin] = HIGH;
+    }
+}
+
+void SimGpio::digitalWrite(uint8_t pin, uint8_t value) {
+    if (pin >= PIN_COUNT) return;
+    levels[pin] = value ? HIGH : LOW;
+    writeCount[pin]++;
+}
+
+int SimGpio::digitalRead(uint8_t pin) {
+    if (pin >= PIN_COUNT) return LOW;
+    return levels[pin];
+}
+
+void SimGpio::attachInterrupt(uint8_t pin, void (*handler)(), int mode) {
+    if (pin >= PIN_COUNT) return;
+    handlers[pin] = handler;
+    interruptModes[pin] = mode;
+}
+
+void SimGpio::detachInterrupt(uint8_t pin) {
+    if (pin >= PIN_COUNT) return;
+    handlers[pin] = nullptr;
+}
+
+void SimGpio::setInput(uint8_t pin, uint8_t level) {
+    if (pin >= PIN_COUNT) return;
+    uint8_t previous = levels[pin];
+    levels[pin] = level ? HIGH : LOW;
+
+    if (handlers[pin] == nullptr || previous == levels[pin]) return;
+
+    bool rising = levels[pin] == HIGH;
+    int mode = interruptModes[pin];
+    if (mode == CHANGE || (mode == RISING && rising) || (mode == FALLING && !rising)) {
+        handlers[pin]();
+    }
+}
+
+uint8_t SimGpio::getLevel(uint8_t pin) {
+    return pin < PIN_COUNT ? levels[pin] : LOW;
+}
+
+uint8_t SimGpio::getMode(uint8_t pin) {
+    return pin < PIN_COUNT ? modes[pin] : 0;
+}
+
+unsigned long SimGpio::getWriteCount(uint8_t pin) {
+    return pin < PIN_COUNT ? writeCount[pin] : 0;
+}
+
+void SimGpio::reset() {
+    for (int i = 0; i < PIN_COUNT; i++) {
+        modes[i] = INPUT;
+        levels[i] = LOW;
+        handlers[i] = nullptr;
+        interruptModes[i] = 0;
+        writeCount[i] = 0;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// SimOneWire
+
+static uint8_t dallasCrc8(const uint8_t* data, uint8_t length) {
+    uint8_t crc = 0;
+    while (length--) {
+        uint8_t inbyte = *data++;
+        for (uint8_t i = 8; i; i--) {
+            uint8_t mix = (crc ^ inbyte) & 0x01;
+            crc >>= 1;
+            if (mix) crc ^= 0x8C;
+            inbyte >>= 1;
+        }
+    }
+    return crc;
+}
+
+SimOneWire::SimOneWire() {
+    busPin = 0;
+    waitForConversion = true;
+    chargeBusTime = false;
+    resetCounters();
+    addDevice(20.0);  // one probe at room temperature
+}
+
+SimOneWire::Device* SimOneWire::find(const OneWireAddress address) {
+    for (auto& device : devices) {
+        if (memcmp(device.address, address, sizeof(OneWireAddress)) == 0) {
+            return &device;
+        }
+    }
+    return nullptr;
+}
+
+void SimOneWire::completeConversions(unsigned long now) {
+    for (auto& device : devices) {
+        if (device.converting &&
+            now - device.conversionStart >= conversionTime(device.resolution)) {
+            device.latched = device.pending;
+            device.converting = false;
+        }
+    }
+}
+
+void SimOneWire::begin(uint8_t pin) {
+    busPin = pin;
+}
+
+int SimOneWire::getDeviceCount() {
+    int count = 0;
+    for (auto& device : devices) {
+        if (device.connected) count++;
+    }
+    return count;
+}
+
+bool SimOneWire::getAddress(OneWireAddress address, int index) {
+    int visible = 0;
+    for (auto& device : devices) {
+        if (!device.connected) continue;
+        if (visible++ == index) {
+            memcpy(address, device.address, sizeof(OneWireAddress));
+            return true;
+        }
+    }
+    return false;
+}
+
+void SimOneWire::startConversion(Device& device, unsigned long now) {
+    float temp = device.source ? device.source() : device.temperature;
+    device.pending = quantize(temp, device.resolution);
+    device.conversionStart = now;
+    device.converting = true;
+}
+
+void SimOneWire::transaction(int bytes) {
+    // Reset and presence pulse, then 8 time slots of about 70 us per byte
+    uint64_t duration = 960 + (uint64_t)bytes * 8 * 70;
+    transactions++;
+    busMicros += duration;
+    if (chargeBusTime) {
+        SimHal::clock().advanceMicros(duration);
+    }
+}
+
+void SimOneWire::resetCounters() {
+    transactions = 0;
+    busMicros = 0;
+}
+
+bool SimOneWire::isConnected(const OneWireAddress address) {
+    transaction(19);  // match ROM, read scratchpad
+    Device* device = find(address);
+    return device != nullptr && device->connected;
+}
+
+void SimOneWire::setResolution(const OneWireAddress address, uint8_t bits) {
+    transaction(13);  // match ROM, write scratchpad
+    Device* device = find(address);
+    if (device != nullptr) {
+        device->resolution = constrain(bits, 9, 12);
+    }
+}
+
+uint8_t SimOneWire::getResolution(const OneWireAddress address) {
+    transaction(19);
+    Device* device = find(address);
+    return device != nullptr ? device->resolution : 0;
+}
+
+void SimOneWire::setWaitForConversion(bool wait) {
+    waitForConversion = wait;
+}
+
+void SimOneWire::requestTemperatures() {
+    transaction(2);  // skip ROM, convert
+    unsigned long now = HAL::clock().millis();
+    unsigned long longest = 0;
+
+    for (auto& device : devices) {
+        if (!device.connected) continue;
+        startConversion(device, now);
+        longest = std::max(longest, conversionTime(device.resolution));
+    }
+
+    if (waitForConversion) {
+        HAL::clock().delay(longest);
+    }
+}
+
+bool SimOneWire::requestTemperature(const OneWireAddress address) {
+    transaction(10);  // match ROM, convert
+    Device* device = find(address);
+    if (device == nullptr || !device->connected) {
+        return false;
+    }
+    startConversion(*device, HAL::clock().millis());
+
+    if (waitForConversion) {
+        HAL::clock().delay(conversionTime(device->resolution));
+    }
+    return true;
+}
+
+float SimOneWire::getTempC(const OneWireAddress address) {
+    transaction(19);  // match ROM, read scratchpad
+    Device* device = find(address);
+    if (device == nullptr || !device->connected) {
+        return SENSOR_ERROR_TEMP;
+    }
+    completeConversions(HAL::clock().millis());
+    return device->latched;
+}
+
+int SimOneWire::addDevice(float initialTemperature) {
+    Device device;
+    device.address[0] = 0x28;  // DS18B20 family code
+    for (int i = 1; i < 7; i++) {
+        device.address[i] = (uint8_t)(0x10 * i + devices.size());
+    }
+    device.address[7] = dallasCrc8(device.address, 7);
+    device.resolution = 12;
+    device.connected = true;
+    device.temperature = initialTemperature;
+    device.latched = 85.0;  // DS18B20 power-on scratchpad value
+    device.pending = 85.0;
+    device.conversionStart = 0;
+    device.converting = false;
+
+    devices.push_back(device);
+    return devices.size() - 1;
+}
+
+void SimOneWire::setTemperature(int index, float temperature) {
+    devices[index].temperature = temperature;
+}
+
+void SimOneWire::setSource(int index, TemperatureSource source) {
+    devices[index].source = source;
+}
+
+void SimOneWire::setConnected(int index, bool connected) {
+    devices[index].connected = connected;
+}
+
+void SimOneWire::clearDevices() {
+    devices.clear();
+}
+
+unsigned long SimOneWire::conversionTime(uint8_t resolution) {
+    // 93.75 ms at 9 bits, doubling per extra bit (750 ms at 12 bits)
+    return 750 >> (12 - constrain(resolution, 9, 12));
+}
+
+float SimOneWire::quantize(float temperature, uint8_t resolution) {
+    float step = 0.0625f * (1 << (12 - constrain(resolution, 9, 12)));
+    return floorf(temperature / step) * step;
+}
+
+// ---------------------------------------------------------------------------
+// SimI2C
+
+SimI2C::SimI2C() {
+    frequency = 100000;
+    chargeBusTime = false;
+    resetCounters();
+    presentDevices[OLED_ADDRESS] = true;
+}
+
+bool SimI2C::begin(int sda, int scl) {
+    (void)sda;
+    (void)scl;
+    return true;
+}
+
+void SimI2C::setClock(uint32_t freq) {
+    if (freq > 0) frequency = freq;
+}
+
+uint8_t SimI2C::write(uint8_t address, const uint8_t* data, size_t length) {
+    (void)data;
+    transactions++;
+    if (presentDevices.find(address) == presentDevices.end()) {
+        return 2;  // address NACK
+    }
+    bytesWritten += length;
+    if (chargeBusTime) {
+        SimHal::clock().advanceMicros((uint64_t)(length + 1) * 9 * 1000000 / frequency);
+    }
+    return 0;
+}
+
+size_t SimI2C::read(uint8_t address, uint8_t* data, size_t length) {
+    transactions++;
+    if (presentDevices.find(address) == presentDevices.end()) {
+        return 0;
+    }
+    memset(data, 0, length);
+    return length;
+}
+
+void SimI2C::resetCounters() {
+    transactions = 0;
+    bytesWritten = 0;
+}
+
+// ---------------------------------------------------------------------------
+// SimFileSystem
+
+static const size_t FLASH_PAGE_SIZE = 256;
+static const unsigned long FLASH_PAGES_PER_SECTOR = 16;
+static const uint64_t FLASH_PAGE_PROGRAM_US = 700;      // W25Q32 tPP typical
+static const uint64_t FLASH_SECTOR_ERASE_US = 45000;    // W25Q32 tSE typical
+
+class SimFile : public HalFile {
+private:
+    std::shared_ptr<SimFileSystem::Blob> blob;
+    SimFileSystem* owner;
+    size_t offset;
+    size_t programmed;          // bytes already in flash
+    bool writable;
+    bool open;
+
+public:
+    SimFile(std::shared_ptr<SimFileSystem::Blob> data, SimFileSystem* fs, bool write, bool append)
+        : blob(data), owner(fs), offset(append ? data->size() : 0), programmed(offset),
+          writable(write), open(true) {}
+
+    size_t write(const uint8_t* buffer, size_t size) override {
+        if (!open || !writable) return 0;
+        size_t room = owner->totalBytes() - owner->usedBytes();
+        size_t growth = offset + size > blob->size() ? offset + size - blob->size() : 0;
+        if (growth > room) {
+            size -= growth - room;
+        }
+        if (offset + size > blob->size()) {
+            blob->resize(offset + size);
+        }
+        memcpy(blob->data() + offset, buffer, size);
+        offset += size;
+
+        // Pages filled by this write leave the cache
+        size_t filled = offset / FLASH_PAGE_SIZE * FLASH_PAGE_SIZE;
+        if (filled > programmed) {
+            owner->program((filled - programmed + FLASH_PAGE_SIZE - 1) / FLASH_PAGE_SIZE);
+            programmed = filled;
+        }
+        return size;
+    }
+
+    int read(uint8_t* buffer, size_t size) override {
+        if (!open) return -1;
+        size_t remaining = blob->size() - offset;
+        if (size > remaining) size = remaining;
+        memcpy(buffer, blob->data() + offset, size);
+        offset += size;
+        return (int)size;
+    }
+
+    int available() override { return open ? (int)(blob->size() - offset) : 0; }
+
+    bool seek(size_t position) override {
+        if (!open || position > blob->size()) return false;
+        offset = position;
+        return true;
+    }
+
+    size_t position() override { return offset; }
+    size_t size() override { return blob->size(); }
+    void flush() override {
+        if (!writable || offset <= programmed) return;
+        // The partial page is programmed now and again once it fills, and
+        // the index page is rewritten with the new size
+        size_t first = programmed / FLASH_PAGE_SIZE;
+        size_t last = (offset - 1) / FLASH_PAGE_SIZE;
+        owner->program(last - first + 2);
+        programmed = offset;
+    }
+
+    void close() override {
+        if (open) flush();
+        open = false;
+    }
+};
+
+SimFileSystem::SimFileSystem() {
+    capacity = 1378241;  // usable SPIFFS bytes of the default.csv partition
+    mounted = false;
+    chargeFlashTime = false;
+    resetCounters();
+}
+
+void SimFileSystem::program(unsigned long pages) {
+    uint64_t duration = pages * FLASH_PAGE_PROGRAM_US;
+    pagesProgrammed += pages;
+    pagesSinceErase += pages;
+    while (pagesSinceErase >= FLASH_PAGES_PER_SECTOR) {
+        pagesSinceErase -= FLASH_PAGES_PER_SECTOR;
+        sectorsErased++;
+        duration += FLASH_SECTOR_ERASE_US;
+    }
+    flashMicros += duration;
+    if (chargeFlashTime) {
+        SimHal::clock().advanceMicros(duration);
+    }
+}
+
+void SimFileSystem::resetCounters() {
+    pagesProgrammed = 0;
+    sectorsErased = 0;
+    pagesSinceErase = 0;
+    flashMicros = 0;
+}
+
+bool SimFileSystem::begin(bool formatOnFail) {
+    (void)formatOnFail;
+    mounted = true;
+    return true;
+}
+
+HalFile* SimFileSystem::open(const char* path, const char* mode) {
+    if (!mounted) return nullptr;
+
+    auto it = files.find(path);
+    if (mode[0] == 'r') {
+        if (it == files.end()) return nullptr;
+        return new SimFile(it->second, this, false, false);
+    }
+
+    if (it == files.end() || mode[0] == 'w') {
+        files[path] = std::make_shared<Blob>();
+        it = files.find(path);
+    }
+    return new SimFile(it->second, this, true, mode[0] == 'a');
+}
+
+bool SimFileSystem::exists(const char* path) {
+    return files.find(path) != files.end();
+}
+
+bool SimFileSystem::remove(const char* path) {
+    return files.erase(path) > 0;
+}
+
+void SimFileSystem::listFiles(std::function<void(const char* path, size_t size)> callback) {
+    for (auto& file : files) {
+        callback(file.first.c_str(), file.second->size());
+    }
+}
+
+size_t SimFileSystem::usedBytes() {
+    size_t used = 0;
+    for (auto& file : files) {
+        used += file.second->size();
+    }
+    return used;
+}
+
+size_t SimFileSystem::totalBytes() {
+    return capacity;
+}
+
+const SimFileSystem::Blob* SimFileSystem::getContents(const char* path) {
+    auto it = files.find(path);
+    return it == files.end() ? nullptr : it->second.get();
+}
+
+void SimFileSystem::format() {
+    files.clear();
+}
+
+// ---------------------------------------------------------------------------
+// Backend binding
+
+static SimClock simClock;
+static SimGpio simGpio;
+static SimOneWire simOneWire;
+static SimI2C simI2C;
+static SimFileSystem simFileSystem;
+static SimTimer simTimer;
+static SimZeroCross simZeroCross;
+static SimTcpServer simTcpServer;
+
+HalClock& HAL::clock() { return simClock; }
+HalGpio& HAL::gpio() { return simGpio; }
+HalOneWire& HAL::oneWire() { return simOneWire; }
+HalI2C& HAL::i2c() { return simI2C; }
+HalFileSystem& HAL::fs() { return simFileSystem; }
+HalTimer& HAL::timer() { return simTimer; }
+HalTcpServer& HAL::tcpServer() { return simTcpServer; }
+
+SimClock& SimHal::clock() { return simClock; }
+SimGpio& SimHal::gpio() { return simGpio; }
+SimOneWire& SimHal::oneWire() { return simOneWire; }
+SimI2C& SimHal::i2c() { return simI2C; }
+SimFileSystem& SimHal::fs() { return simFileSystem; }
+SimTimer& SimHal::timer() { return simTimer; }
+SimZeroCross& SimHal::zeroCross() { return simZeroCross; }
+SimTcpServer& SimHal::tcpServer() { return simTcpServer; }
+
+void SimHal::reset() {
+    simClock.clearListeners();
+    simClock.reset();
+    simZeroCross.stop();
+    simTimer.reset();
+    simGpio.reset();
+    simOneWire.clearDevices();
+    simOneWire.addDevice(20.0);
+    simOneWire.resetCounters();
+    simI2C.resetCounters();
+    simFileSystem.format();
+    simFileSystem.resetCounters();
+    simTcpServer.end();
+}
@@ -0,0 +1,70 @@
+#include "../../include/Tasks.h"
+#include <chrono>
+#include <pthread.h>
+#include <sched.h>
+#include <thread>
+
+// Host stand-in for the FreeRTOS tasks: a std::thread per PeriodicTask on
+// the steady clock. Priorities map onto SCHED_FIFO and cores onto CPU
+// affinity where the process is allowed to set them; otherwise the threads
+// run with default scheduling, which still separates control from UI work.
+
+typedef std::chrono::steady_clock TaskClock;
+
+static unsigned long elapsedMicros(TaskClock::time_point from, TaskClock::time_point to) {
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(to - from).count();
+}
+
+void PeriodicTask::entry(void* param) {
+    PeriodicTask* task = static_cast<PeriodicTask*>(param);
+    const auto period = std::chrono::milliseconds(task->periodMs);
+    auto release = TaskClock::now();
+    auto lastStart = release;
+    bool first = true;
+
+    while (task->running) {
+        auto start = TaskClock::now();
+        task->body();
+        auto end = TaskClock::now();
+        if (!first) {
+            task->record(elapsedMicros(lastStart, start), elapsedMicros(start, end));
+        }
+        lastStart = start;
+        first = false;
+
+        // vTaskDelayUntil(): next release on the grid, immediately if late
+        release += period;
+        std::this_thread::sleep_until(release);
+    }
+}
+
+bool PeriodicTask::start() {
+    if (running) return true;
+
+    running = true;
+    std::thread* thread = new std::thread(entry, this);
+
+    sched_param scheduling;
+    scheduling.sched_priority = sched_get_priority_min(SCHED_FIFO) + priority;
+    pthread_setschedparam(thread->native_handle(), SCHED_FIFO, &scheduling);
+
+    if (core >= 0 && (unsigned)core < std::thread::hardware_concurrency()) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(core, &cpus);
+        pthread_setaffinity_np(thread->native_handle(), sizeof(cpus), &cpus);
+    }
+
+    handle = thread;
+    return true;
+}
+
+void PeriodicTask::stop() {
+    running = false;
+    std::thread* thread = static_cast<std::thread*>(handle);
+    if (thread != nullptr) {
+        thread->join();
+        delete thread;
+        handle = nullptr;
+    }
+}
@@ -0,0 +1,178 @@
+#include "../include/SimHal.h"
+#include <arpa/inet.h>
+#include <chrono>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+// Loopback TCP for the native build: one thread owns every socket and makes
+// all listener calls, like the AsyncTCP task on the ESP32
+
+static uint64_t steadyMillis() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+SimTcpServer::SimTcpServer() {
+    loopback = false;
+    running = false;
+    listenFd = -1;
+    port = 0;
+    listener = nullptr;
+    thread = nullptr;
+    for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+        fds[i] = -1;
+        wantWrite[i] = false;
+        lastActivity[i] = 0;
+    }
+}
+
+SimTcpServer::~SimTcpServer() {
+    end();
+}
+
+bool SimTcpServer::begin(uint16_t requestedPort, Listener* handler) {
+    listener = handler;
+    port = requestedPort;
+    if (!loopback || running) return true;
+
+    listenFd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (listenFd < 0) return false;
+    int reuse = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    // Ephemeral port: the firmware's port 80 is privileged on a workstation
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    socklen_t length = sizeof(address);
+    if (bind(listenFd, (sockaddr*)&address, sizeof(address)) < 0 || listen(listenFd, 64) < 0 ||
+        getsockname(listenFd, (sockaddr*)&address, &length) < 0) {
+        ::close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+    port = ntohs(address.sin_port);
+
+    running = true;
+    thread = new std::thread(&SimTcpServer::run, this);
+    return true;
+}
+
+void SimTcpServer::end() {
+    running = false;
+    std::thread* worker = static_cast<std::thread*>(thread);
+    if (worker != nullptr) {
+        worker->join();
+        delete worker;
+        thread = nullptr;
+    }
+    for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+        if (fds[i] >= 0) {
+            ::close(fds[i]);
+            fds[i] = -1;
+        }
+    }
+    if (listenFd >= 0) {
+        ::close(listenFd);
+        listenFd = -1;
+    }
+}
+
+size_t SimTcpServer::write(int connection, const uint8_t* data, size_t length) {
+    if (connection < 0 || connection >= HTTP_MAX_CONNECTIONS || fds[connection] < 0) return 0;
+    ssize_t sent = send(fds[connection], data, length, MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (sent < 0) sent = 0;
+    if ((size_t)sent < length) {
+        wantWrite[connection] = true;
+    }
+    lastActivity[connection] = steadyMillis();
+    return (size_t)sent;
+}
+
+void SimTcpServer::close(int connection) {
+    if (connection < 0 || connection >= HTTP_MAX_CONNECTIONS || fds[connection] < 0) return;
+    drop(connection);
+}
+
+void SimTcpServer::drop(int connection) {
+    ::close(fds[connection]);
+    fds[connection] = -1;
+    wantWrite[connection] = false;
+    listener->onDisconnect(connection);
+}
+
+void SimTcpServer::run() {
+    pollfd polls[HTTP_MAX_CONNECTIONS + 1];
+    int owners[HTTP_MAX_CONNECTIONS + 1];
+    uint8_t buffer[1460];
+
+    while (running) {
+        int count = 0;
+        bool slotFree = false;
+        for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+            if (fds[i] < 0) {
+                slotFree = true;
+                continue;
+            }
+            polls[count] = {fds[i], (short)(POLLIN | (wantWrite[i] ? POLLOUT : 0)), 0};
+            owners[count++] = i;
+        }
+        // A full table leaves new clients in the accept backlog
+        if (slotFree) {
+            polls[count] = {listenFd, POLLIN, 0};
+            owners[count++] = -1;
+        }
+
+        if (poll(polls, count, 20) < 0 && errno != EINTR) break;
+        uint64_t now = steadyMillis();
+
+        for (int p = 0; p < count; p++) {
+            int id = owners[p];
+            if (id < 0) {
+                if (!(polls[p].revents & POLLIN)) continue;
+                int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK);
+                if (fd < 0) continue;
+                int noDelay = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+                for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+                    if (fds[i] < 0) {
+                        fds[i] = fd;
+                        wantWrite[i] = false;
+                        lastActivity[i] = now;
+                        listener->onConnect(i);
+                        break;
+                    }
+                }
+                continue;
+            }
+
+            if (fds[id] < 0 || polls[p].fd != fds[id]) continue;   // closed by a callback
+            if (polls[p].revents & POLLOUT) {
+                wantWrite[id] = false;
+                listener->onSent(id);
+            }
+            if (fds[id] >= 0 && (polls[p].revents & (POLLIN | POLLHUP | POLLERR))) {
+                ssize_t received = recv(fds[id], buffer, sizeof(buffer), 0);
+                if (received > 0) {
+                    lastActivity[id] = now;
+                    listener->onData(id, buffer, received);
+                } else if (received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+                    drop(id);
+                }
+            }
+        }
+
+        for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+            if (fds[i] >= 0 && now - lastActivity[i] > HTTP_IDLE_TIMEOUT) {
+                drop(i);
+            }
+        }
+    }
+}
@@ -0,0 +1,57 @@
+// Delivered SSR duty against commanded power, polled from loop() versus
+// driven by timer alarms, at the low power levels sous vide holds at.
+//
+// Runs on virtual time with loop() iterations as long as the ESP32's under
+// UI load: the 10 ms loop delay plus a 23 ms SSD1306 frame every 250 ms, a
+// 40 ms page request every second and a 30 ms SPIFFS flush every 10 s.
+
+#include "../include/Benchmarks.h"
+#include "../include/SimHal.h"
+#include "../../include/SSRControl.h"
+
+static const int WINDOWS_PER_LEVEL = 100;
+static const float POWER_LEVELS[] = {1, 2, 5, 10, 20, 50};
+
+static unsigned long loopDuration(unsigned long now) {
+    unsigned long duration = 10;
+    if (now % DISPLAY_UPDATE_INTERVAL < 10) duration += 23;
+    if (now % 1000 < 10) duration += 40;
+    if (now % 10000 < 10) duration += 30;
+    return duration;
+}
+
+// Delivered duty in percent for one power level
+static double measureDuty(bool useTimer, float power) {
+    SimHal::reset();
+    SimClock& clock = SimHal::clock();
+    SimGpio& gpio = SimHal::gpio();
+
+    uint64_t highMicros = 0;
+    clock.addListener([&](uint64_t from, uint64_t to) {
+        if (gpio.getLevel(SSR_PIN)) highMicros += to - from;
+    });
+
+    SSRControl ssr;
+    ssr.begin(SSR_PIN, useTimer);
+    ssr.setPower(power);
+
+    uint64_t end = clock.nowUs() + (uint64_t)WINDOWS_PER_LEVEL * PID_WINDOW_SIZE * 1000;
+    while (clock.nowUs() < end) {
+        ssr.update();
+        clock.advance(min((uint64_t)loopDuration(clock.millis()), (end - clock.nowUs()) / 1000 + 1));
+    }
+    return highMicros * 100.0 / (WINDOWS_PER_LEVEL * PID_WINDOW_SIZE * 1000.0);
+}
+
+int benchmarkSsr() {
+    Serial.mute(true);
+    printf("window                : %d ms, %d windows per level\n", PID_WINDOW_SIZE, WINDOWS_PER_LEVEL);
+    printf("commanded    polled            timer\n");
+    for (float power : POWER_LEVELS) {
+        double polled = measureDuty(false, power);
+        double timed = measureDuty(true, power);
+        printf("%6.1f %%   %7.3f %% (%+5.1f%%)  %7.3f %% (%+5.1f%%)\n", power,
+               polled, (polled - power) * 100 / power, timed, (timed - power) * 100 / power);
+    }
+    return 0;
+}
@@ -0,0 +1,212 @@
+// Cost of one /status document: WebInterface::serializeStatus() (JsonWriter
+// into a fixed buffer) against one snprintf() over the whole document and
+// against building it in a String, the way the old generateJSON() was
+// declared.
+//
+// Heap use is counted by the runner's global operator new (Benchmarks.h);
+// the native String wraps std::string, so every growth shows.
+// The worst-case document (every field at its widest) is checked against
+// STATUS_BUFFER_SIZE and the response buffer.
+
+#include "../include/Benchmarks.h"
+#include "../../include/WebInterface.h"
+
+static const long ITERATIONS = 200000;
+
+static ControlStatus typicalStatus() {
+    ControlStatus status = {};
+    status.timestamp = 5423710;
+    status.state = STATE_COOKING;
+    status.error = ERROR_NONE;
+    status.currentTemp = 56.0625f;
+    status.targetTemp = 56.0f;
+    status.coreTemp = SENSOR_ERROR_TEMP;
+    status.tempRate = 0.0004f;
+    status.activeSensors = 1;
+    status.sensorError = false;
+    status.cookingTime = 7200;
+    status.elapsedTime = 4210;
+    status.remainingTime = 2990;
+    status.power = 14.8f;
+    status.pidOutput = 14.83f;
+    status.feedForward = 12.2f;
+    status.kp = DEFAULT_KP;
+    status.ki = DEFAULT_KI;
+    status.kd = DEFAULT_KD;
+    status.pidAutoMode = true;
+    status.ssrEnabled = true;
+    status.ssrSafetyLocked = false;
+    return status;
+}
+
+static ControlStatus widestStatus() {
+    ControlStatus status = typicalStatus();
+    status.timestamp = 4294967295UL;
+    status.state = STATE_AUTOTUNE;
+    status.error = ERROR_MEMORY_FULL;
+    status.currentTemp = -127.0625f;
+    status.targetTemp = -127.0625f;
+    status.coreTemp = -126.9375f;
+    status.tempRate = -10.1234f;
+    status.activeSensors = 255;
+    status.sensorError = true;
+    status.cookingTime = 4294967295UL;
+    status.elapsedTime = 4294967295UL;
+    status.remainingTime = 4294967295UL;
+    status.power = 100.0f;
+    status.pidOutput = -100.0f;
+    status.feedForward = -100.0f;
+    status.kp = 9999.999f;
+    status.ki = 999.99999f;
+    status.kd = 99999.999f;
+    status.pidAutoMode = false;
+    status.ssrSafetyLocked = false;
+    return status;
+}
+
+static size_t serializeSnprintf(const ControlStatus& s, char* buffer, size_t size) {
+    char core[16];
+    if (s.coreTemp == SENSOR_ERROR_TEMP) {
+        strcpy(core, "null");
+    } else {
+        snprintf(core, sizeof(core), "%.2f", s.coreTemp);
+    }
+    int length = snprintf(buffer, size,
+        "{\"timestamp\":%lu,\"state\":%d,\"error\":%d,\"currentTemp\":%.2f,\"targetTemp\":%.2f,"
+        "\"coreTemp\":%s,\"tempRate\":%.4f,\"cookingTime\":%lu,\"elapsedTime\":%lu,\"remainingTime\":%lu,"
+        "\"power\":%.1f,\"sensors\":{\"active\":%u,\"error\":%s},\"pid\":{\"auto\":%s,\"output\":%.1f,"
+        "\"feedForward\":%.1f,\"kp\":%.3f,\"ki\":%.5f,\"kd\":%.3f},\"ssr\":{\"enabled\":%s,\"safetyLocked\":%s}}",
+        s.timestamp, (int)s.state, (int)s.error, s.currentTemp, s.targetTemp, core, s.tempRate,
+        s.cookingTime, s.elapsedTime, s.remainingTime, s.power, (unsigned)s.activeSensors,
+        s.sensorError ? "true" : "false", s.pidAutoMode ? "true" : "false", s.pidOutput, s.feedForward,
+        s.kp, s.ki, s.kd, s.ssrEnabled ? "true" : "false", s.ssrSafetyLocked ? "true" : "false");
+    return length > 0 && (size_t)length < size ? length : 0;
+}
+
+static String serializeString(const ControlStatus& s) {
+    String json = "{\"timestamp\":";
+    json += String(s.timestamp);
+    json += ",\"state\":";
+    json += String((int)s.state);
+    json += ",\"error\":";
+    json += String((int)s.error);
+    json += ",\"currentTemp\":";
+    json += String(s.currentTemp, 2);
+    json += ",\"targetTemp\":";
+    json += String(s.targetTemp, 2);
+    json += ",\"coreTemp\":";
+    json += s.coreTemp == SENSOR_ERROR_TEMP ? String("null") : String(s.coreTemp, 2);
+    json += ",\"tempRate\":";
+    json += String(s.tempRate, 4);
+    json += ",\"cookingTime\":";
+    json += String(s.cookingTime);
+    json += ",\"elapsedTime\":";
+    json += String(s.elapsedTime);
+    json += ",\"remainingTime\":";
+    json += String(s.remainingTime);
+    json += ",\"power\":";
+    json += String(s.power, 1);
+    json += ",\"sensors\":{\"active\":";
+    json += String((unsigned int)s.activeSensors);
+    json += ",\"error\":";
+    json += s.sensorError ? "true" : "false";
+    json += "},\"pid\":{\"auto\":";
+    json += s.pidAutoMode ? "true" : "false";
+    json += ",\"output\":";
+    json += String(s.pidOutput, 1);
+    json += ",\"feedForward\":";
+    json += String(s.feedForward, 1);
+    json += ",\"kp\":";
+    json += String(s.kp, 3);
+    json += ",\"ki\":";
+    json += String(s.ki, 5);
+    json += ",\"kd\":";
+    json += String(s.kd, 3);
+    json += "},\"ssr\":{\"enabled\":";
+    json += s.ssrEnabled ? "true" : "false";
+    json += ",\"safetyLocked\":";
+    json += s.ssrSafetyLocked ? "true" : "false";
+    json += "}}";
+    return json;
+}
+
+struct Result {
+    size_t bytes;
+    double microseconds;
+    double ticks;
+    double allocations;
+};
+
+template <typename Serialize>
+static Result measure(Serialize serialize) {
+    // Two statuses alternate so nothing can be hoisted out of the loop
+    ControlStatus statuses[2] = {typicalStatus(), typicalStatus()};
+    statuses[1].currentTemp = 56.125f;
+    size_t bytes = 0;
+
+    unsigned long allocationsBefore = heapAllocations();
+    auto wallStart = std::chrono::steady_clock::now();
+    uint64_t start = benchmarkTicks();
+    for (long i = 0; i < ITERATIONS; i++) {
+        bytes = serialize(statuses[i & 1]);
+    }
+    uint64_t ticks = benchmarkTicks() - start;
+    double nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - wallStart).count();
+
+    return Result{bytes, nanoseconds / 1000.0 / ITERATIONS, (double)ticks / ITERATIONS,
+                  (double)(heapAllocations() - allocationsBefore) / ITERATIONS};
+}
+
+static void print(const char* name, const Result& result) {
+    printf("%-22s: %3u bytes, %6.2f us, %7.0f %s, %5.1f heap allocations per document\n",
+           name, (unsigned)result.bytes, result.microseconds, result.ticks, benchmarkTickUnit(),
+           result.allocations);
+}
+
+int benchmarkStatus() {
+    static char buffer[STATUS_BUFFER_SIZE];
+    volatile char sink = 0;
+
+    Result writer = measure([&](const ControlStatus& status) {
+        size_t length = WebInterface::serializeStatus(status, buffer, sizeof(buffer));
+        sink = buffer[length / 2];
+        return length;
+    });
+    Result formatted = measure([&](const ControlStatus& status) {
+        size_t length = serializeSnprintf(status, buffer, sizeof(buffer));
+        sink = buffer[length / 2];
+        return length;
+    });
+    Result string = measure([&](const ControlStatus& status) {
+        String json = serializeString(status);
+        sink = json.charAt(json.length() / 2);
+        return (size_t)json.length();
+    });
+    (void)sink;
+
+    // The three must agree byte for byte
+    ControlStatus status = typicalStatus();
+    char reference[STATUS_BUFFER_SIZE];
+    size_t length = WebInterface::serializeStatus(status, buffer, sizeof(buffer));
+    serializeSnprintf(status, reference, sizeof(reference));
+    bool same = strcmp(buffer, reference) == 0 && serializeString(status) == buffer;
+
+    ControlStatus widest = widestStatus();
+    size_t widestLength = WebInterface::serializeStatus(widest, buffer, sizeof(buffer));
+    char header[160];
+    size_t headerLength = snprintf(header, sizeof(header),
+                                   "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: %u\r\n"
+                                   "Connection: keep-alive\r\n\r\n", (unsigned)widestLength);
+
+    printf("documents             : %ld per serializer\n", ITERATIONS);
+    print("JsonWriter", writer);
+    print("snprintf", formatted);
+    print("String", string);
+    printf("identical output      : %s\n", same ? "yes" : "NO");
+    printf("widest document       : %u bytes of STATUS_BUFFER_SIZE %d; with headers %u of %d\n",
+           (unsigned)widestLength, STATUS_BUFFER_SIZE, (unsigned)(headerLength + widestLength),
+           HTTP_RESPONSE_BUFFER_SIZE);
+    printf("typical document      : %.*s\n", (int)length, reference);
+    return same && widestLength > 0 && headerLength + widestLength <= HTTP_RESPONSE_BUFFER_SIZE ? 0 : 1;
+}
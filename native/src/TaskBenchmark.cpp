@@ -0,0 +1,96 @@
+// Release jitter of the control step in real time: the single loop() that
+// runs control and UI back to back against the control/UI task split on
+// the std::thread stand-ins.
+//
+// The host UI step is too fast to matter, so UI work is padded with busy
+// waits sized like the ESP32's: an SSD1306 frame (1 KB at 400 kHz, about
+// 23 ms) every DISPLAY_UPDATE_INTERVAL and a 40 ms handleClient() serving a
+// page once a second. Virtual time follows the control period.
+
+#include "../include/Benchmarks.h"
+#include "../include/SimHal.h"
+#include "../../include/Tasks.h"
+#include <thread>
+
+// Firmware entry points from SC_ESP32.ino, linked in through main.cpp
+void setup();
+void controlStep();
+void uiStep();
+
+static const unsigned long RUN_TIME = 5000;     // ms of wall-clock time per mode
+static const unsigned long DISPLAY_FLUSH_US = 23000;
+static const unsigned long WEB_REQUEST_US = 40000;
+static const unsigned long WEB_REQUEST_INTERVAL = 1000;  // ms
+
+typedef std::chrono::steady_clock WallClock;
+
+static WallClock::time_point lastFlush;
+static WallClock::time_point lastRequest;
+
+static void busyWait(unsigned long us) {
+    auto end = WallClock::now() + std::chrono::microseconds(us);
+    while (WallClock::now() < end) {
+    }
+}
+
+static void controlWithClock() {
+    controlStep();
+    SimHal::clock().advance(CONTROL_TASK_PERIOD);
+}
+
+static void uiWithLoad() {
+    uiStep();
+
+    auto now = WallClock::now();
+    if (now - lastFlush >= std::chrono::milliseconds(DISPLAY_UPDATE_INTERVAL)) {
+        lastFlush = now;
+        busyWait(DISPLAY_FLUSH_US);
+    }
+    if (now - lastRequest >= std::chrono::milliseconds(WEB_REQUEST_INTERVAL)) {
+        lastRequest = now;
+        busyWait(WEB_REQUEST_US);
+    }
+}
+
+static void singleLoop() {
+    controlWithClock();
+    uiWithLoad();
+}
+
+static void report(const char* name, PeriodicTask& task) {
+    TaskStats stats = task.getStats();
+    printf("  %-8s: %lu runs, jitter mean %.0f us, max %lu us, run max %lu us, %lu overruns\n",
+           name, stats.runs, stats.meanJitterUs, stats.maxJitterUs, stats.maxRunUs, stats.overruns);
+}
+
+static void runFor(unsigned long ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+int benchmarkTasks() {
+    Serial.mute(true);
+    setup();
+    lastFlush = lastRequest = WallClock::now();
+
+    printf("control period        : %d ms, %lu ms per mode\n", CONTROL_TASK_PERIOD, RUN_TIME);
+
+    PeriodicTask loopTask("loop", singleLoop, CONTROL_TASK_PERIOD, CONTROL_TASK_PRIORITY, -1);
+    loopTask.start();
+    runFor(RUN_TIME);
+    loopTask.stop();
+    printf("single loop()         :\n");
+    report("loop", loopTask);
+
+    PeriodicTask controlTask("control", controlWithClock, CONTROL_TASK_PERIOD,
+                             CONTROL_TASK_PRIORITY, CONTROL_TASK_CORE);
+    PeriodicTask uiTask("ui", uiWithLoad, UI_TASK_PERIOD, UI_TASK_PRIORITY, UI_TASK_CORE);
+    controlTask.start();
+    uiTask.start();
+    runFor(RUN_TIME);
+    uiTask.stop();
+    controlTask.stop();
+    printf("task split            :\n");
+    report("control", controlTask);
+    report("ui", uiTask);
+    return 0;
+}
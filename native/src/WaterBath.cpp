@@ -0,0 +1,117 @@
+#include "../include/WaterBath.h"
+
+static const float WATER_SPECIFIC_HEAT = 4186.0;   // J/(kg*K)
+static const double MAX_STEP_SECONDS = 0.1;        // keeps the probe lag accurate
+
+WaterBath::WaterBath() : WaterBath(defaultParameters()) {
+}
+
+WaterBath::WaterBath(const Parameters& parameters) {
+    params = parameters;
+    waterTemp = params.initialTemp;
+    probeTemp = params.initialTemp;
+    heaterTemp = params.initialTemp;
+    outletProbeTemp = params.initialTemp;
+    coreTemp = params.coreInitialTemp;
+    heaterScale = 1.0;
+    heaterOnSeconds = 0;
+    elapsedSeconds = 0;
+    energyJoules = 0;
+    attached = false;
+}
+
+WaterBath::Parameters WaterBath::defaultParameters() {
+    Parameters p;
+    p.heaterWatts = 1000.0;
+    p.waterLiters = 10.0;
+    p.vesselHeatCapacity = 2000.0;
+    p.lossCoefficient = 4.0;
+    p.ambientTemp = 20.0;
+    p.initialTemp = 20.0;
+    p.probeTimeConstant = 8.0;
+    p.ssrPin = SSR_PIN;
+    p.sensorIndex = 0;
+    p.heaterHeatCapacity = 0;
+    p.heaterTransfer = 50.0;
+    p.outletTimeConstant = 2.0;
+    p.outletSensorIndex = -1;
+    p.coreTimeConstant = 1500.0;
+    p.coreInitialTemp = 5.0;
+    p.coreSensorIndex = -1;
+    return p;
+}
+
+void WaterBath::attach() {
+    if (attached) return;
+    attached = true;
+
+    SimHal::clock().addListener([this](uint64_t fromMicros, uint64_t toMicros) {
+        bool heaterOn = SimHal::gpio().getLevel(params.ssrPin) == HIGH;
+        step((toMicros - fromMicros) / 1e6, heaterOn);
+    });
+
+    SimHal::oneWire().setSource(params.sensorIndex, [this]() {
+        return probeTemp;
+    });
+    if (params.outletSensorIndex >= 0) {
+        SimHal::oneWire().setSource(params.outletSensorIndex, [this]() {
+            return outletProbeTemp;
+        });
+    }
+    if (params.coreSensorIndex >= 0) {
+        SimHal::oneWire().setSource(params.coreSensorIndex, [this]() {
+            return coreTemp;
+        });
+    }
+}
+
+float WaterBath::heatCapacity() {
+    return params.waterLiters * WATER_SPECIFIC_HEAT + params.vesselHeatCapacity;
+}
+
+void WaterBath::step(double dt, bool heaterOn) {
+    float power = heaterOn ? params.heaterWatts * heaterScale : 0;
+    double capacity = heatCapacity();
+
+    elapsedSeconds += dt;
+    if (heaterOn) {
+        heaterOnSeconds += dt;
+        energyJoules += power * dt;
+    }
+
+    while (dt > 0) {
+        double h = dt > MAX_STEP_SECONDS ? MAX_STEP_SECONDS : dt;
+        dt -= h;
+
+        if (params.heaterHeatCapacity > 0) {
+            // Heater mass between SSR and water; its time constant is
+            // seconds, so explicit steps of at most 0.1 s are stable
+            double transfer = params.heaterTransfer * (heaterTemp - waterTemp);
+            heaterTemp += (float)((power - transfer) * h / params.heaterHeatCapacity);
+            waterTemp += (float)((transfer - params.lossCoefficient * (waterTemp - params.ambientTemp)) * h / capacity);
+            outletProbeTemp = (float)(heaterTemp + (outletProbeTemp - heaterTemp) * exp(-h / params.outletTimeConstant));
+        } else {
+            // Exact solution of C dT/dt = P - k (T - Ta) over h with P held
+            double equilibrium = params.ambientTemp + power / params.lossCoefficient;
+            double decay = exp(-params.lossCoefficient * h / capacity);
+            waterTemp = (float)(equilibrium + (waterTemp - equilibrium) * decay);
+            heaterTemp = waterTemp;
+            outletProbeTemp = waterTemp;
+        }
+
+        coreTemp = (float)(waterTemp + (coreTemp - waterTemp) * exp(-h / params.coreTimeConstant));
+
+        // Probe follows the water through its own first-order lag
+        double lag = exp(-h / params.probeTimeConstant);
+        probeTemp = (float)(waterTemp + (probeTemp - waterTemp) * lag);
+    }
+}
+
+float WaterBath::getDutyCycle() {
+    return elapsedSeconds > 0 ? (float)(heaterOnSeconds / elapsedSeconds) : 0;
+}
+
+float WaterBath::holdingDuty(float temperature) {
+    float duty = params.lossCoefficient * (temperature - params.ambientTemp) / params.heaterWatts;
+    return constrain(duty, 0.0f, 1.0f);
+}
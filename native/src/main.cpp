@@ -0,0 +1,319 @@
+// Native runner: builds the unmodified sketch against the simulated HAL and
+// drives setup()/loop() on virtual time, reporting how long loop() takes on
+// the host. With --plant the SSR drives a simulated water bath that feeds
+// the DS18B20, and --cook-time runs a complete cook through the real
+// StateMachine -> PIDController -> SSRControl path.
+//
+//   .pio/build/native/program [--duration=<s>] [--verbose]
+//   .pio/build/native/program --plant --target=56 --cook-time=172800
+//       [--autotune [--cold-start]] [--heater=<W>] [--liters=<L>] [--ambient=<C>]
+//       [--pause-at=<s> --pause-for=<s>] [--sag-at=<s> --sag=<fraction>]
+//       [--sensors=<1-3>] [--heater-mass=<J/K>] [--heater-transfer=<W/K>]
+//       [--ssr=window|sigma-delta] [--zero-cross [--mains=<Hz>]]
+//       [--serial=<command>[;<command>...]]
+//       [--max-overshoot=<C>] [--max-settling=<s>] [--max-rms=<C>]
+//   .pio/build/native/program --bench=<name>
+//   .pio/build/native/program --decode-log=<file.bin> > log.csv
+//
+// --autotune runs the relay auto-tuner at the target first and cooks with
+// the gains it finds; --cold-start puts the bath back to its initial
+// temperature afterwards so the cook includes a full preheat. --pause-at
+// pauses the cook that many seconds into STATE_COOKING and resumes it after
+// --pause-for, reporting how long the bath takes to recover. --sensors=2 gives
+// the heater its own thermal mass (--heater-mass, coupled to the water by
+// --heater-transfer) with an outlet probe for cascade control, 3 adds a food
+// core probe. --sag-at drops the heater to --sag of its rated
+// power that many seconds into STATE_COOKING. --ssr picks the SSR modulation
+// and --zero-cross feeds a simulated mains zero-cross detector (--mains Hz,
+// MAINS_FREQUENCY by default) that sigma-delta decisions are synchronized to.
+// --serial types lines into the serial console at startup, e.g.
+// --serial="target=60;time=3600;start".
+// Exits non-zero when a --max-* limit is exceeded. --decode-log converts a
+// binary log downloaded from the device back to the CSV DataLogger writes.
+
+#include "../../SC_ESP32.ino"
+#include "../include/SimHal.h"
+#include "../include/WaterBath.h"
+#include "../include/CookMetrics.h"
+#include "../include/Benchmarks.h"
+#include <chrono>
+#include <vector>
+
+static bool parseOption(const char* arg, const char* name, float& value) {
+    size_t length = strlen(name);
+    if (strncmp(arg, name, length) != 0 || arg[length] != '=') return false;
+    value = strtof(arg + length + 1, nullptr);
+    return true;
+}
+
+static int decodeLog(const char* path) {
+    FILE* input = fopen(path, "rb");
+    if (input == nullptr) {
+        fprintf(stderr, "cannot open %s\n", path);
+        return 2;
+    }
+
+    LogDecoder decoder([input](uint8_t* buffer, size_t size) {
+        return (int)fread(buffer, 1, size, input);
+    });
+    if (!decoder.begin()) {
+        fprintf(stderr, "%s: not a binary log\n", path);
+        fclose(input);
+        return 1;
+    }
+
+    printf("%s\r\n", LOG_CSV_HEADER);
+    LogEntry entry;
+    char line[64];
+    unsigned long count = 0;
+    while (decoder.next(entry)) {
+        fwrite(line, 1, LogDecoder::formatCSV(entry, line, sizeof(line)), stdout);
+        count++;
+    }
+    fclose(input);
+    if (!decoder.isComplete()) {
+        fprintf(stderr, "%s: no end marker after %lu samples, session was not closed\n", path, count);
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    float durationSeconds = 3600;
+    float targetTemp = DEFAULT_TARGET_TEMP;
+    float cookTime = 0;
+    float maxOvershoot = -1, maxSettling = -1, maxRms = -1;
+    float pauseAt = -1, pauseFor = 0;
+    float sensorCount = 1;
+    float sagAt = -1, sag = 1;
+    bool verbose = false;
+    bool plant = false;
+    bool autotune = false;
+    bool coldStart = false;
+    bool sigmaDelta = SSR_SIGMA_DELTA;
+    bool zeroCross = SSR_ZERO_CROSS_SYNC;
+    float mainsFrequency = MAINS_FREQUENCY;
+    std::string serialInput;
+    WaterBath::Parameters bathParams = WaterBath::defaultParameters();
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        if (strcmp(arg, "--verbose") == 0) verbose = true;
+        else if (strcmp(arg, "--plant") == 0) plant = true;
+        else if (strcmp(arg, "--autotune") == 0) autotune = true;
+        else if (strcmp(arg, "--cold-start") == 0) coldStart = true;
+        else if (strcmp(arg, "--ssr=window") == 0) sigmaDelta = false;
+        else if (strcmp(arg, "--ssr=sigma-delta") == 0) sigmaDelta = true;
+        else if (strcmp(arg, "--zero-cross") == 0) zeroCross = true;
+        else if (parseOption(arg, "--mains", mainsFrequency)) {}
+        else if (strncmp(arg, "--bench=", 8) == 0) return runBenchmark(arg + 8);
+        else if (strncmp(arg, "--decode-log=", 13) == 0) return decodeLog(arg + 13);
+        else if (strncmp(arg, "--serial=", 9) == 0) {
+            for (const char* c = arg + 9; *c != '\0'; c++) serialInput += *c == ';' ? '\n' : *c;
+            serialInput += '\n';
+        }
+        else if (parseOption(arg, "--duration", durationSeconds)) {}
+        else if (parseOption(arg, "--target", targetTemp)) {}
+        else if (parseOption(arg, "--cook-time", cookTime)) {}
+        else if (parseOption(arg, "--heater", bathParams.heaterWatts)) {}
+        else if (parseOption(arg, "--liters", bathParams.waterLiters)) {}
+        else if (parseOption(arg, "--ambient", bathParams.ambientTemp)) {
+            bathParams.initialTemp = bathParams.ambientTemp;
+        }
+        else if (parseOption(arg, "--pause-at", pauseAt)) {}
+        else if (parseOption(arg, "--pause-for", pauseFor)) {}
+        else if (parseOption(arg, "--sensors", sensorCount)) {}
+        else if (parseOption(arg, "--heater-mass", bathParams.heaterHeatCapacity)) {}
+        else if (parseOption(arg, "--heater-transfer", bathParams.heaterTransfer)) {}
+        else if (parseOption(arg, "--sag-at", sagAt)) {}
+        else if (parseOption(arg, "--sag", sag)) {}
+        else if (parseOption(arg, "--max-overshoot", maxOvershoot)) {}
+        else if (parseOption(arg, "--max-settling", maxSettling)) {}
+        else if (parseOption(arg, "--max-rms", maxRms)) {}
+        else {
+            fprintf(stderr, "unknown option: %s\n", arg);
+            return 2;
+        }
+    }
+
+    if (plant && sensorCount >= 2) {
+        if (bathParams.heaterHeatCapacity <= 0) bathParams.heaterHeatCapacity = 400.0;
+        bathParams.outletSensorIndex = SimHal::oneWire().addDevice(bathParams.initialTemp);
+        tempSensor.setRoleAddress(SENSOR_HEATER_OUTLET,
+                                  SimHal::oneWire().getDevice(bathParams.outletSensorIndex).address);
+    }
+    if (plant && sensorCount >= 3) {
+        bathParams.coreSensorIndex = SimHal::oneWire().addDevice(bathParams.coreInitialTemp);
+        tempSensor.setRoleAddress(SENSOR_CORE, SimHal::oneWire().getDevice(bathParams.coreSensorIndex).address);
+    }
+
+    WaterBath bath(bathParams);
+    if (plant) {
+        SimHal::oneWire().setTemperature(bathParams.sensorIndex, bathParams.initialTemp);
+        bath.attach();
+    }
+
+    ssrControl.setModulation(sigmaDelta, zeroCross);
+    if (zeroCross) {
+        SimHal::zeroCross().start(ZERO_CROSS_PIN, mainsFrequency);
+    }
+
+    Serial.mute(!verbose);
+    Serial.feed(serialInput.c_str());
+    setup();
+
+    bool cook = cookTime > 0;
+    CookMetrics metrics;
+    double cookingStartHeaterOn = 0, cookingStartElapsed = 0;
+    bool cookingSeen = false;
+    
+    // Pause/resume recovery
+    CookMetrics recovery;
+    double pauseStart = -1, resumeTime = -1;
+    float pauseDip = 0;
+
+    typedef std::chrono::steady_clock WallClock;
+    std::vector<uint32_t> samples;
+    samples.reserve((size_t)(durationSeconds * 100));
+
+    if (autotune) {
+        stateMachine.setTargetTemperature(targetTemp);
+        stateMachine.startAutoTune();
+        unsigned long tuneEnd = HAL::clock().millis() + AUTOTUNE_TIMEOUT + 1000;
+        while (stateMachine.getCurrentState() == STATE_AUTOTUNE && HAL::clock().millis() < tuneEnd) {
+            loop();
+        }
+
+        PIDController::TuningParameters tuning = pidController.getTuningResult();
+        printf("autotune          : %s after %.0f s\n",
+               pidController.getAutoTuneState() == PIDController::AUTOTUNE_DONE ? "done" : "failed",
+               HAL::clock().millis() / 1000.0);
+        printf("ultimate gain     : %.3f %%/C, period %.1f s\n", tuning.ultimateGain, tuning.ultimatePeriod);
+        printf("tuned gains       : kp=%.3f ki=%.5f kd=%.3f\n", tuning.kp, tuning.ki, tuning.kd);
+        printf("tune overshoot    : %.3f C, settling %.0f s\n", tuning.overshoot, tuning.settlingTime);
+        if (pidController.getAutoTuneState() != PIDController::AUTOTUNE_DONE) return 1;
+        
+        if (coldStart) {
+            bath.setWaterTemperature(bathParams.initialTemp);
+            bath.setProbeTemperature(bathParams.initialTemp);
+            // Let the sensor filter catch up while idle
+            unsigned long settleEnd = HAL::clock().millis() + 60000;
+            while (HAL::clock().millis() < settleEnd) {
+                loop();
+            }
+        }
+    }
+
+    if (cook) {
+        stateMachine.setTargetTemperature(targetTemp);
+        stateMachine.setCookingTime((unsigned long)cookTime);
+        stateMachine.startCooking();
+        metrics.begin(stateMachine.getCookingParameters().targetTemperature, HAL::clock().millis() / 1000.0);
+        // Allow up to four hours of preheat on top of the cook itself
+        durationSeconds = cookTime + 4 * 3600;
+    }
+
+    unsigned long endTime = HAL::clock().millis() + (unsigned long)(durationSeconds * 1000);
+    WallClock::time_point start = WallClock::now();
+
+    while (HAL::clock().millis() < endTime) {
+        WallClock::time_point before = WallClock::now();
+        loop();
+        WallClock::time_point after = WallClock::now();
+        samples.push_back((uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(after - before).count());
+
+        if (!cook) continue;
+
+        SystemState state = stateMachine.getCurrentState();
+        if (plant) {
+            metrics.sample(bath.getWaterTemperature(), HAL::clock().millis() / 1000.0);
+        }
+        if (state == STATE_COOKING && !cookingSeen) {
+            cookingSeen = true;
+            cookingStartHeaterOn = bath.getHeaterOnSeconds();
+            cookingStartElapsed = bath.getElapsedSeconds();
+        }
+        
+        double now = HAL::clock().millis() / 1000.0;
+        if (pauseAt >= 0 && cookingSeen && pauseStart < 0 &&
+            bath.getElapsedSeconds() - cookingStartElapsed >= pauseAt) {
+            stateMachine.pauseCooking();
+            pauseStart = now;
+            pauseDip = targetTemp;
+        }
+        if (pauseStart >= 0 && resumeTime < 0 && now - pauseStart >= pauseFor) {
+            stateMachine.resumeCooking();
+            resumeTime = now;
+            recovery.begin(targetTemp, now);
+        }
+        if (pauseStart >= 0) {
+            pauseDip = min(pauseDip, bath.getWaterTemperature());
+        }
+        if (sagAt >= 0 && cookingSeen && bath.getElapsedSeconds() - cookingStartElapsed >= sagAt) {
+            bath.setHeaterScale(sag);
+        }
+        if (resumeTime >= 0) {
+            recovery.sample(bath.getWaterTemperature(), now);
+        }
+        state = stateMachine.getCurrentState();
+        if (state == STATE_FINISHED || state == STATE_ERROR) break;
+    }
+
+    double wallSeconds = std::chrono::duration<double>(WallClock::now() - start).count();
+    double simulatedSeconds = HAL::clock().millis() / 1000.0;
+    std::sort(samples.begin(), samples.end());
+
+    double total = 0;
+    for (uint32_t sample : samples) total += sample;
+
+    size_t count = samples.size();
+    printf("loop() iterations : %zu\n", count);
+    printf("simulated time    : %.0f s\n", simulatedSeconds);
+    printf("wall time         : %.3f s (%.0fx real time)\n", wallSeconds, simulatedSeconds / wallSeconds);
+    if (count > 0) {
+        printf("loop() mean       : %.2f us\n", total / count / 1000.0);
+        printf("loop() p50        : %.2f us\n", samples[count / 2] / 1000.0);
+        printf("loop() p99        : %.2f us\n", samples[count * 99 / 100] / 1000.0);
+        printf("loop() max        : %.2f us\n", samples[count - 1] / 1000.0);
+    }
+    printf("i2c bytes written : %lu\n", SimHal::i2c().getBytesWritten());
+
+    if (!cook) return 0;
+
+    SystemState finalState = stateMachine.getCurrentState();
+    printf("final state       : %d\n", finalState);
+
+    if (plant) {
+        metrics.print();
+        if (bathParams.coreSensorIndex >= 0) {
+            printf("core temperature  : %.2f C after %.0f s of cooking\n", bath.getCoreTemperature(),
+                   cookingSeen ? bath.getElapsedSeconds() - cookingStartElapsed : 0);
+        }
+        double cookingElapsed = bath.getElapsedSeconds() - cookingStartElapsed;
+        if (cookingSeen && cookingElapsed > 0) {
+            printf("cooking duty      : %.1f %% (holding needs %.1f %%)\n",
+                   100.0 * (bath.getHeaterOnSeconds() - cookingStartHeaterOn) / cookingElapsed,
+                   100.0 * bath.holdingDuty(metrics.hasReached() ? targetTemp : bath.getWaterTemperature()));
+        }
+        printf("energy            : %.1f Wh\n", bath.getEnergyJoules() / 3600.0);
+        if (resumeTime >= 0) {
+            printf("pause dip         : %.3f C\n", targetTemp - pauseDip);
+            printf("pause recovery    : %.0f s to setpoint, overshoot %.3f C\n",
+                   recovery.getTimeToSetpoint(), recovery.getOvershoot());
+        }
+    }
+
+    int status = finalState == STATE_FINISHED ? 0 : 1;
+    if (maxOvershoot >= 0 && metrics.getOvershoot() > maxOvershoot) {
+        printf("FAIL: overshoot %.3f C > %.3f C\n", metrics.getOvershoot(), maxOvershoot);
+        status = 1;
+    }
+    if (maxSettling >= 0 && (!metrics.hasReached() || metrics.getSettlingTime() > maxSettling)) {
+        printf("FAIL: settling %.0f s > %.0f s\n", metrics.getSettlingTime(), maxSettling);
+        status = 1;
+    }
+    if (maxRms >= 0 && metrics.getRmsError() > maxRms) {
+        printf("FAIL: rms error %.3f C > %.3f C\n", metrics.getRmsError(), maxRms);
+        status = 1;
+    }
+    return status;
+}
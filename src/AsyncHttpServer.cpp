@@ -0,0 +1,546 @@
+#include "../include/AsyncHttpServer.h"
+
+// Room before chunk data for its size line, "1fe\r\n" at most
+static const size_t CHUNK_PREFIX = 6;
+
+// Case-insensitive header lookup in a block of "Name: value\r\n" lines
+// ending at a NUL; value may be nullptr to test for presence only
+static bool findHeader(const char* lines, const char* name, char* value, size_t size) {
+    size_t nameLength = strlen(name);
+    const char* line = lines;
+    while (*line != '\0') {
+        const char* end = strstr(line, "\r\n");
+        if (end == nullptr) end = line + strlen(line);
+        if ((size_t)(end - line) > nameLength && line[nameLength] == ':' &&
+            strncasecmp(line, name, nameLength) == 0) {
+            if (value == nullptr) return true;
+            const char* start = line + nameLength + 1;
+            while (start < end && (*start == ' ' || *start == '\t')) start++;
+            const char* stop = end;
+            while (stop > start && (stop[-1] == ' ' || stop[-1] == '\t')) stop--;
+            size_t length = stop - start;
+            if (length >= size) return false;
+            memcpy(value, start, length);
+            value[length] = '\0';
+            return true;
+        }
+        line = *end != '\0' ? end + 2 : end;
+    }
+    return false;
+}
+
+// Digits only, without overflow
+static bool parseLength(const char* text, size_t& length) {
+    length = 0;
+    if (*text == '\0') return false;
+    for (; *text != '\0'; text++) {
+        if (*text < '0' || *text > '9' || length > (SIZE_MAX - 9) / 10) return false;
+        length = length * 10 + (*text - '0');
+    }
+    return true;
+}
+
+static int hexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Finds name=value in an application/x-www-form-urlencoded string and
+// decodes the value; value may be nullptr to test for presence only
+static bool findArg(const char* pairs, const char* name, char* value, size_t size) {
+    size_t nameLength = strlen(name);
+    const char* pair = pairs;
+    while (*pair != '\0') {
+        const char* end = strchr(pair, '&');
+        if (end == nullptr) end = pair + strlen(pair);
+        if (strncmp(pair, name, nameLength) == 0 &&
+            (pair + nameLength == end || pair[nameLength] == '=')) {
+            if (value == nullptr) return true;
+            const char* in = pair + nameLength + (pair + nameLength < end ? 1 : 0);
+            size_t length = 0;
+            while (in < end) {
+                char c = *in++;
+                if (c == '+') {
+                    c = ' ';
+                } else if (c == '%' && end - in >= 2 && hexDigit(in[0]) >= 0 && hexDigit(in[1]) >= 0) {
+                    c = (char)(hexDigit(in[0]) * 16 + hexDigit(in[1]));
+                    in += 2;
+                }
+                if (length + 1 >= size) return false;
+                value[length++] = c;
+            }
+            value[length] = '\0';
+            return true;
+        }
+        pair = *end != '\0' ? end + 1 : end;
+    }
+    return false;
+}
+
+// ---------------------------------------------------------------------------
+// HttpRequest
+
+bool HttpRequest::arg(const char* name, char* value, size_t size) const {
+    if (findArg(requestQuery, name, value, size)) return true;
+    // Form posts carry their arguments in the body
+    char type[48];
+    if (bodyLength > 0 && header("Content-Type", type, sizeof(type)) &&
+        strncmp(type, "application/x-www-form-urlencoded", 33) == 0) {
+        return findArg(requestBody, name, value, size);
+    }
+    return false;
+}
+
+bool HttpRequest::hasArg(const char* name) const {
+    return arg(name, nullptr, 0);
+}
+
+bool HttpRequest::header(const char* name, char* value, size_t size) const {
+    return findHeader(headerStart, name, value, size);
+}
+
+HttpRange HttpRequest::range(size_t size, size_t& first, size_t& last) const {
+    char value[48];
+    if (!header("Range", value, sizeof(value)) || header("If-Range", nullptr, 0) ||
+        strncmp(value, "bytes=", 6) != 0 || strchr(value, ',') != nullptr) {
+        return HTTP_RANGE_NONE;
+    }
+
+    const char* spec = value + 6;
+    char* end;
+    if (spec[0] == '-') {
+        // Suffix: the last n bytes
+        if (!isdigit((unsigned char)spec[1])) return HTTP_RANGE_NONE;
+        unsigned long suffix = strtoul(spec + 1, &end, 10);
+        if (*end != '\0') return HTTP_RANGE_NONE;
+        if (suffix == 0 || size == 0) return HTTP_RANGE_UNSATISFIABLE;
+        first = suffix < size ? size - suffix : 0;
+        last = size - 1;
+        return HTTP_RANGE_SATISFIABLE;
+    }
+
+    if (!isdigit((unsigned char)spec[0])) return HTTP_RANGE_NONE;
+    unsigned long start = strtoul(spec, &end, 10);
+    if (*end != '-') return HTTP_RANGE_NONE;
+    const char* stopText = end + 1;
+    unsigned long stop = (unsigned long)-1;
+    if (*stopText != '\0') {
+        if (!isdigit((unsigned char)*stopText)) return HTTP_RANGE_NONE;
+        stop = strtoul(stopText, &end, 10);
+        if (*end != '\0' || stop < start) return HTTP_RANGE_NONE;
+    }
+    if (start >= size) return HTTP_RANGE_UNSATISFIABLE;
+    first = start;
+    last = stop < size - 1 ? stop : size - 1;
+    return HTTP_RANGE_SATISFIABLE;
+}
+
+void HttpRequest::send(int code, const char* contentType, const char* content) {
+    send(code, contentType, content, strlen(content));
+}
+
+void HttpRequest::send(int code, const char* contentType, const char* content, size_t length) {
+    if (responded) return;
+    responded = true;
+
+    AsyncHttpServer::Connection& c = server->connections[connection];
+    if (!server->beginResponse(connection, code, contentType, length, nullptr) ||
+        c.responseLength + length > sizeof(c.response)) {
+        server->beginResponse(connection, 500, "text/plain", 0, nullptr);
+        return;
+    }
+    if (requestMethod != HTTP_METHOD_HEAD) {
+        memcpy(c.response + c.responseLength, content, length);
+        c.responseLength += length;
+    }
+}
+
+void HttpRequest::sendStatic(int code, const char* contentType, const uint8_t* content, size_t length,
+                             const char* extraHeaders) {
+    if (responded) return;
+    responded = true;
+
+    AsyncHttpServer::Connection& c = server->connections[connection];
+    if (!server->beginResponse(connection, code, contentType, length, extraHeaders)) {
+        server->beginResponse(connection, 500, "text/plain", 0, nullptr);
+        return;
+    }
+    if (requestMethod != HTTP_METHOD_HEAD) {
+        c.body = content;
+        c.bodyLength = length;
+    }
+}
+
+void HttpRequest::sendStream(int code, const char* contentType, HttpBodySource* source, size_t length,
+                             const char* extraHeaders) {
+    if (responded) {
+        delete source;
+        return;
+    }
+    responded = true;
+
+    AsyncHttpServer::Connection& c = server->connections[connection];
+    if (!server->beginResponse(connection, code, contentType, length, extraHeaders)) {
+        delete source;
+        server->beginResponse(connection, 500, "text/plain", 0, nullptr);
+        return;
+    }
+    if (requestMethod == HTTP_METHOD_HEAD) {
+        delete source;
+        return;
+    }
+    c.source = source;
+    c.sourceRemaining = length;
+}
+
+// ---------------------------------------------------------------------------
+// AsyncHttpServer
+
+AsyncHttpServer::AsyncHttpServer() {
+    for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+        connections[i].phase = PHASE_CLOSED;
+        connections[i].source = nullptr;
+    }
+    routeCount = 0;
+    stats = Stats{0, 0, 0};
+    started = false;
+}
+
+void AsyncHttpServer::on(const char* path, HttpMethod method, Handler handler) {
+    if (routeCount >= MAX_ROUTES) {
+        DEBUG_PRINTLN(F("ERROR: Too many HTTP routes"));
+        return;
+    }
+    routes[routeCount++] = Route{path, method, handler};
+}
+
+bool AsyncHttpServer::begin(uint16_t port) {
+    started = HAL::tcpServer().begin(port, this);
+    return started;
+}
+
+const char* AsyncHttpServer::statusText(int code) {
+    switch (code) {
+        case 200: return "OK";
+        case 202: return "Accepted";
+        case 204: return "No Content";
+        case 206: return "Partial Content";
+        case 304: return "Not Modified";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 413: return "Payload Too Large";
+        case 416: return "Range Not Satisfiable";
+        case 431: return "Request Header Fields Too Large";
+        case 503: return "Service Unavailable";
+        default: return code < 400 ? "OK" : "Internal Server Error";
+    }
+}
+
+bool AsyncHttpServer::beginResponse(int id, int code, const char* contentType, size_t contentLength,
+                                    const char* extraHeaders) {
+    Connection& c = connections[id];
+    c.body = nullptr;
+    c.bodyLength = 0;
+    c.bodySent = 0;
+    c.responseSent = 0;
+    release(id);
+    c.sourceRemaining = HttpRequest::UNKNOWN_LENGTH;
+    c.chunked = false;
+
+    // Framing of the body: its length, chunks, or the end of the connection
+    char framing[40] = "";
+    if (contentLength != HttpRequest::UNKNOWN_LENGTH) {
+        snprintf(framing, sizeof(framing), "Content-Length: %u\r\n", (unsigned)contentLength);
+    } else if (c.http11) {
+        strcpy(framing, "Transfer-Encoding: chunked\r\n");
+        c.chunked = true;
+    } else {
+        c.keepAlive = false;
+    }
+
+    int length;
+    if (code == 204 || code == 304) {
+        // No body, so no entity headers: a 304's would describe the 200
+        length = snprintf(c.response, sizeof(c.response), "HTTP/1.1 %d %s\r\nConnection: %s\r\n%s\r\n",
+                          code, statusText(code), c.keepAlive ? "keep-alive" : "close",
+                          extraHeaders != nullptr ? extraHeaders : "");
+    } else {
+        length = snprintf(c.response, sizeof(c.response),
+                          "HTTP/1.1 %d %s\r\nContent-Type: %s\r\n%sConnection: %s\r\n%s\r\n",
+                          code, statusText(code), contentType, framing,
+                          c.keepAlive ? "keep-alive" : "close", extraHeaders != nullptr ? extraHeaders : "");
+    }
+    if (length < 0 || (size_t)length >= sizeof(c.response)) {
+        c.responseLength = 0;
+        return false;
+    }
+    c.responseLength = length;
+    c.phase = PHASE_RESPONSE;
+    return true;
+}
+
+void AsyncHttpServer::onConnect(int id) {
+    Connection& c = connections[id];
+    c.phase = PHASE_REQUEST;
+    c.requestLength = 0;
+    c.responseLength = 0;
+    c.responseSent = 0;
+    c.body = nullptr;
+    c.bodyLength = 0;
+    c.bodySent = 0;
+    c.source = nullptr;
+    c.keepAlive = true;
+    c.http11 = true;
+}
+
+void AsyncHttpServer::onData(int id, const uint8_t* data, size_t length) {
+    Connection& c = connections[id];
+    if (c.phase == PHASE_CLOSED) return;
+
+    // Take what fits and parse it; each request answered makes room for
+    // the rest of the segment. A full buffer in PHASE_REQUEST always gets a
+    // response or a 431/413 from parse(), so only a client pipelining past
+    // a response in flight runs out of room, and is dropped.
+    while (length > 0) {
+        // Nothing after a response that ends the connection gets an answer
+        if (c.phase == PHASE_RESPONSE && !c.keepAlive) return;
+
+        size_t room = HTTP_REQUEST_BUFFER_SIZE - c.requestLength;
+        if (room == 0) {
+            HAL::tcpServer().close(id);
+            c.phase = PHASE_CLOSED;
+            return;
+        }
+        size_t taken = length < room ? length : room;
+        memcpy(c.request + c.requestLength, data, taken);
+        c.requestLength += taken;
+        data += taken;
+        length -= taken;
+
+        // The next request on a keep-alive connection waits for this response
+        if (c.phase == PHASE_REQUEST && parse(id)) {
+            finish(id);
+        }
+        if (c.phase == PHASE_CLOSED) return;
+    }
+}
+
+void AsyncHttpServer::onSent(int id) {
+    if (connections[id].phase == PHASE_RESPONSE && pump(id)) {
+        finish(id);
+    }
+}
+
+void AsyncHttpServer::onDisconnect(int id) {
+    connections[id].phase = PHASE_CLOSED;
+    release(id);
+}
+
+bool AsyncHttpServer::parse(int id) {
+    Connection& c = connections[id];
+    c.request[c.requestLength] = '\0';
+
+    char* headersEnd = strstr(c.request, "\r\n\r\n");
+    if (headersEnd == nullptr) {
+        return c.requestLength >= HTTP_REQUEST_BUFFER_SIZE && reject(id, 431);
+    }
+
+    // Wait for the whole body
+    char value[16];
+    size_t headerBytes = headersEnd + 4 - c.request;
+    size_t contentLength = 0;
+    bool validLength = true;
+    headersEnd[2] = '\0';
+    if (findHeader(c.request, "Content-Length", nullptr, 0)) {
+        validLength = findHeader(c.request, "Content-Length", value, sizeof(value)) &&
+                      parseLength(value, contentLength);
+    }
+    headersEnd[2] = '\r';
+    if (!validLength) {
+        return reject(id, 400);
+    }
+    if (contentLength > HTTP_REQUEST_BUFFER_SIZE - headerBytes) {
+        return reject(id, 413);
+    }
+    if (c.requestLength < headerBytes + contentLength) return false;
+
+    return dispatch(id, headersEnd, contentLength);
+}
+
+bool AsyncHttpServer::dispatch(int id, char* headersEnd, size_t contentLength) {
+    Connection& c = connections[id];
+    char value[16];
+
+    // Terminate the header block and the body in place; the byte after the
+    // body belongs to the next request and is put back afterwards
+    headersEnd[2] = '\0';
+    size_t consumed = headersEnd + 4 - c.request + contentLength;
+    char following = c.request[consumed];
+    c.request[consumed] = '\0';
+
+    // Request line: METHOD SP target SP version
+    char* lineEnd = strstr(c.request, "\r\n");
+    *lineEnd = '\0';
+    char* target = strchr(c.request, ' ');
+    char* version = target != nullptr ? strchr(target + 1, ' ') : nullptr;
+    if (version == nullptr) {
+        return reject(id, 400);
+    }
+    *target++ = '\0';
+    *version++ = '\0';
+
+    HttpRequest request;
+    request.server = this;
+    request.connection = id;
+    if (strcmp(c.request, "GET") == 0) request.requestMethod = HTTP_METHOD_GET;
+    else if (strcmp(c.request, "HEAD") == 0) request.requestMethod = HTTP_METHOD_HEAD;
+    else if (strcmp(c.request, "POST") == 0) request.requestMethod = HTTP_METHOD_POST;
+    char* query = strchr(target, '?');
+    if (query != nullptr) *query++ = '\0';
+    request.requestPath = target;
+    request.requestQuery = query != nullptr ? query : "";
+    request.headerStart = lineEnd + 2;
+    request.requestBody = headersEnd + 4;
+    request.bodyLength = contentLength;
+
+    // HTTP/1.1 keeps the connection unless told otherwise, 1.0 the reverse
+    c.http11 = strcmp(version, "HTTP/1.1") == 0;
+    c.keepAlive = c.http11;
+    if (request.header("Connection", value, sizeof(value))) {
+        if (strcasecmp(value, "close") == 0) c.keepAlive = false;
+        if (strcasecmp(value, "keep-alive") == 0) c.keepAlive = true;
+    }
+
+    stats.requests++;
+    Handler* handler = nullptr;
+    for (int i = 0; i < routeCount; i++) {
+        HttpMethod routeMethod = routes[i].method;
+        bool methodMatches = routeMethod == HTTP_METHOD_ANY || routeMethod == request.requestMethod ||
+                             (routeMethod == HTTP_METHOD_GET && request.requestMethod == HTTP_METHOD_HEAD);
+        if (methodMatches && strcmp(routes[i].path, target) == 0) {
+            handler = &routes[i].handler;
+            break;
+        }
+    }
+    if (handler != nullptr) {
+        (*handler)(request);
+    } else if (notFoundHandler) {
+        notFoundHandler(request);
+    }
+    if (!request.responded) {
+        request.send(404, "text/plain", "Not Found");
+    }
+
+    // Keep whatever followed this request for after the response
+    c.request[consumed] = following;
+    c.requestLength -= consumed;
+    memmove(c.request, c.request + consumed, c.requestLength);
+
+    return pump(id);
+}
+
+bool AsyncHttpServer::reject(int id, int code) {
+    Connection& c = connections[id];
+    c.keepAlive = false;
+    c.requestLength = 0;
+    stats.rejected++;
+    beginResponse(id, code, "text/plain", 0, nullptr);
+    return pump(id);
+}
+
+bool AsyncHttpServer::pump(int id) {
+    Connection& c = connections[id];
+    HalTcpServer& tcp = HAL::tcpServer();
+
+    do {
+        while (c.responseSent < c.responseLength) {
+            size_t written = tcp.write(id, (const uint8_t*)c.response + c.responseSent,
+                                       c.responseLength - c.responseSent);
+            if (written == 0) return false;        // onSent() resumes
+            c.responseSent += written;
+            stats.bytesSent += written;
+        }
+        while (c.bodySent < c.bodyLength) {
+            size_t written = tcp.write(id, c.body + c.bodySent, c.bodyLength - c.bodySent);
+            if (written == 0) return false;
+            c.bodySent += written;
+            stats.bytesSent += written;
+        }
+    } while (c.source != nullptr && refill(id));
+    return true;
+}
+
+// Reads the next piece of a streamed body into the response buffer, which
+// has been sent in full; false once there is nothing left to send
+bool AsyncHttpServer::refill(int id) {
+    Connection& c = connections[id];
+    c.responseSent = 0;
+    c.responseLength = 0;
+
+    if (c.chunked) {
+        // Data after room for the size line, leaving room for its CRLF
+        size_t count = c.source->read((uint8_t*)c.response + CHUNK_PREFIX,
+                                      sizeof(c.response) - CHUNK_PREFIX - 2);
+        if (count == 0) {
+            release(id);
+            memcpy(c.response, "0\r\n\r\n", 5);
+            c.responseLength = 5;
+            return true;
+        }
+        char line[CHUNK_PREFIX + 1];
+        int length = snprintf(line, sizeof(line), "%x\r\n", (unsigned)count);
+        c.responseSent = CHUNK_PREFIX - length;
+        memcpy(c.response + c.responseSent, line, length);
+        memcpy(c.response + CHUNK_PREFIX + count, "\r\n", 2);
+        c.responseLength = CHUNK_PREFIX + count + 2;
+        return true;
+    }
+
+    size_t wanted = c.sourceRemaining < sizeof(c.response) ? c.sourceRemaining : sizeof(c.response);
+    size_t count = wanted > 0 ? c.source->read((uint8_t*)c.response, wanted) : 0;
+    if (count == 0) {
+        // Short of the promised length the client would wait forever
+        if (c.sourceRemaining != HttpRequest::UNKNOWN_LENGTH && c.sourceRemaining > 0) {
+            c.keepAlive = false;
+        }
+        release(id);
+        return false;
+    }
+    if (c.sourceRemaining != HttpRequest::UNKNOWN_LENGTH) {
+        c.sourceRemaining -= count;
+    }
+    c.responseLength = count;
+    return true;
+}
+
+// Pipelined requests are answered in this loop rather than by recursion
+// through parse() and pump(), which the network task's stack could not take
+void AsyncHttpServer::finish(int id) {
+    Connection& c = connections[id];
+    do {
+        release(id);
+        if (!c.keepAlive) {
+            c.phase = PHASE_CLOSED;
+            HAL::tcpServer().close(id);
+            return;
+        }
+
+        c.phase = PHASE_REQUEST;
+        c.responseLength = 0;
+        c.responseSent = 0;
+        c.body = nullptr;
+        c.bodyLength = 0;
+        c.bodySent = 0;
+    } while (c.requestLength > 0 && parse(id));
+}
+
+void AsyncHttpServer::release(int id) {
+    Connection& c = connections[id];
+    if (c.source != nullptr) {
+        delete c.source;
+        c.source = nullptr;
+    }
+}
@@ -0,0 +1,55 @@
+#include "../include/CascadeController.h"
+
+CascadeController::CascadeController() {
+    active = false;
+    outletSetpoint = 0;
+    output = 0;
+    lastTime = 0;
+}
+
+void CascadeController::begin() {
+    inner.setOutputLimits(0, 100);
+    if (!inner.setTunings(CASCADE_INNER_KP, CASCADE_INNER_KI, CASCADE_INNER_KD)) {
+        DEBUG_PRINTLN(F("ERROR: Cascade inner gains out of range"));
+    }
+}
+
+void CascadeController::start(float outletTemp, float currentOutput) {
+    inner.initialize(NumericTraits<PIDNumber>::fromFloat(outletTemp),
+                     NumericTraits<PIDNumber>::fromFloat(currentOutput));
+    output = currentOutput;
+    lastTime = HAL::clock().millis();
+    active = true;
+    
+    DEBUG_PRINTLN(F("Cascade control engaged"));
+}
+
+void CascadeController::stop() {
+    if (active) {
+        DEBUG_PRINTLN(F("Cascade control released"));
+    }
+    active = false;
+}
+
+float CascadeController::compute(float demand, float bathTemp, float outletTemp) {
+    if (!active) {
+        return demand;
+    }
+    
+    // The inner core runs on a fixed period; in between the SSR keeps the
+    // last inner output
+    unsigned long now = HAL::clock().millis();
+    if (now - lastTime < CASCADE_INNER_SAMPLE_TIME) {
+        return output;
+    }
+    lastTime += CASCADE_INNER_SAMPLE_TIME;
+    if (now - lastTime >= CASCADE_INNER_SAMPLE_TIME) {
+        lastTime = now;  // fell behind, don't replay missed samples
+    }
+    
+    outletSetpoint = bathTemp + constrain(demand, 0.0f, 100.0f) * ((float)CASCADE_OUTLET_RISE / 100);
+    PIDNumber result = inner.compute(NumericTraits<PIDNumber>::fromFloat(outletSetpoint),
+                                     NumericTraits<PIDNumber>::fromFloat(outletTemp));
+    output = NumericTraits<PIDNumber>::toFloat(result);
+    return output;
+}
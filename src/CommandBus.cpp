@@ -0,0 +1,100 @@
+#include "../include/CommandBus.h"
+#include <math.h>
+
+// The whole string must be a finite number
+static bool parseNumber(const char* text, float& value) {
+    char* end;
+    value = strtof(text, &end);
+    return end != text && *end == '\0' && isfinite(value);
+}
+
+CommandBus::CommandBus() : dropped(0) {
+}
+
+bool CommandBus::post(const Command& command) {
+    if (queue.push(command)) {
+        return true;
+    }
+    dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+bool CommandBus::postAll(const Command* commands, int count) {
+    if (count <= 0 || queue.pushAll(commands, count)) {
+        return true;
+    }
+    dropped.fetch_add(count, std::memory_order_relaxed);
+    return false;
+}
+
+bool CommandBus::take(Command& command) {
+    return queue.pop(command);
+}
+
+bool CommandBus::parse(const char* action, const char* value, CommandSource source, Command& command) {
+    command.source = source;
+    if (value == nullptr) value = "";
+
+    if (strcmp(action, "start") == 0) {
+        command.type = COMMAND_START;
+    } else if (strcmp(action, "stop") == 0) {
+        command.type = COMMAND_STOP;
+    } else if (strcmp(action, "pause") == 0) {
+        command.type = COMMAND_PAUSE;
+    } else if (strcmp(action, "resume") == 0) {
+        command.type = COMMAND_RESUME;
+    } else if (strcmp(action, "autotune") == 0) {
+        command.type = COMMAND_AUTOTUNE;
+    } else if (strcmp(action, "target") == 0) {
+        command.type = COMMAND_SET_TARGET;
+        return parseNumber(value, command.temperature) &&
+               command.temperature >= MIN_TEMP && command.temperature <= MAX_TEMP;
+    } else if (strcmp(action, "time") == 0) {
+        float seconds;
+        command.type = COMMAND_SET_TIME;
+        if (!parseNumber(value, seconds) || seconds < MIN_COOKING_TIME || seconds > MAX_COOKING_TIME) {
+            return false;
+        }
+        command.seconds = (unsigned long)seconds;
+    } else if (strcmp(action, "pid") == 0) {
+        // "<kp>,<ki>,<kd>", none negative
+        char gains[48];
+        if (strlen(value) >= sizeof(gains)) return false;
+        strcpy(gains, value);
+        char* ki = strchr(gains, ',');
+        char* kd = ki != nullptr ? strchr(ki + 1, ',') : nullptr;
+        if (kd == nullptr) return false;
+        *ki++ = '\0';
+        *kd++ = '\0';
+        command.type = COMMAND_SET_PID;
+        return parseNumber(gains, command.gains.kp) && parseNumber(ki, command.gains.ki) &&
+               parseNumber(kd, command.gains.kd) &&
+               command.gains.kp >= 0 && command.gains.ki >= 0 && command.gains.kd >= 0;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* CommandBus::typeName(CommandType type) {
+    switch (type) {
+        case COMMAND_START: return "start";
+        case COMMAND_STOP: return "stop";
+        case COMMAND_PAUSE: return "pause";
+        case COMMAND_RESUME: return "resume";
+        case COMMAND_SET_TARGET: return "target";
+        case COMMAND_SET_TIME: return "time";
+        case COMMAND_SET_PID: return "pid";
+        case COMMAND_AUTOTUNE: return "autotune";
+        default: return "unknown";
+    }
+}
+
+const char* CommandBus::sourceName(CommandSource source) {
+    switch (source) {
+        case COMMAND_SOURCE_WEB: return "web";
+        case COMMAND_SOURCE_SERIAL: return "serial";
+        case COMMAND_SOURCE_MQTT: return "mqtt";
+        default: return "unknown";
+    }
+}
@@ -1,10 +1,30 @@
 #include "../include/DataLogger.h"
+#include <vector>
+
+// Longest sample as a CSV line or binary record; logData() only encodes
+// into the ring when this much room is left, so a record is never split.
+// The encoder never holds more than sizeof(LogEncoder::buffer) bytes, so
+// the end marker endSession() stages after the last record fits as well.
+static const size_t MAX_STAGED_ENTRY = 64;
 
 DataLogger::DataLogger() {
     enabled = false;
     currentLogFileName = "";
     logStartTime = 0;
     entryCount = 0;
+    binary = LOG_FORMAT_BINARY;
+    sessionOpen = false;
+    droppedEntries = 0;
+    nextIndexTime = 0;
+
+    stagedBytes = 0;
+    committedBytes = 0;
+    storageLow = false;
+
+    logFile = nullptr;
+    indexFile = nullptr;
+    fileBytes = 0;
+    pendingSince = 0;
 }
 
 bool DataLogger::begin() {
@@ -18,27 +38,55 @@ bool DataLogger::begin() {
 }
 
 void DataLogger::logData(float temp, float target, float power, unsigned long remaining) {
-    if (!enabled) return;
+    logData(temp, target, power, remaining, HAL::clock().millis());
+}
+
+void DataLogger::logData(float temp, float target, float power, unsigned long remaining, unsigned long time) {
+    if (!enabled || !sessionOpen) return;
+    
+    // Sessions run until the filesystem is nearly full
+    if (storageLow) {
+        DEBUG_PRINTLN(F("Log storage full, logging stopped"));
+        endSession();
+        return;
+    }
+    
+    if (stagingRoom() < MAX_STAGED_ENTRY) {
+        droppedEntries++;
+        return;
+    }
     
+    // A sample held back across a session change counts from its start
     LogEntry entry;
-    entry.timestamp = millis() - logStartTime;
+    entry.timestamp = (long)(time - logStartTime) > 0 ? time - logStartTime : 0;
     entry.temperature = temp;
     entry.targetTemp = target;
     entry.power = power;
     entry.remainingTime = remaining;
     
-    if (logFile) {
-        logFile.print(entry.timestamp / 1000);
-        logFile.print(",");
-        logFile.print(entry.temperature, 2);
-        logFile.print(",");
-        logFile.print(entry.targetTemp, 2);
-        logFile.print(",");
-        logFile.print(entry.power, 1);
-        logFile.print(",");
-        logFile.println(entry.remainingTime);
-        logFile.flush();
-        
+    if (binary) {
+        // Sparse: a missed entry only means a longer seek
+        if (entry.timestamp >= nextIndexTime) {
+            LogIndexEntry index = encoder.indexEntry();
+            postEvent(LOG_EVENT_INDEX, "", &index);
+            nextIndexTime += LOG_INDEX_INTERVAL;
+        }
+        // A record that cannot be staged is taken back out of the bit
+        // stream, so only this sample is lost and the rest still decodes
+        LogEncoder before = encoder;
+        encoder.add(entry);
+        if (!stageEncoded()) {
+            encoder = before;
+            droppedEntries++;
+            return;
+        }
+        entryCount++;
+    } else {
+        char line[MAX_STAGED_ENTRY];
+        if (!stage((const uint8_t*)line, LogDecoder::formatCSV(entry, line, sizeof(line)))) {
+            droppedEntries++;
+            return;
+        }
         entryCount++;
         
         if (entryCount >= MAX_LOG_ENTRIES) {
@@ -50,72 +98,216 @@ void DataLogger::logData(float temp, float target, float power, unsigned long re
 
 void DataLogger::startNewSession() {
     currentLogFileName = generateFileName();
-    logFile = SPIFFS.open(currentLogFileName, FILE_WRITE);
+    logStartTime = HAL::clock().millis();
+    entryCount = 0;
+    nextIndexTime = LOG_INDEX_INTERVAL;
     
-    if (logFile) {
-        logFile.println("Time(s),Temperature(C),Target(C),Power(%),Remaining(s)");
-        logStartTime = millis();
-        entryCount = 0;
-        DEBUG_PRINT(F("Started new log: "));
-        DEBUG_PRINTLN(currentLogFileName);
+    // A file without its header could not be read back
+    if (stagingRoom() < MAX_STAGED_ENTRY) {
+        DEBUG_PRINTLN(F("Log writer behind, session not started"));
+        sessionOpen = false;
+        return;
+    }
+    
+    // The writer opens the file once it reaches this point in the ring
+    sessionOpen = postEvent(LOG_EVENT_OPEN, currentLogFileName.c_str(), nullptr);
+    if (!sessionOpen) return;
+    if (binary) {
+        uint8_t header[LOG_HEADER_SIZE];
+        stage(header, encoder.begin(header, logStartTime));
+    } else {
+        stage((const uint8_t*)LOG_CSV_HEADER "\r\n", strlen(LOG_CSV_HEADER) + 2);
     }
+    DEBUG_PRINT(F("Started new log: "));
+    DEBUG_PRINTLN(currentLogFileName);
 }
 
 void DataLogger::endSession() {
-    if (logFile) {
-        logFile.close();
-        DEBUG_PRINTLN(F("Log session ended"));
+    if (!sessionOpen) return;
+    if (binary) {
+        // Fits by the room logData() keeps; a reader would otherwise take
+        // the stream for one cut short by a power loss
+        encoder.finish();
+        if (!stageEncoded()) {
+            DEBUG_PRINTLN(F("Log end marker not staged"));
+        }
     }
+    postEvent(LOG_EVENT_CLOSE, "", nullptr);
+    sessionOpen = false;
+    DEBUG_PRINTLN(F("Log session ended"));
 }
 
 String DataLogger::generateFileName() {
-    return "/log_" + String(millis()) + ".csv";
+    return "/log_" + String(HAL::clock().millis()) + (binary ? ".bin" : ".csv");
 }
 
-bool DataLogger::mountFileSystem() {
-    if (!SPIFFS.begin(true)) {
-        DEBUG_PRINTLN(F("SPIFFS mount failed"));
+size_t DataLogger::stagingRoom() {
+    size_t used = stagedBytes.load(std::memory_order_relaxed) - committedBytes.load(std::memory_order_acquire);
+    return LOG_STAGING_SIZE - used;
+}
+
+bool DataLogger::stage(const uint8_t* data, size_t length) {
+    size_t staged = stagedBytes.load(std::memory_order_relaxed);
+    if (length > stagingRoom()) {
+        return false;
+    }
+    for (size_t i = 0; i < length; i++) {
+        staging[(staged + i) % LOG_STAGING_SIZE] = data[i];
+    }
+    stagedBytes.store(staged + length, std::memory_order_release);
+    return true;
+}
+
+bool DataLogger::stageEncoded() {
+    // The partial byte stays in the encoder until the next sample completes
+    // it; bytes that found no room stay too, for the caller to take back
+    if (!stage(encoder.data(), encoder.available())) {
+        return false;
+    }
+    encoder.consume();
+    return true;
+}
+
+bool DataLogger::postEvent(LogEventKind kind, const char* fileName, const LogIndexEntry* index) {
+    LogSessionEvent event;
+    event.position = stagedBytes.load(std::memory_order_relaxed);
+    event.kind = kind;
+    if (index != nullptr) {
+        event.index = *index;
+    }
+    strncpy(event.fileName, fileName, sizeof(event.fileName) - 1);
+    event.fileName[sizeof(event.fileName) - 1] = '\0';
+    if (!sessionEvents.push(event)) {
+        DEBUG_PRINTLN(F("Log writer behind, session event dropped"));
         return false;
     }
-    
-    DEBUG_PRINTLN(F("SPIFFS mounted successfully"));
     return true;
 }
 
-bool DataLogger::exportToCSV(String& output) {
-    if (!currentLogFileName.isEmpty()) {
-        File file = SPIFFS.open(currentLogFileName, FILE_READ);
-        if (file) {
-            output = file.readString();
-            file.close();
-            return true;
+void DataLogger::commit() {
+    if (!enabled) return;
+    unsigned long now = HAL::clock().millis();
+    
+    // Everything staged before a session event belongs to the file it closes
+    LogSessionEvent event;
+    while (sessionEvents.peek(event)) {
+        writeStaged(event.position);
+        if (event.kind == LOG_EVENT_INDEX) {
+            if (indexFile) {
+                uint8_t bytes[LOG_INDEX_ENTRY_SIZE];
+                LogIndex::pack(event.index, bytes);
+                indexFile->write(bytes, sizeof(bytes));
+                indexFile->flush();
+            }
+        } else {
+            closeFiles();
+            if (event.kind == LOG_EVENT_OPEN) {
+                openFiles(event.fileName);
+            }
         }
+        sessionEvents.pop(event);
+    }
+    
+    size_t staged = stagedBytes.load(std::memory_order_acquire);
+    size_t pending = staged - committedBytes.load(std::memory_order_relaxed);
+    if (pending == 0) {
+        pendingSince = now;
+        return;
+    }
+    
+    // Whole pages, ending on a page boundary of the file; the rest once it
+    // has waited LOG_COMMIT_INTERVAL
+    size_t pageEnd = (fileBytes + pending) / LOG_PAGE_SIZE * LOG_PAGE_SIZE;
+    if (now - pendingSince >= LOG_COMMIT_INTERVAL) {
+        writeStaged(staged);
+    } else if (pageEnd > fileBytes) {
+        writeStaged(committedBytes.load(std::memory_order_relaxed) + pageEnd - fileBytes);
+    } else {
+        return;
+    }
+    if (logFile) {
+        logFile->flush();
+    }
+    pendingSince = now;
+    
+    if (getFreeSpace() < LOG_MIN_FREE_SPACE) {
+        storageLow = true;
     }
-    return false;
 }
 
-void DataLogger::clearAllLogs() {
-    File root = SPIFFS.open("/");
-    File file = root.openNextFile();
+void DataLogger::openFiles(const char* fileName) {
+    logFile = HAL::fs().open(fileName, "w");
+    fileBytes = 0;
     
-    while (file) {
-        String fileName = file.name();
-        file.close();
-        
-        if (fileName.startsWith("/log_")) {
-            SPIFFS.remove(fileName);
+    size_t length = strlen(fileName);
+    if (length > 4 && strcmp(fileName + length - 4, ".bin") == 0) {
+        char indexName[sizeof(LogSessionEvent::fileName)];
+        snprintf(indexName, sizeof(indexName), "%.*s.idx", (int)length - 4, fileName);
+        indexFile = HAL::fs().open(indexName, "w");
+        if (indexFile) {
+            uint8_t header[LOG_INDEX_HEADER_SIZE];
+            indexFile->write(header, LogIndex::writeHeader(header));
         }
-        
-        file = root.openNextFile();
+    }
+}
+
+void DataLogger::closeFiles() {
+    if (logFile) {
+        logFile->close();
+        delete logFile;
+        logFile = nullptr;
+    }
+    if (indexFile) {
+        indexFile->close();
+        delete indexFile;
+        indexFile = nullptr;
+    }
+}
+
+void DataLogger::writeStaged(size_t until) {
+    size_t committed = committedBytes.load(std::memory_order_relaxed);
+    while (committed < until) {
+        // Up to the end of the ring, then from its start
+        size_t index = committed % LOG_STAGING_SIZE;
+        size_t length = min(until - committed, LOG_STAGING_SIZE - index);
+        if (logFile) {
+            logFile->write(staging + index, length);
+            fileBytes += length;
+        }
+        committed += length;
+    }
+    committedBytes.store(committed, std::memory_order_release);
+}
+
+bool DataLogger::mountFileSystem() {
+    if (!HAL::fs().begin(true)) {
+        DEBUG_PRINTLN(F("SPIFFS mount failed"));
+        return false;
     }
     
-    root.close();
+    DEBUG_PRINTLN(F("SPIFFS mounted successfully"));
+    return true;
+}
+
+void DataLogger::clearAllLogs() {
+    // Collect first, removing while iterating would invalidate the listing
+    std::vector<String> logFiles;
+    HAL::fs().listFiles([&logFiles](const char* path, size_t) {
+        String fileName = path;
+        if (fileName.startsWith("/log_")) {
+            logFiles.push_back(fileName);
+        }
+    });
+    
+    for (const String& fileName : logFiles) {
+        HAL::fs().remove(fileName.c_str());
+    }
 }
 
 size_t DataLogger::getUsedSpace() {
-    return SPIFFS.usedBytes();
+    return HAL::fs().usedBytes();
 }
 
 size_t DataLogger::getFreeSpace() {
-    return SPIFFS.totalBytes() - SPIFFS.usedBytes();
+    return HAL::fs().totalBytes() - HAL::fs().usedBytes();
 }
\ No newline at end of file
@@ -18,7 +18,7 @@ Display::~Display() {
 
 bool Display::begin() {
     // Initialize I2C
-    Wire.begin(OLED_SDA, OLED_SCL);
+    HAL::i2c().begin(OLED_SDA, OLED_SCL);
     
     // Create OLED object
     oled = new Adafruit_SSD1306(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, -1);
@@ -47,7 +47,7 @@ void Display::clear() {
 void Display::update() {
     if (!displayEnabled) return;
     
-    unsigned long currentTime = millis();
+    unsigned long currentTime = HAL::clock().millis();
     if (currentTime - animationTimer >= 500) {
         animationTimer = currentTime;
         animationFrame = (animationFrame + 1) % 4;
@@ -298,6 +298,33 @@ void Display::showWiFiConfigScreen(const char* ssid, const char* ip) {
     oled->display();
 }
 
+void Display::showAutoTuneScreen(float currentTemp, float targetTemp, float power) {
+    oled->clearDisplay();
+    
+    drawHeader("AUTO TUNE");
+    
+    oled->setTextSize(1);
+    oled->setCursor(0, 16);
+    oled->print("Temp:");
+    oled->setTextSize(2);
+    oled->setCursor(35, 12);
+    oled->print(formatTemperature(currentTemp));
+    
+    oled->setTextSize(1);
+    oled->setCursor(0, 32);
+    oled->print("Set:");
+    oled->setCursor(35, 32);
+    oled->print(formatTemperature(targetTemp));
+    
+    oled->setCursor(0, 48);
+    oled->print("Power:");
+    drawProgressBar(40, 48, 80, 6, power);
+    
+    drawFooter("Hold to cancel");
+    
+    oled->display();
+}
+
 void Display::updateScreen(SystemState state, float currentTemp, float targetTemp, 
                           unsigned long totalTime, unsigned long remainingTime, float power) {
     if (state != lastState) {
@@ -324,6 +351,9 @@ void Display::updateScreen(SystemState state, float currentTemp, float targetTem
         case STATE_FINISHED:
             showFinishedScreen();
             break;
+        case STATE_AUTOTUNE:
+            showAutoTuneScreen(currentTemp, targetTemp, power);
+            break;
         default:
             break;
     }
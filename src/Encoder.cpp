@@ -52,13 +52,13 @@ void Encoder::begin(uint8_t _pinA, uint8_t _pinB, uint8_t _pinButton) {
     pinButton = _pinButton;
     
     // Configure encoder pins
-    pinMode(pinA, INPUT_PULLUP);
-    pinMode(pinB, INPUT_PULLUP);
-    pinMode(pinButton, INPUT_PULLUP);
+    HAL::gpio().pinMode(pinA, INPUT_PULLUP);
+    HAL::gpio().pinMode(pinB, INPUT_PULLUP);
+    HAL::gpio().pinMode(pinButton, INPUT_PULLUP);
     
     // Read initial state
-    uint8_t a = digitalRead(pinA);
-    uint8_t b = digitalRead(pinB);
+    uint8_t a = HAL::gpio().digitalRead(pinA);
+    uint8_t b = HAL::gpio().digitalRead(pinB);
     encoderState = (a << 1) | b;
     
     // Attach interrupts
@@ -69,8 +69,8 @@ void Encoder::begin(uint8_t _pinA, uint8_t _pinB, uint8_t _pinButton) {
 
 void Encoder::update() {
     // Update button state
-    bool currentButtonState = digitalRead(pinButton);
-    unsigned long currentTime = millis();
+    bool currentButtonState = HAL::gpio().digitalRead(pinButton);
+    unsigned long currentTime = HAL::clock().millis();
     
     // Debounce button
     if (currentButtonState != lastButtonState) {
@@ -142,8 +142,8 @@ void IRAM_ATTR Encoder::handleInterrupt() {
 }
 
 void IRAM_ATTR Encoder::updateEncoder() {
-    uint8_t a = digitalRead(pinA);
-    uint8_t b = digitalRead(pinB);
+    uint8_t a = HAL::gpio().digitalRead(pinA);
+    uint8_t b = HAL::gpio().digitalRead(pinB);
     uint8_t newState = (a << 1) | b;
     uint8_t tableIndex = (encoderState << 2) | newState;
     int8_t motion = encoderTable[tableIndex];
@@ -286,13 +286,13 @@ int Encoder::mapToInt(int min, int max, int step) {
 }
 
 void Encoder::attachInterrupts() {
-    attachInterrupt(digitalPinToInterrupt(pinA), handleInterrupt, CHANGE);
-    attachInterrupt(digitalPinToInterrupt(pinB), handleInterrupt, CHANGE);
+    HAL::gpio().attachInterrupt(pinA, handleInterrupt, CHANGE);
+    HAL::gpio().attachInterrupt(pinB, handleInterrupt, CHANGE);
 }
 
 void Encoder::detachInterrupts() {
-    detachInterrupt(digitalPinToInterrupt(pinA));
-    detachInterrupt(digitalPinToInterrupt(pinB));
+    HAL::gpio().detachInterrupt(pinA);
+    HAL::gpio().detachInterrupt(pinB);
 }
 
 void Encoder::setDebounceTime(unsigned long time) {
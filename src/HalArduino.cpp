@@ -0,0 +1,287 @@
+#ifdef ARDUINO
+
+#include "../include/HAL.h"
+#include <Wire.h>
+#include <SPIFFS.h>
+#include <OneWire.h>
+#include <DallasTemperature.h>
+#include <AsyncTCP.h>
+
+// ESP32 backend: thin forwarding to the Arduino core and device libraries
+
+class ArduinoClock : public HalClock {
+public:
+    unsigned long millis() override { return ::millis(); }
+    unsigned long micros() override { return ::micros(); }
+    void delay(unsigned long ms) override { ::delay(ms); }
+};
+
+class ArduinoGpio : public HalGpio {
+public:
+    void pinMode(uint8_t pin, uint8_t mode) override { ::pinMode(pin, mode); }
+    // Called from the SSRControl and Encoder interrupts
+    void IRAM_ATTR digitalWrite(uint8_t pin, uint8_t value) override { ::digitalWrite(pin, value); }
+    int IRAM_ATTR digitalRead(uint8_t pin) override { return ::digitalRead(pin); }
+
+    void attachInterrupt(uint8_t pin, void (*handler)(), int mode) override {
+        ::attachInterrupt(digitalPinToInterrupt(pin), handler, mode);
+    }
+
+    void detachInterrupt(uint8_t pin) override {
+        ::detachInterrupt(digitalPinToInterrupt(pin));
+    }
+};
+
+class ArduinoOneWire : public HalOneWire {
+private:
+    OneWire* oneWire;
+    DallasTemperature* sensors;
+
+public:
+    ArduinoOneWire() : oneWire(nullptr), sensors(nullptr) {}
+
+    void begin(uint8_t pin) override {
+        if (sensors != nullptr) return;
+        oneWire = new OneWire(pin);
+        sensors = new DallasTemperature(oneWire);
+        sensors->begin();
+        // Resolution writes stay in the scratchpad: copying it to EEPROM
+        // blocks for tens of ms and wears the probe
+        sensors->setAutoSaveScratchPad(false);
+    }
+
+    int getDeviceCount() override { return sensors->getDeviceCount(); }
+
+    bool getAddress(OneWireAddress address, int index) override {
+        return sensors->getAddress(address, index);
+    }
+
+    bool isConnected(const OneWireAddress address) override {
+        return sensors->isConnected(address);
+    }
+
+    void setResolution(const OneWireAddress address, uint8_t bits) override {
+        // Only this probe: the global resolution would read every other one
+        sensors->setResolution(address, bits, true);
+    }
+
+    uint8_t getResolution(const OneWireAddress address) override {
+        return sensors->getResolution(address);
+    }
+
+    void setWaitForConversion(bool wait) override { sensors->setWaitForConversion(wait); }
+    void requestTemperatures() override { sensors->requestTemperatures(); }
+
+    bool requestTemperature(const OneWireAddress address) override {
+        // DallasTemperature::requestTemperaturesByAddress() reads the
+        // scratchpad for the resolution first; address the convert directly
+        if (!oneWire->reset()) return false;
+        oneWire->select(address);
+        oneWire->write(0x44, sensors->isParasitePowerMode());  // CONVERT T
+        return true;
+    }
+
+    float getTempC(const OneWireAddress address) override {
+        float temp = sensors->getTempC(address);
+        return temp == DEVICE_DISCONNECTED_C ? SENSOR_ERROR_TEMP : temp;
+    }
+};
+
+class ArduinoI2C : public HalI2C {
+public:
+    bool begin(int sda, int scl) override { return Wire.begin(sda, scl); }
+    void setClock(uint32_t frequency) override { Wire.setClock(frequency); }
+
+    uint8_t write(uint8_t address, const uint8_t* data, size_t length) override {
+        Wire.beginTransmission(address);
+        Wire.write(data, length);
+        return Wire.endTransmission();
+    }
+
+    size_t read(uint8_t address, uint8_t* data, size_t length) override {
+        size_t received = Wire.requestFrom(address, length);
+        for (size_t i = 0; i < received; i++) {
+            data[i] = Wire.read();
+        }
+        return received;
+    }
+};
+
+class ArduinoFile : public HalFile {
+private:
+    File file;
+
+public:
+    explicit ArduinoFile(File f) : file(f) {}
+    ~ArduinoFile() { close(); }
+
+    size_t write(const uint8_t* buffer, size_t size) override { return file.write(buffer, size); }
+    int read(uint8_t* buffer, size_t size) override { return file.read(buffer, size); }
+    int available() override { return file.available(); }
+    bool seek(size_t position) override { return file.seek(position); }
+    size_t position() override { return file.position(); }
+    size_t size() override { return file.size(); }
+    void flush() override { file.flush(); }
+
+    void close() override {
+        if (file) file.close();
+    }
+};
+
+class ArduinoFileSystem : public HalFileSystem {
+public:
+    bool begin(bool formatOnFail) override { return SPIFFS.begin(formatOnFail); }
+
+    HalFile* open(const char* path, const char* mode) override {
+        File file = SPIFFS.open(path, mode);
+        if (!file) return nullptr;
+        return new ArduinoFile(file);
+    }
+
+    bool exists(const char* path) override { return SPIFFS.exists(path); }
+    bool remove(const char* path) override { return SPIFFS.remove(path); }
+
+    void listFiles(std::function<void(const char* path, size_t size)> callback) override {
+        File root = SPIFFS.open("/");
+        File file = root.openNextFile();
+        while (file) {
+            String path = file.path();
+            size_t size = file.size();
+            file.close();
+            callback(path.c_str(), size);
+            file = root.openNextFile();
+        }
+        root.close();
+    }
+
+    size_t usedBytes() override { return SPIFFS.usedBytes(); }
+    size_t totalBytes() override { return SPIFFS.totalBytes(); }
+};
+
+class ArduinoTimer : public HalTimer {
+private:
+    hw_timer_t* timer;
+
+public:
+    ArduinoTimer() : timer(nullptr) {}
+
+    void begin(void (*callback)()) override {
+        if (timer != nullptr) return;
+        // Timer 0 at 80 MHz / 80: one count per microsecond, counting up
+        timer = timerBegin(0, 80, true);
+        timerAttachInterrupt(timer, callback, true);
+    }
+
+    // Called from SSRControl's interrupts
+    uint64_t IRAM_ATTR nowMicros() override { return timerRead(timer); }
+
+    void IRAM_ATTR alarmAt(uint64_t timeUs) override {
+        // An alarm behind the counter would only fire after it wrapped
+        uint64_t earliest = timerRead(timer) + 5;
+        timerAlarmWrite(timer, timeUs > earliest ? timeUs : earliest, false);
+        timerAlarmEnable(timer);
+    }
+
+    void cancel() override { timerAlarmDisable(timer); }
+};
+
+// AsyncTCP calls back from its own task; each slot carries the index the
+// listener knows the connection by
+class ArduinoTcpServer : public HalTcpServer {
+private:
+    struct Slot {
+        ArduinoTcpServer* owner;
+        int index;
+        AsyncClient* client;
+    };
+
+    AsyncServer* server;
+    Listener* listener;
+    Slot slots[HTTP_MAX_CONNECTIONS];
+
+    void accept(AsyncClient* client) {
+        Slot* slot = nullptr;
+        for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+            if (slots[i].client == nullptr) {
+                slot = &slots[i];
+                break;
+            }
+        }
+        if (slot == nullptr) {
+            client->close(true);
+            delete client;
+            return;
+        }
+
+        slot->client = client;
+        client->setNoDelay(true);
+        client->setRxTimeout(HTTP_IDLE_TIMEOUT / 1000);
+        client->onData([](void* arg, AsyncClient*, void* data, size_t length) {
+            Slot* s = static_cast<Slot*>(arg);
+            s->owner->listener->onData(s->index, static_cast<const uint8_t*>(data), length);
+        }, slot);
+        client->onAck([](void* arg, AsyncClient*, size_t, uint32_t) {
+            Slot* s = static_cast<Slot*>(arg);
+            s->owner->listener->onSent(s->index);
+        }, slot);
+        client->onTimeout([](void*, AsyncClient* c, uint32_t) { c->close(); }, slot);
+        client->onDisconnect([](void* arg, AsyncClient* c) {
+            Slot* s = static_cast<Slot*>(arg);
+            s->client = nullptr;
+            s->owner->listener->onDisconnect(s->index);
+            delete c;
+        }, slot);
+        listener->onConnect(slot->index);
+    }
+
+public:
+    ArduinoTcpServer() : server(nullptr), listener(nullptr) {
+        for (int i = 0; i < HTTP_MAX_CONNECTIONS; i++) {
+            slots[i] = Slot{this, i, nullptr};
+        }
+    }
+
+    bool begin(uint16_t port, Listener* handler) override {
+        if (server != nullptr) return true;
+        listener = handler;
+        server = new AsyncServer(port);
+        server->onClient([](void* arg, AsyncClient* client) {
+            static_cast<ArduinoTcpServer*>(arg)->accept(client);
+        }, this);
+        server->begin();
+        return true;
+    }
+
+    size_t write(int connection, const uint8_t* data, size_t length) override {
+        AsyncClient* client = slots[connection].client;
+        if (client == nullptr) return 0;
+        size_t room = client->space();
+        if (room == 0) return 0;
+        size_t taken = client->add(reinterpret_cast<const char*>(data), length < room ? length : room);
+        client->send();
+        return taken;
+    }
+
+    void close(int connection) override {
+        AsyncClient* client = slots[connection].client;
+        if (client != nullptr) client->close();
+    }
+};
+
+static ArduinoClock arduinoClock;
+static ArduinoGpio arduinoGpio;
+static ArduinoOneWire arduinoOneWire;
+static ArduinoI2C arduinoI2C;
+static ArduinoFileSystem arduinoFileSystem;
+static ArduinoTimer arduinoTimer;
+static ArduinoTcpServer arduinoTcpServer;
+
+HalClock& HAL::clock() { return arduinoClock; }
+HalGpio& IRAM_ATTR HAL::gpio() { return arduinoGpio; }
+HalOneWire& HAL::oneWire() { return arduinoOneWire; }
+HalI2C& HAL::i2c() { return arduinoI2C; }
+HalFileSystem& HAL::fs() { return arduinoFileSystem; }
+HalTimer& IRAM_ATTR HAL::timer() { return arduinoTimer; }
+HalTcpServer& HAL::tcpServer() { return arduinoTcpServer; }
+
+#endif // ARDUINO
@@ -0,0 +1,168 @@
+#include "../include/JsonWriter.h"
+#include <math.h>
+
+static const uint32_t POWERS_OF_TEN[] = {1, 10, 100, 1000, 10000, 100000, 1000000};
+
+JsonWriter::JsonWriter(char* buffer, size_t size) {
+    this->buffer = buffer;
+    this->size = size;
+    length = 0;
+    overflowed = size == 0;
+    depth = 0;
+    needComma[0] = false;
+    inArray[0] = false;
+}
+
+void JsonWriter::put(char c) {
+    // One byte always stays free for the terminator
+    if (length + 1 >= size) {
+        overflowed = true;
+        return;
+    }
+    buffer[length++] = c;
+}
+
+void JsonWriter::put(const char* text) {
+    while (*text != '\0' && !overflowed) {
+        put(*text++);
+    }
+}
+
+void JsonWriter::putUnsigned(uint64_t value) {
+    char digits[20];
+    int count = 0;
+    do {
+        digits[count++] = '0' + value % 10;
+        value /= 10;
+    } while (value != 0);
+    while (count > 0) {
+        put(digits[--count]);
+    }
+}
+
+void JsonWriter::key(const char* name) {
+    if (needComma[depth]) put(',');
+    needComma[depth] = true;
+    if (depth > 0 && !inArray[depth] && name != nullptr) {
+        put('"');
+        put(name);
+        put("\":");
+    }
+}
+
+void JsonWriter::begin(const char* name, char bracket, bool array) {
+    if (depth >= MAX_DEPTH) {
+        overflowed = true;
+        return;
+    }
+    key(name);
+    put(bracket);
+    depth++;
+    needComma[depth] = false;
+    inArray[depth] = array;
+}
+
+void JsonWriter::end(char bracket, bool array) {
+    if (depth == 0 || inArray[depth] != array) {
+        overflowed = true;
+        return;
+    }
+    depth--;
+    put(bracket);
+}
+
+void JsonWriter::beginObject(const char* name) {
+    begin(name, '{', false);
+}
+
+void JsonWriter::endObject() {
+    end('}', false);
+}
+
+void JsonWriter::beginArray(const char* name) {
+    begin(name, '[', true);
+}
+
+void JsonWriter::endArray() {
+    end(']', true);
+}
+
+void JsonWriter::addInt(const char* name, long value) {
+    key(name);
+    if (value < 0) {
+        put('-');
+        putUnsigned(-(uint64_t)(int64_t)value);
+    } else {
+        putUnsigned(value);
+    }
+}
+
+void JsonWriter::addUnsigned(const char* name, unsigned long value) {
+    key(name);
+    putUnsigned(value);
+}
+
+void JsonWriter::addFloat(const char* name, float value, uint8_t decimals) {
+    if (!isfinite(value)) {
+        addNull(name);
+        return;
+    }
+    key(name);
+    if (decimals > 6) decimals = 6;
+    uint32_t scale = POWERS_OF_TEN[decimals];
+
+    // Round once at the requested resolution, then split; -0.0 prints as 0
+    double scaled = fabs((double)value) * scale + 0.5;
+    if (scaled >= 1e18) {
+        overflowed = true;      // beyond what a status field can mean
+        return;
+    }
+    uint64_t fixed = (uint64_t)scaled;
+    if (value < 0 && fixed != 0) put('-');
+    putUnsigned(fixed / scale);
+    if (decimals > 0) {
+        put('.');
+        uint32_t fraction = fixed % scale;
+        for (uint32_t digit = scale / 10; digit > 0; digit /= 10) {
+            put('0' + fraction / digit % 10);
+        }
+    }
+}
+
+void JsonWriter::addBool(const char* name, bool value) {
+    key(name);
+    put(value ? "true" : "false");
+}
+
+void JsonWriter::addString(const char* name, const char* value) {
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+    key(name);
+    put('"');
+    for (const char* c = value; *c != '\0' && !overflowed; c++) {
+        if (*c == '"' || *c == '\\') {
+            put('\\');
+            put(*c);
+        } else if ((uint8_t)*c < 0x20) {
+            put("\\u00");
+            put(HEX_DIGITS[(uint8_t)*c >> 4]);
+            put(HEX_DIGITS[*c & 0x0F]);
+        } else {
+            put(*c);
+        }
+    }
+    put('"');
+}
+
+void JsonWriter::addNull(const char* name) {
+    key(name);
+    put("null");
+}
+
+size_t JsonWriter::finish() {
+    if (overflowed || depth != 0) {
+        if (size > 0) buffer[0] = '\0';
+        return 0;
+    }
+    buffer[length] = '\0';
+    return length;
+}
@@ -0,0 +1,354 @@
+#include "../include/LogCodec.h"
+
+static const int FIELD_TEMPERATURE = 0;
+static const int FIELD_TARGET = 1;
+static const int FIELD_POWER = 2;
+
+static const uint8_t NO_WINDOW = 32;
+
+static uint32_t zigzag(int32_t value) {
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static int32_t unzigzag(uint32_t value) {
+    return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+}
+
+static uint32_t floatBits(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static void putLittleEndian(uint8_t* out, uint32_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        out[i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static uint32_t getLittleEndian(const uint8_t* in, int bytes) {
+    uint32_t value = 0;
+    for (int i = 0; i < bytes; i++) {
+        value |= (uint32_t)in[i] << (8 * i);
+    }
+    return value;
+}
+
+static void resetState(LogCodecState& state) {
+    memset(&state, 0, sizeof(state));
+    for (int field = 0; field < 3; field++) {
+        state.lastLeading[field] = NO_WINDOW;
+    }
+}
+
+// --- LogEncoder
+
+LogEncoder::LogEncoder() {
+    uint8_t header[LOG_HEADER_SIZE];
+    begin(header, 0);
+}
+
+size_t LogEncoder::begin(uint8_t* header, unsigned long startTime) {
+    memset(buffer, 0, sizeof(buffer));
+    bitCount = 0;
+    consumedBytes = 0;
+    resetState(state);
+
+    memset(header, 0, LOG_HEADER_SIZE);
+    memcpy(header, LOG_MAGIC, 4);
+    header[4] = LOG_VERSION;
+    header[5] = LOG_TEMPERATURE_BITS;
+    header[6] = LOG_POWER_BITS;
+    putLittleEndian(header + 8, LOG_TIME_UNIT, 2);
+    putLittleEndian(header + 12, DATA_LOG_INTERVAL, 4);
+    putLittleEndian(header + 16, startTime, 4);
+    return LOG_HEADER_SIZE;
+}
+
+void LogEncoder::writeBits(uint32_t value, int bits) {
+    for (int i = bits - 1; i >= 0; i--) {
+        if ((value >> i) & 1) {
+            buffer[bitCount >> 3] |= 0x80 >> (bitCount & 7);
+        }
+        bitCount++;
+    }
+}
+
+void LogEncoder::writeDelta(int32_t deltaOfDelta) {
+    uint32_t value = zigzag(deltaOfDelta);
+    if (value == 0) {
+        writeBits(0, 1);
+    } else if (value < (1u << 7)) {
+        writeBits(0x2, 2);
+        writeBits(value, 7);
+    } else if (value < (1u << 9)) {
+        writeBits(0x6, 3);
+        writeBits(value, 9);
+    } else if (value < (1u << 12)) {
+        writeBits(0xE, 4);
+        writeBits(value, 12);
+    } else {
+        writeBits(0x1E, 5);
+        writeBits(value, 32);
+    }
+}
+
+void LogEncoder::writeValue(int field, float value) {
+    uint32_t bits = floatBits(value);
+    uint32_t difference = bits ^ state.lastValue[field];
+    state.lastValue[field] = bits;
+    if (difference == 0) {
+        writeBits(0, 1);
+        return;
+    }
+
+    int leading = min(__builtin_clz(difference), 31);
+    int trailing = __builtin_ctz(difference);
+    if (state.lastLeading[field] != NO_WINDOW && leading >= state.lastLeading[field] &&
+        trailing >= state.lastTrailing[field]) {
+        // Fits the previous window: no need to repeat its position
+        writeBits(0x2, 2);
+        writeBits(difference >> state.lastTrailing[field], 32 - state.lastLeading[field] - state.lastTrailing[field]);
+        return;
+    }
+
+    int length = 32 - leading - trailing;
+    writeBits(0x3, 2);
+    writeBits(leading, 5);
+    writeBits(length - 1, 5);
+    writeBits(difference >> trailing, length);
+    state.lastLeading[field] = leading;
+    state.lastTrailing[field] = trailing;
+}
+
+void LogEncoder::add(const LogEntry& entry) {
+    uint32_t time = (entry.timestamp + LOG_TIME_UNIT / 2) / LOG_TIME_UNIT;
+    int32_t timeDelta = (int32_t)(time - state.lastTime);
+    writeDelta(timeDelta - state.lastTimeDelta);
+    state.lastTime = time;
+    state.lastTimeDelta = timeDelta;
+
+    writeValue(FIELD_TEMPERATURE, quantize(entry.temperature, LOG_TEMPERATURE_BITS));
+    writeValue(FIELD_TARGET, quantize(entry.targetTemp, LOG_TEMPERATURE_BITS));
+    writeValue(FIELD_POWER, quantize(entry.power, LOG_POWER_BITS));
+
+    uint32_t remaining = entry.remainingTime;
+    int32_t remainingDelta = (int32_t)(remaining - state.lastRemaining);
+    writeDelta(remainingDelta - state.lastRemainingDelta);
+    state.lastRemaining = remaining;
+    state.lastRemainingDelta = remainingDelta;
+}
+
+void LogEncoder::finish() {
+    writeBits(0x1F, 5);
+    bitCount = (bitCount + 7) & ~(size_t)7;
+}
+
+void LogEncoder::consume() {
+    size_t bytes = bitCount / 8;
+    consumedBytes += bytes;
+    uint8_t partial = buffer[bytes];
+    memset(buffer, 0, sizeof(buffer));
+    buffer[0] = (bitCount & 7) != 0 ? partial : 0;
+    bitCount &= 7;
+}
+
+LogIndexEntry LogEncoder::indexEntry() const {
+    LogIndexEntry entry;
+    entry.bitOffset = (uint32_t)((LOG_HEADER_SIZE + consumedBytes) * 8 + bitCount);
+    entry.state = state;
+    return entry;
+}
+
+float LogEncoder::quantize(float value, int fractionBits) {
+    float scale = (float)(1L << fractionBits);
+    return roundf(value * scale) / scale;
+}
+
+// --- LogDecoder
+
+LogDecoder::LogDecoder(Source source) : source(source) {
+    length = 0;
+    bitIndex = 0;
+    exhausted = false;
+    complete = false;
+    memset(&header, 0, sizeof(header));
+
+    resetState(state);
+}
+
+bool LogDecoder::begin() {
+    uint8_t bytes[LOG_HEADER_SIZE];
+    size_t received = 0;
+    while (received < LOG_HEADER_SIZE) {
+        int count = source(bytes + received, LOG_HEADER_SIZE - received);
+        if (count <= 0) return false;
+        received += count;
+    }
+    if (memcmp(bytes, LOG_MAGIC, 4) != 0 || bytes[4] != LOG_VERSION) {
+        return false;
+    }
+
+    header.version = bytes[4];
+    header.temperatureBits = bytes[5];
+    header.powerBits = bytes[6];
+    header.timeUnit = (uint16_t)getLittleEndian(bytes + 8, 2);
+    header.interval = getLittleEndian(bytes + 12, 4);
+    header.startTime = getLittleEndian(bytes + 16, 4);
+    return header.timeUnit > 0;
+}
+
+bool LogDecoder::readBits(int bits, uint32_t& value) {
+    value = 0;
+    for (int i = 0; i < bits; i++) {
+        if (bitIndex == length * 8) {
+            int count = exhausted ? 0 : source(buffer, sizeof(buffer));
+            if (count <= 0) {
+                exhausted = true;
+                return false;
+            }
+            length = count;
+            bitIndex = 0;
+        }
+        value = (value << 1) | ((buffer[bitIndex >> 3] >> (7 - (bitIndex & 7))) & 1);
+        bitIndex++;
+    }
+    return true;
+}
+
+bool LogDecoder::readDelta(int32_t& deltaOfDelta, bool& end) {
+    // Count the leading ones of the prefix, up to five
+    int ones = 0;
+    uint32_t bit = 1;
+    while (ones < 5) {
+        if (!readBits(1, bit)) return false;
+        if (bit == 0) break;
+        ones++;
+    }
+
+    static const int WIDTHS[] = {0, 7, 9, 12, 32};
+    end = false;
+    if (ones == 5) {
+        end = true;
+        return true;
+    }
+
+    uint32_t value = 0;
+    if (ones > 0 && !readBits(WIDTHS[ones], value)) return false;
+    deltaOfDelta = unzigzag(value);
+    return true;
+}
+
+bool LogDecoder::readValue(int field, float& value) {
+    uint32_t control;
+    if (!readBits(1, control)) return false;
+    if (control == 1) {
+        if (!readBits(1, control)) return false;
+        uint32_t difference;
+        if (control == 0) {
+            if (state.lastLeading[field] == NO_WINDOW) return false;
+            int bits = 32 - state.lastLeading[field] - state.lastTrailing[field];
+            if (!readBits(bits, difference)) return false;
+            difference <<= state.lastTrailing[field];
+        } else {
+            uint32_t leading, length;
+            if (!readBits(5, leading) || !readBits(5, length)) return false;
+            length += 1;
+            if (leading + length > 32) return false;
+            if (!readBits(length, difference)) return false;
+            state.lastLeading[field] = leading;
+            state.lastTrailing[field] = 32 - leading - length;
+            difference <<= state.lastTrailing[field];
+        }
+        state.lastValue[field] ^= difference;
+    }
+    memcpy(&value, &state.lastValue[field], sizeof(value));
+    return true;
+}
+
+bool LogDecoder::next(LogEntry& entry) {
+    if (complete) return false;
+
+    bool end;
+    int32_t deltaOfDelta;
+    if (!readDelta(deltaOfDelta, end)) return false;
+    if (end) {
+        complete = true;
+        return false;
+    }
+    state.lastTimeDelta += deltaOfDelta;
+    state.lastTime += state.lastTimeDelta;
+    entry.timestamp = state.lastTime * header.timeUnit;
+
+    if (!readValue(FIELD_TEMPERATURE, entry.temperature) ||
+        !readValue(FIELD_TARGET, entry.targetTemp) ||
+        !readValue(FIELD_POWER, entry.power)) {
+        return false;
+    }
+
+    if (!readDelta(deltaOfDelta, end) || end) return false;
+    state.lastRemainingDelta += deltaOfDelta;
+    state.lastRemaining += state.lastRemainingDelta;
+    entry.remainingTime = state.lastRemaining;
+    return true;
+}
+
+bool LogDecoder::resume(const LogIndexEntry& entry) {
+    if (entry.bitOffset < LOG_HEADER_SIZE * 8) return false;
+    state = entry.state;
+    length = 0;
+    bitIndex = 0;
+    exhausted = false;
+    complete = false;
+    // The record starts inside the byte the source continues at
+    uint32_t skipped;
+    return readBits(entry.bitOffset % 8, skipped);
+}
+
+size_t LogDecoder::formatCSV(const LogEntry& entry, char* line, size_t size) {
+    int length = snprintf(line, size, "%lu,%.2f,%.2f,%.1f,%lu\r\n", entry.timestamp / 1000,
+                          entry.temperature, entry.targetTemp, entry.power, entry.remainingTime);
+    return length > 0 && (size_t)length < size ? length : 0;
+}
+
+// --- LogIndex
+
+size_t LogIndex::writeHeader(uint8_t* header) {
+    memset(header, 0, LOG_INDEX_HEADER_SIZE);
+    memcpy(header, LOG_INDEX_MAGIC, 4);
+    header[4] = LOG_VERSION;
+    header[5] = LOG_INDEX_ENTRY_SIZE;
+    return LOG_INDEX_HEADER_SIZE;
+}
+
+bool LogIndex::checkHeader(const uint8_t* header) {
+    return memcmp(header, LOG_INDEX_MAGIC, 4) == 0 && header[4] == LOG_VERSION &&
+           header[5] == LOG_INDEX_ENTRY_SIZE;
+}
+
+void LogIndex::pack(const LogIndexEntry& entry, uint8_t* bytes) {
+    memset(bytes, 0, LOG_INDEX_ENTRY_SIZE);
+    putLittleEndian(bytes, entry.bitOffset, 4);
+    putLittleEndian(bytes + 4, entry.state.lastTime, 4);
+    putLittleEndian(bytes + 8, (uint32_t)entry.state.lastTimeDelta, 4);
+    putLittleEndian(bytes + 12, entry.state.lastRemaining, 4);
+    putLittleEndian(bytes + 16, (uint32_t)entry.state.lastRemainingDelta, 4);
+    for (int field = 0; field < 3; field++) {
+        putLittleEndian(bytes + 20 + 4 * field, entry.state.lastValue[field], 4);
+        bytes[32 + field] = entry.state.lastLeading[field];
+        bytes[35 + field] = entry.state.lastTrailing[field];
+    }
+}
+
+void LogIndex::unpack(const uint8_t* bytes, LogIndexEntry& entry) {
+    entry.bitOffset = getLittleEndian(bytes, 4);
+    entry.state.lastTime = getLittleEndian(bytes + 4, 4);
+    entry.state.lastTimeDelta = (int32_t)getLittleEndian(bytes + 8, 4);
+    entry.state.lastRemaining = getLittleEndian(bytes + 12, 4);
+    entry.state.lastRemainingDelta = (int32_t)getLittleEndian(bytes + 16, 4);
+    for (int field = 0; field < 3; field++) {
+        entry.state.lastValue[field] = getLittleEndian(bytes + 20 + 4 * field, 4);
+        entry.state.lastLeading[field] = bytes[32 + field];
+        entry.state.lastTrailing[field] = bytes[35 + field];
+    }
+}
@@ -0,0 +1,276 @@
+#include "../include/LogHistory.h"
+
+// --- LogHistory::Cursor
+
+LogHistory::Cursor::Cursor() : file(nullptr), decoder([this](uint8_t* buffer, size_t size) {
+    return file != nullptr ? file->read(buffer, size) : 0;
+}) {
+    hasPending = false;
+    decoded = 0;
+}
+
+LogHistory::Cursor::~Cursor() {
+    close();
+}
+
+bool LogHistory::Cursor::open(const char* path, const LogIndexEntry* start) {
+    close();
+    file = HAL::fs().open(path, "r");
+    if (file == nullptr) return false;
+    decoder = LogDecoder([this](uint8_t* buffer, size_t size) {
+        return file != nullptr ? file->read(buffer, size) : 0;
+    });
+    if (!decoder.begin()) return false;
+    if (start != nullptr) {
+        return file->seek(start->bitOffset / 8) && decoder.resume(*start);
+    }
+    return true;
+}
+
+void LogHistory::Cursor::close() {
+    if (file != nullptr) {
+        file->close();
+        delete file;
+        file = nullptr;
+    }
+    hasPending = false;
+}
+
+bool LogHistory::Cursor::peek(LogEntry& entry) {
+    if (!hasPending) {
+        if (file == nullptr || !decoder.next(pending)) return false;
+        hasPending = true;
+        decoded++;
+    }
+    entry = pending;
+    return true;
+}
+
+// --- LogHistory
+
+LogHistory::LogHistory() {
+    path[0] = '\0';
+    memset(&header, 0, sizeof(header));
+    endTime = 0;
+    opened = false;
+    phase = PHASE_DONE;
+    buckets = 0;
+    spanEnd = 0;
+    hasLast = false;
+    averageTime = 0;
+    averageTemp = 0;
+}
+
+bool LogHistory::open(const char* logPath) {
+    opened = false;
+    if (strlen(logPath) >= sizeof(path)) return false;
+    strcpy(path, logPath);
+
+    // From the last index entry to the end of the log
+    LogIndexEntry start;
+    bool found = false;
+    if (!trail.open(path, nullptr)) return false;
+    header = trail.getHeader();
+    if (!findStart((unsigned long)-1, start, found)) return false;
+    if (found && !trail.open(path, &start)) return false;
+
+    endTime = found ? start.time(header.timeUnit) : 0;
+    LogEntry entry;
+    while (trail.peek(entry)) {
+        endTime = entry.timestamp;
+        trail.skip();
+    }
+    trail.close();
+    opened = true;
+    return true;
+}
+
+// The last index entry before time whose record is on flash; found is
+// false when the range starts before the first one or there is no index
+bool LogHistory::findStart(unsigned long time, LogIndexEntry& entry, bool& found) {
+    found = false;
+    char indexPath[sizeof(path)];
+    size_t length = strlen(path);
+    if (length < 4 || strcmp(path + length - 4, ".bin") != 0) return false;
+    snprintf(indexPath, sizeof(indexPath), "%.*s.idx", (int)length - 4, path);
+
+    HalFile* log = HAL::fs().open(path, "r");
+    if (log == nullptr) return false;
+    size_t logSize = log->size();
+    log->close();
+    delete log;
+
+    // Logs written before the index existed are decoded from the header
+    HalFile* index = HAL::fs().open(indexPath, "r");
+    if (index == nullptr) return true;
+    uint8_t bytes[LOG_INDEX_ENTRY_SIZE];
+    size_t count = 0;
+    if (index->read(bytes, LOG_INDEX_HEADER_SIZE) == LOG_INDEX_HEADER_SIZE && LogIndex::checkHeader(bytes)) {
+        count = (index->size() - LOG_INDEX_HEADER_SIZE) / LOG_INDEX_ENTRY_SIZE;
+    }
+
+    // Entries are in time and file order, so "before time and on flash"
+    // holds for a prefix of them
+    size_t low = 0, high = count;
+    while (low < high) {
+        size_t middle = (low + high) / 2;
+        LogIndexEntry candidate;
+        if (!index->seek(LOG_INDEX_HEADER_SIZE + middle * LOG_INDEX_ENTRY_SIZE) ||
+            index->read(bytes, LOG_INDEX_ENTRY_SIZE) != LOG_INDEX_ENTRY_SIZE) {
+            break;
+        }
+        LogIndex::unpack(bytes, candidate);
+        if (candidate.time(header.timeUnit) < time && candidate.bitOffset / 8 < logSize) {
+            entry = candidate;
+            found = true;
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    index->close();
+    delete index;
+    return true;
+}
+
+bool LogHistory::query(unsigned long from, unsigned long to, int points) {
+    phase = PHASE_DONE;
+    hasLast = false;
+    trail.decoded = 0;
+    lead.decoded = 0;
+    if (!opened) return false;
+    if (to > endTime) to = endTime;
+    if (from > to) return true;
+
+    LogIndexEntry start;
+    bool found;
+    if (!findStart(from, start, found) ||
+        !trail.open(path, found ? &start : nullptr) || !lead.open(path, found ? &start : nullptr)) {
+        return false;
+    }
+    LogEntry entry;
+    while (trail.peek(entry) && entry.timestamp < from) trail.skip();
+    while (lead.peek(entry) && entry.timestamp < from) lead.skip();
+    if (!trail.peek(first) || first.timestamp > to) return true;
+    trail.skip();
+    lead.skip();
+
+    spanEnd = to;
+    buckets = max(points, 2) - 2;
+    kept = first;
+    phase = PHASE_FIRST;
+    return true;
+}
+
+// Takes the next sample of the range; false at its end, and also for the
+// last sample, which is kept aside rather than bucketed
+bool LogHistory::take(Cursor& cursor, LogEntry& entry) {
+    if (!cursor.peek(entry) || entry.timestamp > spanEnd) return false;
+    cursor.skip();
+    LogEntry following;
+    if (!cursor.peek(following) || following.timestamp > spanEnd) {
+        last = entry;
+        hasLast = true;
+        return false;
+    }
+    return true;
+}
+
+// Buckets split (first, spanEnd]; a sample at the first one's time, or a
+// range that is a single instant, falls in bucket 0
+int LogHistory::bucketOf(unsigned long time) const {
+    unsigned long span = spanEnd - first.timestamp;
+    if (time <= first.timestamp || span == 0) return 0;
+    return (int)((uint64_t)(time - first.timestamp - 1) * buckets / span);
+}
+
+// Point C for the span the trailing cursor is in: the average of the next
+// non-empty span, or the last sample when there is none
+void LogHistory::average() {
+    LogEntry entry;
+    int bucket = -1;
+    uint64_t timeSum = 0;       // ms after the first sample
+    float tempSum = 0;
+    int count = 0;
+    while (lead.peek(entry) && entry.timestamp <= spanEnd) {
+        int entryBucket = bucketOf(entry.timestamp);
+        if (bucket >= 0 && entryBucket != bucket) break;
+        if (!take(lead, entry)) break;
+        bucket = entryBucket;
+        timeSum += entry.timestamp - first.timestamp;
+        tempSum += entry.temperature;
+        count++;
+    }
+    if (count > 0) {
+        averageTime = (float)timeSum / count / 1000.0f;
+        averageTemp = tempSum / count;
+    } else {
+        averageTime = (last.timestamp - first.timestamp) / 1000.0f;
+        averageTemp = last.temperature;
+    }
+}
+
+// Point B: the sample of the trailing cursor's span with the largest
+// triangle between A and C
+bool LogHistory::select(LogEntry& entry) {
+    LogEntry sample;
+    if (!trail.peek(sample) || sample.timestamp > spanEnd) return false;
+    int bucket = bucketOf(sample.timestamp);
+    float keptTime = (kept.timestamp - first.timestamp) / 1000.0f;
+    float best = -1;
+    while (trail.peek(sample) && sample.timestamp <= spanEnd && bucketOf(sample.timestamp) == bucket) {
+        if (!take(trail, sample)) break;
+        float sampleTime = (sample.timestamp - first.timestamp) / 1000.0f;
+        float area = fabsf((keptTime - averageTime) * (sample.temperature - kept.temperature) -
+                           (keptTime - sampleTime) * (averageTemp - kept.temperature));
+        if (area > best) {
+            best = area;
+            entry = sample;
+        }
+    }
+    return best >= 0;
+}
+
+bool LogHistory::next(LogEntry& entry) {
+    LogEntry sample;
+    switch (phase) {
+        case PHASE_FIRST:
+            entry = first;
+            if (!lead.peek(sample) || sample.timestamp > spanEnd) {
+                phase = PHASE_DONE;         // a single sample
+            } else if (buckets == 0) {
+                phase = PHASE_LAST;
+            } else {
+                // The lead skips the trail's span and averages the one after
+                average();
+                average();
+                phase = PHASE_BUCKETS;
+            }
+            return true;
+
+        case PHASE_BUCKETS:
+            if (select(entry)) {
+                kept = entry;
+                average();
+                return true;
+            }
+            phase = PHASE_LAST;
+            // fall through
+
+        case PHASE_LAST:
+            while (!hasLast && take(trail, sample)) {}
+            phase = PHASE_DONE;
+            if (!hasLast) return false;
+            entry = last;
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+size_t LogHistory::formatJSON(const LogEntry& entry, char* text, size_t size) {
+    int length = snprintf(text, size, "[%.1f,%.2f,%.2f,%.1f]", entry.timestamp / 1000.0f,
+                          entry.temperature, entry.targetTemp, entry.power);
+    return length > 0 && (size_t)length < size ? length : 0;
+}
@@ -0,0 +1,109 @@
+#include "../include/LogPolicy.h"
+
+LogPolicy::LogPolicy() {
+    adaptive = LOG_ADAPTIVE;
+    active = false;
+    lastState = STATE_IDLE;
+    lastTarget = 0;
+    burstUntil = 0;
+    hasLogged = false;
+    memset(&logged, 0, sizeof(logged));
+    droppedHead = 0;
+    droppedCount = 0;
+    pendingDropped = 0;
+    memset(&current, 0, sizeof(current));
+    hasCurrent = false;
+    offered = 0;
+    accepted = 0;
+}
+
+bool LogPolicy::isLogged(SystemState state) {
+    return state == STATE_PREHEAT || state == STATE_COOKING || state == STATE_FINISHED;
+}
+
+void LogPolicy::offer(const ControlStatus& status, unsigned long time) {
+    pendingDropped = 0;
+    hasCurrent = false;
+
+    if (!isLogged(status.state)) {
+        // The newest dropped sample closes the line where logging stopped
+        if (active && droppedCount > 0) {
+            pendingDropped = 1;
+            accepted++;
+        }
+        droppedCount = 0;
+        active = false;
+        lastState = status.state;
+        return;
+    }
+
+    LogEntry entry;
+    entry.timestamp = time;
+    entry.temperature = status.currentTemp;
+    entry.targetTemp = status.targetTemp;
+    entry.power = status.power;
+    entry.remainingTime = status.remainingTime;
+    offered++;
+
+    if (!adaptive) {
+        accept(entry, 0);
+        active = true;
+        return;
+    }
+
+    // Events start a burst, or extend the one running
+    bool event = !active || status.state != lastState || status.targetTemp != lastTarget ||
+                 (status.state == STATE_COOKING &&
+                  fabsf(status.currentTemp - status.targetTemp) > LOG_BURST_DEVIATION);
+    bool starting = event && !inBurst(time);
+    active = true;
+    lastState = status.state;
+    lastTarget = status.targetTemp;
+    if (event) {
+        burstUntil = time + LOG_BURST_DURATION;
+    }
+
+    if (starting) {
+        accept(entry, droppedCount);
+    } else if (inBurst(time) || !hasLogged) {
+        accept(entry, 0);
+    } else if (fabsf(entry.temperature - logged.temperature) >= LOG_DEADBAND_TEMP ||
+               fabsf(entry.power - logged.power) >= LOG_DEADBAND_POWER) {
+        accept(entry, min(droppedCount, 1));
+    } else if (time - logged.timestamp >= LOG_HEARTBEAT) {
+        accept(entry, 0);
+    } else {
+        drop(entry);
+    }
+}
+
+void LogPolicy::drop(const LogEntry& entry) {
+    dropped[droppedHead] = entry;
+    droppedHead = (droppedHead + 1) % LOG_PRETRIGGER_SAMPLES;
+    droppedCount = min(droppedCount + 1, LOG_PRETRIGGER_SAMPLES);
+}
+
+// Logs entry after the newest count dropped samples
+void LogPolicy::accept(const LogEntry& entry, int count) {
+    pendingDropped = count;
+    current = entry;
+    hasCurrent = true;
+    logged = entry;
+    hasLogged = true;
+    droppedCount = 0;
+    accepted += count + 1;
+}
+
+bool LogPolicy::next(LogEntry& entry) {
+    if (pendingDropped > 0) {
+        entry = dropped[(droppedHead - pendingDropped + LOG_PRETRIGGER_SAMPLES) % LOG_PRETRIGGER_SAMPLES];
+        pendingDropped--;
+        return true;
+    }
+    if (hasCurrent) {
+        entry = current;
+        hasCurrent = false;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,223 @@
+#include "../include/MqttClient.h"
+#include "../include/JsonWriter.h"
+
+static const char WILL_MESSAGE[] = "{\"online\":false}";
+
+MqttClient::MqttClient() : client(network) {
+    commandBus = nullptr;
+    started = false;
+    wasConnected = false;
+
+    samples = nullptr;
+    oldest = 0;
+    count = 0;
+    oldestSequence = 0;
+    lastSampleTime = 0;
+
+    nextAttemptTime = 0;
+    backoff = MQTT_RECONNECT_MIN;
+    statePublished = false;
+    publishedState = -1;
+    publishedError = -1;
+    publishedTarget = 0;
+
+    payload[0] = '\0';
+    stats = Stats{0, 0, 0, 0, 0, 0, 0};
+}
+
+void MqttClient::begin(CommandBus* bus) {
+    commandBus = bus;
+    if (samples == nullptr) {
+        samples = new Sample[MQTT_BUFFER_SAMPLES];
+    }
+    client.setServer(MQTT_SERVER, MQTT_PORT);
+    client.setBufferSize(MQTT_PAYLOAD_SIZE);
+    client.setCallback([this](char* topic, uint8_t* message, unsigned int length) {
+        handleMessage(topic, message, length);
+    });
+
+    unsigned long now = HAL::clock().millis();
+    lastSampleTime = now - MQTT_SAMPLE_INTERVAL;
+    nextAttemptTime = now;
+    started = true;
+    DEBUG_PRINTLN(F("MQTT client started"));
+}
+
+void MqttClient::update(const ControlStatus& status) {
+    if (!started) return;
+    unsigned long now = HAL::clock().millis();
+
+    // Sampling never depends on the broker
+    if (now - lastSampleTime >= MQTT_SAMPLE_INTERVAL) {
+        lastSampleTime = now;
+        addSample(status, now);
+    }
+
+    if (!client.connected()) {
+        if (wasConnected) {
+            wasConnected = false;
+            nextAttemptTime = now;
+            DEBUG_PRINTLN(F("MQTT connection lost"));
+        }
+        if ((long)(now - nextAttemptTime) < 0) return;
+        if (!connect()) {
+            nextAttemptTime = now + backoff;
+            backoff = min(backoff * 2, (unsigned long)MQTT_RECONNECT_MAX);
+            return;
+        }
+        backoff = MQTT_RECONNECT_MIN;
+        wasConnected = true;
+    }
+
+    client.loop();
+    publishState(status);
+
+    // Full batches only; after an outage the backlog drains a few per call
+    for (int i = 0; i < MQTT_BACKLOG_BATCHES && count >= MQTT_BATCH_SIZE; i++) {
+        if (!publishBatch()) break;
+    }
+}
+
+bool MqttClient::connect() {
+    const char* user = strlen(MQTT_USER) > 0 ? MQTT_USER : nullptr;
+    const char* password = strlen(MQTT_PASSWORD) > 0 ? MQTT_PASSWORD : nullptr;
+    if (!client.connect(MQTT_CLIENT_ID, user, password, MQTT_TOPIC_STATUS, 0, true, WILL_MESSAGE)) {
+        DEBUG_PRINT(F("MQTT connect failed, state "));
+        DEBUG_PRINTLN(client.state());
+        return false;
+    }
+
+    client.subscribe(MQTT_TOPIC_COMMAND);
+    statePublished = false;     // the will may have replaced it
+    stats.connects++;
+    DEBUG_PRINTLN(F("MQTT connected"));
+    return true;
+}
+
+void MqttClient::addSample(const ControlStatus& status, unsigned long now) {
+    if (count == MQTT_BUFFER_SAMPLES) {
+        oldest = (oldest + 1) % MQTT_BUFFER_SAMPLES;
+        oldestSequence++;
+        count--;
+        stats.samplesDropped++;
+    }
+
+    Sample& sample = samples[(oldest + count) % MQTT_BUFFER_SAMPLES];
+    sample.timestamp = now;
+    sample.temperature = (int16_t)lroundf(status.currentTemp * 100);
+    sample.target = (int16_t)lroundf(status.targetTemp * 100);
+    sample.power = (uint16_t)lroundf(constrain(status.power, 0.0f, 100.0f) * 10);
+    sample.state = (uint8_t)status.state;
+    count++;
+    stats.samples++;
+}
+
+size_t MqttClient::serializeBatch(size_t samplesInBatch) {
+    const Sample& first = samples[oldest];
+    JsonWriter json(payload, sizeof(payload));
+    json.beginObject();
+    json.addUnsigned("seq", oldestSequence);
+    json.addUnsigned("t0", first.timestamp);
+
+    #define BATCH_COLUMN(name, add) \
+        json.beginArray(name); \
+        for (size_t i = 0; i < samplesInBatch; i++) { \
+            const Sample& sample = samples[(oldest + i) % MQTT_BUFFER_SAMPLES]; \
+            add; \
+        } \
+        json.endArray();
+    BATCH_COLUMN("t", json.addUnsigned(nullptr, sample.timestamp - first.timestamp))
+    BATCH_COLUMN("temp", json.addFloat(nullptr, sample.temperature / 100.0f, 2))
+    BATCH_COLUMN("target", json.addFloat(nullptr, sample.target / 100.0f, 2))
+    BATCH_COLUMN("power", json.addFloat(nullptr, sample.power / 10.0f, 1))
+    BATCH_COLUMN("state", json.addUnsigned(nullptr, sample.state))
+    #undef BATCH_COLUMN
+
+    json.endObject();
+    return json.finish();
+}
+
+bool MqttClient::publishBatch() {
+    // A batch that does not fit the buffer goes out in halves
+    size_t samplesInBatch = min(count, (size_t)MQTT_BATCH_SIZE);
+    size_t length = 0;
+    while (samplesInBatch > 0 && (length = serializeBatch(samplesInBatch)) == 0) {
+        samplesInBatch /= 2;
+    }
+    if (length == 0 || !publish(MQTT_TOPIC_TELEMETRY, payload, length, false)) {
+        return false;
+    }
+
+    // The newest sample of the batch is also the retained current value
+    const Sample& last = samples[(oldest + samplesInBatch - 1) % MQTT_BUFFER_SAMPLES];
+    char value[12];
+    int valueLength = snprintf(value, sizeof(value), "%.2f", last.temperature / 100.0f);
+    publish(MQTT_TOPIC_TEMP, value, valueLength, true);
+
+    oldest = (oldest + samplesInBatch) % MQTT_BUFFER_SAMPLES;
+    oldestSequence += samplesInBatch;
+    count -= samplesInBatch;
+    stats.samplesSent += samplesInBatch;
+    return true;
+}
+
+void MqttClient::publishState(const ControlStatus& status) {
+    int16_t target = (int16_t)lroundf(status.targetTemp * 100);
+    if (!statePublished || target != publishedTarget) {
+        char value[12];
+        int length = snprintf(value, sizeof(value), "%.2f", target / 100.0f);
+        if (publish(MQTT_TOPIC_SETPOINT, value, length, true)) {
+            publishedTarget = target;
+        }
+    }
+
+    if (!statePublished || status.state != publishedState || status.error != publishedError) {
+        char text[48];
+        JsonWriter json(text, sizeof(text));
+        json.beginObject();
+        json.addBool("online", true);
+        json.addInt("state", status.state);
+        json.addInt("error", status.error);
+        json.endObject();
+        if (publish(MQTT_TOPIC_STATUS, text, json.finish(), true)) {
+            publishedState = status.state;
+            publishedError = status.error;
+            statePublished = true;
+        }
+    }
+}
+
+bool MqttClient::publish(const char* topic, const char* text, size_t length, bool retained) {
+    if (!client.publish(topic, (const uint8_t*)text, length, retained)) {
+        return false;
+    }
+    stats.messages++;
+    stats.bytes += strlen(topic) + length;
+    return true;
+}
+
+void MqttClient::handleMessage(char* topic, uint8_t* message, unsigned int length) {
+    if (strcmp(topic, MQTT_TOPIC_COMMAND) != 0) return;
+
+    // "action" or "action=value"; the payload is not NUL-terminated
+    char action[64];
+    if (length >= sizeof(action)) return;
+    memcpy(action, message, length);
+    action[length] = '\0';
+    char* value = strchr(action, '=');
+    if (value != nullptr) {
+        *value++ = '\0';
+    }
+
+    Command command;
+    if (!CommandBus::parse(action, value, COMMAND_SOURCE_MQTT, command)) {
+        DEBUG_PRINT(F("Rejected MQTT command: "));
+        DEBUG_PRINTLN(action);
+        return;
+    }
+    if (commandBus == nullptr || !commandBus->post(command)) {
+        DEBUG_PRINTLN(F("Command queue full, command dropped"));
+        return;
+    }
+    stats.commands++;
+}
@@ -0,0 +1,149 @@
+#include "../include/OneWireScheduler.h"
+
+OneWireScheduler::OneWireScheduler() {
+    bus = nullptr;
+    slotCount = 0;
+    nextSlot = 0;
+    interval = TEMP_READ_INTERVAL;
+    transactions = 0;
+}
+
+void OneWireScheduler::begin(HalOneWire* oneWireBus, unsigned long readInterval) {
+    bus = oneWireBus;
+    interval = readInterval;
+    slotCount = 0;
+    nextSlot = 0;
+    transactions = 0;
+}
+
+int OneWireScheduler::addDevice(const OneWireAddress address, uint8_t resolution) {
+    if (slotCount >= TEMP_SENSOR_COUNT) {
+        return -1;
+    }
+
+    Slot& slot = slots[slotCount];
+    memcpy(slot.address, address, sizeof(OneWireAddress));
+    slot.resolution = resolution;
+    slot.converting = false;
+    slot.requestTime = 0;
+    slot.reading = SENSOR_ERROR_TEMP;
+    slot.failures = 0;
+
+    // Spread the convert commands over the interval so reads never bunch up
+    unsigned long now = HAL::clock().millis();
+    slot.dueTime = now + interval * slotCount / TEMP_SENSOR_COUNT;
+
+    return slotCount++;
+}
+
+void OneWireScheduler::startAll() {
+    if (bus == nullptr || slotCount == 0) {
+        return;
+    }
+
+    bus->requestTemperatures();
+    transactions++;
+
+    unsigned long now = HAL::clock().millis();
+    for (int i = 0; i < slotCount; i++) {
+        slots[i].converting = true;
+        slots[i].requestTime = now;
+    }
+}
+
+int OneWireScheduler::poll() {
+    if (bus == nullptr || slotCount == 0) {
+        return -1;
+    }
+
+    unsigned long now = HAL::clock().millis();
+
+    // Read a finished conversion first, it only gets older
+    int finished = findFinished(now);
+    if (finished >= 0) {
+        Slot& slot = slots[finished];
+        slot.converting = false;
+        slot.reading = bus->getTempC(slot.address);
+        transactions++;
+
+        if (slot.reading == SENSOR_ERROR_TEMP) {
+            if (slot.failures < 255) slot.failures++;
+        } else {
+            slot.failures = 0;
+        }
+    }
+
+    // Then start the next due conversion, which may be the probe just read:
+    // at 12 bits conversion takes the whole interval, so splitting the two
+    // across loop iterations would stretch the sample period
+    int due = findDue(now);
+    if (due >= 0) {
+        Slot& slot = slots[due];
+        transactions++;
+        if (bus->requestTemperature(slot.address)) {
+            slot.converting = true;
+            slot.requestTime = now;
+        } else if (slot.failures < 255) {
+            slot.failures++;
+        }
+
+        // Keep the cadence, but don't try to catch up after a stall
+        slot.dueTime += slotInterval(slot);
+        if ((long)(now - slot.dueTime) >= 0) {
+            slot.dueTime = now + slotInterval(slot);
+        }
+        nextSlot = (due + 1) % slotCount;
+    }
+
+    return finished;
+}
+
+void OneWireScheduler::setResolution(int index, uint8_t bits) {
+    if (index < 0 || index >= slotCount) {
+        return;
+    }
+
+    Slot& slot = slots[index];
+    bus->setResolution(slot.address, bits);
+    transactions++;
+    slot.resolution = constrain(bits, 9, 12);
+
+    // The write aborts a running conversion on the device; start over at
+    // the new pace
+    slot.converting = false;
+    slot.dueTime = HAL::clock().millis();
+}
+
+unsigned long OneWireScheduler::conversionTime(uint8_t resolution) {
+    // 93.75 ms at 9 bits, doubling per extra bit (750 ms at 12 bits)
+    return 750 >> (12 - constrain(resolution, 9, 12));
+}
+
+unsigned long OneWireScheduler::slotInterval(const Slot& slot) {
+    return interval * conversionTime(slot.resolution) / conversionTime(TEMP_RESOLUTION);
+}
+
+int OneWireScheduler::findFinished(unsigned long now) {
+    int oldest = -1;
+    for (int i = 0; i < slotCount; i++) {
+        Slot& slot = slots[i];
+        if (!slot.converting || now - slot.requestTime < conversionTime(slot.resolution)) {
+            continue;
+        }
+        if (oldest < 0 || (long)(slot.requestTime - slots[oldest].requestTime) < 0) {
+            oldest = i;
+        }
+    }
+    return oldest;
+}
+
+int OneWireScheduler::findDue(unsigned long now) {
+    for (int n = 0; n < slotCount; n++) {
+        int i = (nextSlot + n) % slotCount;
+        Slot& slot = slots[i];
+        if (!slot.converting && (long)(now - slot.dueTime) >= 0) {
+            return i;
+        }
+    }
+    return -1;
+}
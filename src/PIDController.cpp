@@ -22,26 +22,79 @@ PIDController::PIDController() {
     lastDerivative = 0;
     
     output = 0;
+    
+    setpointWeight = PID_SETPOINT_WEIGHT;
+    weightedSetpoint = 0;
+    
+    feedForwardEnabled = false;
+    ambientTemp = AMBIENT_TEMP;
+    lossGain = FEEDFORWARD_LOSS_GAIN;
+    feedForward = 0;
+    learnOutputSum = 0;
+    learnTime = 0;
+    
+    tuneState = AUTOTUNE_IDLE;
+    tuneRule = TUNING_SOME_OVERSHOOT;
+    tuneCycles = AUTOTUNE_CYCLES;
+    tuneHysteresis = AUTOTUNE_HYSTERESIS;
+    relayBias = 0;
+    relayAmplitude = 0;
+    relayHigh = true;
+    relayStarted = false;
+    tuneStartTime = 0;
+    switchHighTime = 0;
+    switchLowTime = 0;
+    peakMax = 0;
+    peakMin = 0;
+    biasAdjustments = 0;
+    goodCycles = 0;
+    periodSum = 0;
+    amplitudeSum = 0;
+    verifyStartTime = 0;
+    lastOutsideBand = 0;
+    tuning = {0, 0, 0, 0, -1, 0, 0};
 }
 
 void PIDController::begin(float _kp, float _ki, float _kd) {
     setTunings(_kp, _ki, _kd);
-    lastTime = millis();
+    lastTime = HAL::clock().millis();
     autoMode = true;
     reset();
 }
 
 float PIDController::compute(float input) {
+    return update(input, false, 0);
+}
+
+float PIDController::compute(float input, float inputRate) {
+    return update(input, true, inputRate);
+}
+
+float PIDController::update(float input, bool rateGiven, float inputRate) {
     if (!autoMode) {
         return output;
     }
     
-    unsigned long now = millis();
+    unsigned long now = HAL::clock().millis();
     unsigned long timeChange = now - lastTime;
     
     if (timeChange >= sampleTime) {
+        // Keep the per-sample math in single precision: the ESP32 FPU has
+        // no double support, so a double literal here costs a library call
+        float dt = timeChange * 0.001f;
+        
+        // Relax the weighted reference towards the setpoint (first-order
+        // prefilter with the integral time, equivalent to P on b*r - y)
+        if (setpointWeight < 1 && kp > 0 && ki > 0) {
+            float integralTime = kp / ki;
+            weightedSetpoint += (setpoint - weightedSetpoint) *
+                                (1 - expf(-dt / integralTime));
+        } else {
+            weightedSetpoint = setpoint;
+        }
+        
         // Calculate error
-        float error = setpoint - input;
+        float error = weightedSetpoint - input;
         if (reverseMode) {
             error = -error;
         }
@@ -50,7 +103,17 @@ float PIDController::compute(float input) {
         float pTerm = kp * error;
         
         // Integral term
-        integral += (ki * error * timeChange / 1000.0);
+        float integralStep = ki * error * dt;
+        integral += integralStep;
+        
+        // With feed-forward supplying the holding power the integral only
+        // trims the residual near the setpoint, so whatever it built up to
+        // fill the gap P leaves during the approach is dropped on arrival
+        if (feedForwardEnabled && fabsf(error) < (float)FEEDFORWARD_INTEGRAL_BAND) {
+            float residualMax = (outputMax - outputMin) * (float)FEEDFORWARD_INTEGRAL_SHARE;
+            if (integral > residualMax) integral = residualMax;
+            if (integral < -residualMax) integral = -residualMax;
+        }
         
         // Anti-windup
         if (antiWindupEnabled && integralMax > 0) {
@@ -61,7 +124,7 @@ float PIDController::compute(float input) {
         // Derivative term
         float derivative = 0;
         if (timeChange > 0) {
-            derivative = (input - lastInput) / (timeChange / 1000.0);
+            derivative = rateGiven ? inputRate : (input - lastInput) / dt;
             
             // Apply derivative filter if enabled
             if (derivativeFilter > 0) {
@@ -72,8 +135,11 @@ float PIDController::compute(float input) {
         }
         float dTerm = -kd * derivative;  // Negative because we use input derivative
         
+        // Feed-forward holding power for the current setpoint
+        feedForward = getHoldingPower(setpoint);
+        
         // Calculate output
-        output = pTerm + integral + dTerm;
+        output = pTerm + integral + dTerm + feedForward;
         
         // Apply output limits
         if (output > outputMax) output = outputMax;
@@ -84,10 +150,14 @@ float PIDController::compute(float input) {
             if ((output >= outputMax && error > 0) || 
                 (output <= outputMin && error < 0)) {
                 // Remove the integral contribution that was just added
-                integral -= (ki * error * timeChange / 1000.0);
+                integral -= integralStep;
             }
         }
         
+        if (feedForwardEnabled) {
+            learnHoldingPower(setpoint - input, timeChange);
+        }
+        
         // Store values for next iteration
         lastInput = input;
         previousError = error;
@@ -98,6 +168,19 @@ float PIDController::compute(float input) {
 }
 
 void PIDController::setSetpoint(float sp) {
+    if (sp == setpoint) {
+        return;
+    }
+    
+    // Without feed-forward the integral carries the holding power, which
+    // scales with the distance to ambient; pre-load it for the new setpoint
+    if (autoMode && !feedForwardEnabled && setpoint - ambientTemp >= 1.0 &&
+        sp - ambientTemp >= 1.0 && integral > 0) {
+        integral *= (sp - ambientTemp) / (setpoint - ambientTemp);
+        if (integral > outputMax) integral = outputMax;
+    }
+    
+    weightedSetpoint += setpointWeight * (sp - setpoint);
     setpoint = sp;
 }
 
@@ -133,9 +216,9 @@ void PIDController::setSampleTime(unsigned long time) {
 void PIDController::setMode(bool automatic) {
     bool newMode = automatic;
     if (newMode && !autoMode) {
-        // Switching to auto mode, initialize
-        reset();
-        lastTime = millis();
+        // Switching to auto mode: continue from the held output instead of
+        // an empty integral, so resuming does not restart the heat-up
+        initialize(lastInput, output);
     }
     autoMode = newMode;
 }
@@ -149,6 +232,12 @@ void PIDController::enableAntiWindup(bool enable, float maxIntegral) {
     integralMax = maxIntegral;
 }
 
+void PIDController::setSetpointWeight(float weight) {
+    if (weight >= 0 && weight <= 1) {
+        setpointWeight = weight;
+    }
+}
+
 void PIDController::setDerivativeFilter(float alpha) {
     if (alpha >= 0 && alpha <= 1) {
         derivativeFilter = alpha;
@@ -157,6 +246,275 @@ void PIDController::setDerivativeFilter(float alpha) {
 
 void PIDController::reset() {
     integral = 0;
+    weightedSetpoint = setpoint;
     previousError = 0;
     lastDerivative = 0;
-}
\ No newline at end of file
+    learnOutputSum = 0;
+    learnTime = 0;
+}
+
+void PIDController::initialize(float input, float currentOutput) {
+    float error = setpoint - input;
+    if (reverseMode) {
+        error = -error;
+    }
+    
+    weightedSetpoint = setpoint;
+    feedForward = getHoldingPower(setpoint);
+    integral = currentOutput - kp * error - feedForward;
+    if (integral > outputMax) integral = outputMax;
+    if (integral < outputMin - outputMax) integral = outputMin - outputMax;
+    
+    output = constrain(currentOutput, outputMin, outputMax);
+    lastInput = input;
+    previousError = error;
+    lastDerivative = 0;
+    learnOutputSum = 0;
+    learnTime = 0;
+    lastTime = HAL::clock().millis();
+}
+
+void PIDController::enableFeedForward(bool enable, float gain) {
+    feedForwardEnabled = enable;
+    setLossGain(gain);
+    learnOutputSum = 0;
+    learnTime = 0;
+    if (!enable) {
+        feedForward = 0;
+    }
+}
+
+void PIDController::setLossGain(float gain) {
+    if (gain >= 0) {
+        lossGain = gain;
+    }
+}
+
+float PIDController::getHoldingPower(float sp) {
+    if (!feedForwardEnabled || sp <= ambientTemp) {
+        return 0;
+    }
+    return lossGain * (sp - ambientTemp);
+}
+
+void PIDController::learnHoldingPower(float error, unsigned long timeChange) {
+    // Only an unsaturated output close to the setpoint says anything about
+    // the power needed to hold it; anything else restarts the window
+    if (fabsf(error) > (float)FEEDFORWARD_LEARN_BAND || output <= outputMin || output >= outputMax ||
+        setpoint - ambientTemp < 1.0f) {
+        learnOutputSum = 0;
+        learnTime = 0;
+        return;
+    }
+    
+    learnOutputSum += output * timeChange;
+    learnTime += timeChange;
+    
+    if (learnTime >= FEEDFORWARD_LEARN_WINDOW) {
+        float holdingPower = learnOutputSum / learnTime;
+        float estimate = holdingPower / (setpoint - ambientTemp);
+        float previousFeedForward = feedForward;
+        
+        lossGain += FEEDFORWARD_LEARN_RATE * (estimate - lossGain);
+        
+        // Move the difference out of the integral so the output is unchanged
+        feedForward = lossGain * (setpoint - ambientTemp);
+        integral -= feedForward - previousFeedForward;
+        
+        learnOutputSum = 0;
+        learnTime = 0;
+    }
+}
+
+void PIDController::startAutoTune(float hysteresis, int cycles, TuningRule rule) {
+    tuneHysteresis = hysteresis > 0 ? hysteresis : AUTOTUNE_HYSTERESIS;
+    tuneCycles = cycles > 0 ? cycles : AUTOTUNE_CYCLES;
+    tuneRule = rule;
+    
+    // Start from a symmetric relay; the bias is adapted towards the holding
+    // power once the oscillation shows how asymmetric the plant is
+    relayBias = (outputMin + outputMax) / 2;
+    relayAmplitude = (outputMax - outputMin) / 2;
+    relayHigh = true;
+    relayStarted = false;
+    biasAdjustments = 0;
+    goodCycles = 0;
+    periodSum = 0;
+    amplitudeSum = 0;
+    
+    tuning = {kp, ki, kd, 0, -1, 0, 0};
+    tuneStartTime = HAL::clock().millis();
+    tuneState = AUTOTUNE_RELAY;
+    output = outputMax;
+    
+    DEBUG_PRINTLN(F("PID auto-tune started"));
+}
+
+PIDController::TuningParameters PIDController::autoTune(float input, float target) {
+    if (tuneState == AUTOTUNE_IDLE) {
+        startAutoTune();
+    }
+    
+    unsigned long now = HAL::clock().millis();
+    if (isAutoTuning() && now - tuneStartTime >= AUTOTUNE_TIMEOUT) {
+        tuneState = AUTOTUNE_FAILED;
+        output = outputMin;
+        DEBUG_PRINTLN(F("PID auto-tune timed out"));
+    }
+    
+    if (tuneState == AUTOTUNE_RELAY) {
+        relayStep(input, target, now);
+    } else if (tuneState == AUTOTUNE_VERIFY) {
+        verifyStep(input, target, now);
+    }
+    
+    return tuning;
+}
+
+void PIDController::cancelAutoTune() {
+    if (isAutoTuning()) {
+        tuneState = AUTOTUNE_IDLE;
+        output = outputMin;
+    }
+}
+
+void PIDController::relayStep(float input, float target, unsigned long now) {
+    // Full power until the first crossing, relay oscillation afterwards
+    if (!relayStarted) {
+        if (input < target) {
+            output = outputMax;
+            return;
+        }
+        relayStarted = true;
+        relayHigh = false;
+        switchLowTime = now;
+        switchHighTime = 0;
+        peakMax = input;
+        peakMin = input;
+    }
+    
+    if (input > peakMax) peakMax = input;
+    if (input < peakMin) peakMin = input;
+    
+    if (relayHigh && input > target + tuneHysteresis) {
+        relayHigh = false;
+        switchLowTime = now;
+    } else if (!relayHigh && input < target - tuneHysteresis) {
+        // A full cycle ends on every switch back to high
+        if (switchHighTime != 0) {
+            float highTime = (switchLowTime - switchHighTime) / 1000.0f;
+            float lowTime = (now - switchLowTime) / 1000.0f;
+            float period = highTime + lowTime;
+            float amplitude = (peakMax - peakMin) / 2;
+            float asymmetry = (lowTime - highTime) / period;
+            
+            if (fabs(asymmetry) > 0.2f && biasAdjustments < AUTOTUNE_MAX_BIAS_ADJUSTMENTS) {
+                // Heater baths heat much faster than they cool: move the bias
+                // towards the holding power so the oscillation is symmetric
+                relayBias -= relayAmplitude * asymmetry;
+                relayBias = constrain(relayBias, outputMin + (outputMax - outputMin) * 0.02f,
+                                      outputMax - (outputMax - outputMin) * 0.02f);
+                relayAmplitude = min(relayBias - outputMin, outputMax - relayBias);
+                biasAdjustments++;
+                goodCycles = 0;
+                periodSum = 0;
+                amplitudeSum = 0;
+            } else if (amplitude > tuneHysteresis) {
+                periodSum += period;
+                amplitudeSum += amplitude;
+                goodCycles++;
+            }
+        }
+        
+        relayHigh = true;
+        switchHighTime = now;
+        peakMax = input;
+        peakMin = input;
+        
+        if (goodCycles >= tuneCycles) {
+            finishRelay(input, target);
+            return;
+        }
+    }
+    
+    output = relayHigh ? relayBias + relayAmplitude : relayBias - relayAmplitude;
+}
+
+void PIDController::finishRelay(float input, float target) {
+    float amplitude = amplitudeSum / goodCycles;
+    float period = periodSum / goodCycles;
+    
+    // Describing function of a relay with hysteresis (Astrom-Hagglund)
+    float effective = sqrt(max(amplitude * amplitude - tuneHysteresis * tuneHysteresis,
+                               amplitude * amplitude * 0.01f));
+    float ku = 4 * relayAmplitude / (PI * effective);
+    
+    float gain, ti, td;
+    switch (tuneRule) {
+        case TUNING_ZIEGLER_NICHOLS:
+            gain = 0.6f * ku; ti = period / 2; td = period / 8;
+            break;
+        case TUNING_NO_OVERSHOOT:
+            gain = 0.2f * ku; ti = period / 2; td = period / 3;
+            break;
+        case TUNING_SOME_OVERSHOOT:
+        default:
+            gain = 0.33f * ku; ti = period / 2; td = period / 3;
+            break;
+    }
+    
+    tuning.ultimateGain = ku;
+    tuning.ultimatePeriod = period;
+    tuning.kp = gain;
+    tuning.ki = gain / ti;
+    tuning.kd = gain * td;
+    setTunings(tuning.kp, tuning.ki, tuning.kd);
+    
+    // Hand over to the PID with the relay bias as holding power: it is what
+    // the bath needed on average to oscillate around the target
+    integral = relayBias;
+    if (feedForwardEnabled && target - ambientTemp >= 1.0) {
+        setLossGain(relayBias / (target - ambientTemp));
+        integral = 0;
+    }
+    setpoint = target;
+    weightedSetpoint = target;
+    lastInput = input;
+    lastDerivative = 0;
+    lastTime = HAL::clock().millis() - sampleTime;
+    autoMode = true;
+    
+    verifyStartTime = HAL::clock().millis();
+    lastOutsideBand = verifyStartTime;
+    tuneState = AUTOTUNE_VERIFY;
+    
+    DEBUG_PRINT(F("Auto-tune Ku="));
+    DEBUG_PRINT(ku);
+    DEBUG_PRINT(F(" Tu="));
+    DEBUG_PRINTLN(period);
+}
+
+void PIDController::verifyStep(float input, float target, unsigned long now) {
+    setSetpoint(target);
+    compute(input);
+    
+    float error = input - target;
+    if (error > tuning.overshoot) {
+        tuning.overshoot = error;
+    }
+    if (fabs(error) > AUTOTUNE_SETTLE_BAND) {
+        lastOutsideBand = now;
+    }
+    
+    unsigned long periodMs = (unsigned long)(tuning.ultimatePeriod * 1000);
+    if (now - lastOutsideBand >= 2 * periodMs) {
+        // Inside the band for two ultimate periods: settled
+        tuning.settlingTime = (lastOutsideBand - verifyStartTime) / 1000.0f;
+        tuneState = AUTOTUNE_DONE;
+        DEBUG_PRINTLN(F("PID auto-tune complete"));
+    } else if (now - verifyStartTime >= 20 * periodMs) {
+        tuning.settlingTime = -1;
+        tuneState = AUTOTUNE_DONE;
+        DEBUG_PRINTLN(F("PID auto-tune complete (response did not settle)"));
+    }
+}
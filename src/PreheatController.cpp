@@ -0,0 +1,130 @@
+#include "../include/PreheatController.h"
+
+PreheatController::PreheatController() {
+    phase = PHASE_IDLE;
+    timeConstant = PREHEAT_TIME_CONSTANT;
+    holdingPower = 0;
+    output = 0;
+
+    sampleIndex = 0;
+    sampleCount = 0;
+    lastSampleTime = 0;
+    slope = 0;
+
+    cutTemperature = 0;
+    cutSlope = 0;
+    peakTemperature = 0;
+    peakTime = 0;
+}
+
+void PreheatController::start(float input, float target) {
+    sampleIndex = 0;
+    sampleCount = 0;
+    slope = 0;
+    lastSampleTime = HAL::clock().millis();
+    addSample(input);
+
+    // Nothing to predict when the bath is already there
+    if (input >= target - PREHEAT_HANDOVER_BAND) {
+        phase = PHASE_DONE;
+        output = holdingPower;
+        return;
+    }
+
+    phase = PHASE_HEATING;
+    output = 100;
+
+    DEBUG_PRINT(F("Predictive preheat started, time constant: "));
+    DEBUG_PRINTLN(timeConstant);
+}
+
+float PreheatController::compute(float input, float target) {
+    if (!isActive()) {
+        return output;
+    }
+
+    unsigned long now = HAL::clock().millis();
+    if (now - lastSampleTime >= PREHEAT_SAMPLE_INTERVAL) {
+        lastSampleTime = now;
+        addSample(input);
+    }
+
+    if (phase == PHASE_HEATING) {
+        // Ramp from full to holding power as the predicted end of the coast
+        // closes in on the target
+        float margin = target - getPredictedTemperature(input);
+        float share = constrain(margin / PREHEAT_RAMP_BAND, 0.0f, 1.0f);
+        output = holdingPower + (100 - holdingPower) * share;
+
+        if (margin <= 0 || input >= target) {
+            phase = PHASE_COASTING;
+            output = holdingPower;
+            cutTemperature = input;
+            cutSlope = slope;
+            peakTemperature = input;
+            peakTime = now;
+        }
+        return output;
+    }
+
+    // Coasting: hold until the measured temperature stops rising
+    output = holdingPower;
+    if (input > peakTemperature) {
+        peakTemperature = input;
+        peakTime = now;
+    }
+
+    float holdTime = max(2 * timeConstant, (float)PREHEAT_SLOPE_SAMPLES) * 1000;
+    if (now - peakTime >= holdTime || input >= target + PREHEAT_HANDOVER_BAND) {
+        learnTimeConstant();
+        phase = PHASE_DONE;
+
+        DEBUG_PRINT(F("Predictive preheat done, peak: "));
+        DEBUG_PRINTLN(peakTemperature);
+    }
+
+    return output;
+}
+
+void PreheatController::cancel() {
+    phase = PHASE_IDLE;
+    output = 0;
+}
+
+void PreheatController::setTimeConstant(float seconds) {
+    timeConstant = constrain(seconds, PREHEAT_MIN_TIME_CONSTANT, PREHEAT_MAX_TIME_CONSTANT);
+}
+
+void PreheatController::addSample(float input) {
+    samples[sampleIndex] = input;
+    sampleIndex = (sampleIndex + 1) % PREHEAT_SLOPE_SAMPLES;
+    if (sampleCount < PREHEAT_SLOPE_SAMPLES) {
+        sampleCount++;
+    }
+
+    if (sampleCount < 2) {
+        slope = 0;
+        return;
+    }
+
+    // Average slope across the window; oldest sample is just past the newest
+    int newest = (sampleIndex + PREHEAT_SLOPE_SAMPLES - 1) % PREHEAT_SLOPE_SAMPLES;
+    int oldest = (sampleIndex + PREHEAT_SLOPE_SAMPLES - sampleCount) % PREHEAT_SLOPE_SAMPLES;
+    float span = (sampleCount - 1) * PREHEAT_SAMPLE_INTERVAL * 0.001f;
+    slope = (samples[newest] - samples[oldest]) / span;
+}
+
+void PreheatController::learnTimeConstant() {
+    // The rise after the cut is what the lag still had in store:
+    // peak - cut = slope * timeConstant for a first-order lag
+    if (cutSlope < PREHEAT_MIN_SLOPE) {
+        return;
+    }
+
+    float observed = (peakTemperature - cutTemperature) / cutSlope;
+    observed = constrain(observed, PREHEAT_MIN_TIME_CONSTANT, PREHEAT_MAX_TIME_CONSTANT);
+    timeConstant += PREHEAT_LEARN_RATE * (observed - timeConstant);
+
+    DEBUG_PRINT(F("Preheat time constant learned: "));
+    DEBUG_PRINTLN(timeConstant);
+}
@@ -1,5 +1,7 @@
 #include "../include/SSRControl.h"
 
+SSRControl* SSRControl::instance = nullptr;
+
 SSRControl::SSRControl() {
     ssrPin = SSR_PIN;
     windowStartTime = 0;
@@ -8,24 +10,59 @@ SSRControl::SSRControl() {
     onTime = 0;
     enabled = false;
     safetyLock = false;
-    usePWM = false;
-    pwmChannel = 0;
-    pwmFrequency = 5000;
-    pwmResolution = 8;
+    timerDriven = false;
+    onTimeUs = 0;
+    windowSizeUs = PID_WINDOW_SIZE * 1000UL;
+    windowStartUs = 0;
+    setModulation(SSR_SIGMA_DELTA, SSR_ZERO_CROSS_SYNC);
+    cycleUs = SSR_SIGMA_DELTA_CYCLES * 1000000UL / MAINS_FREQUENCY;
+    level = 0;
+    accumulator = 0;
+    halfCycles = 0;
+    lastDecisionUs = 0;
+    zeroCrossEdges = 0;
+    zeroCrossLost = false;
+    seenEdges = 0;
+    lastEdgeUs = 0;
 }
 
 void SSRControl::begin() {
     begin(ssrPin);
 }
 
-void SSRControl::begin(uint8_t pin) {
+void SSRControl::begin(uint8_t pin, bool useTimer) {
     ssrPin = pin;
-    pinMode(ssrPin, OUTPUT);
-    digitalWrite(ssrPin, LOW);
-    windowStartTime = millis();
+    HAL::gpio().pinMode(ssrPin, OUTPUT);
+    HAL::gpio().digitalWrite(ssrPin, LOW);
+    windowStartTime = HAL::clock().millis();
+    lastDecisionUs = HAL::clock().micros();
+    lastEdgeUs = lastDecisionUs;
     enabled = true;
+    instance = this;
+    
+    // Zero-cross edges replace the timer as the decision clock
+    timerDriven = useTimer && !zeroCrossSync;
+    if (zeroCrossSync) {
+        HAL::gpio().pinMode(ZERO_CROSS_PIN, INPUT);
+        HAL::gpio().attachInterrupt(ZERO_CROSS_PIN, onZeroCross, RISING);
+    } else if (timerDriven) {
+        HAL::timer().begin(onTimer);
+        windowStartUs = HAL::timer().nowMicros();
+        retrigger();
+    }
     
-    DEBUG_PRINTLN(F("SSR Control initialized"));
+    if (zeroCrossSync) {
+        DEBUG_PRINTLN(F("SSR Control initialized, sigma-delta on zero cross"));
+    } else if (sigmaDelta) {
+        DEBUG_PRINTLN(F("SSR Control initialized, sigma-delta"));
+    } else {
+        DEBUG_PRINTLN(F("SSR Control initialized"));
+    }
+}
+
+void SSRControl::setModulation(bool useSigmaDelta, bool syncToZeroCross) {
+    sigmaDelta = useSigmaDelta;
+    zeroCrossSync = useSigmaDelta && syncToZeroCross;
 }
 
 void SSRControl::update() {
@@ -34,7 +71,26 @@ void SSRControl::update() {
         return;
     }
     
-    unsigned long now = millis();
+    // The alarm chain owns the pin, and so does the zero-cross interrupt
+    // while its edges keep coming
+    if (timerDriven || (zeroCrossSync && watchZeroCross())) {
+        return;
+    }
+    
+    if (sigmaDelta) {
+        unsigned long nowUs = HAL::clock().micros();
+        if (nowUs - lastDecisionUs >= cycleUs) {
+            // A late loop() holds the decision longer; skip rather than burst
+            lastDecisionUs += cycleUs;
+            if (nowUs - lastDecisionUs >= cycleUs) {
+                lastDecisionUs = nowUs;
+            }
+            decideCycle();
+        }
+        return;
+    }
+    
+    unsigned long now = HAL::clock().millis();
     
     // Check if we need to shift the window
     if (now - windowStartTime >= windowSize) {
@@ -60,12 +116,29 @@ void SSRControl::setPower(float power) {
         onTime = constrain(power, 0, windowSize);
         powerPercentage = (onTime * 100.0) / windowSize;
     }
+    level = (uint16_t)(powerPercentage * 100 + 0.5);
+    
+    // Off now, not at the next edge or decision, which may never come
+    if (level == 0) {
+        setPinState(false);
+    }
+    
+    // A new on time applies to the current window, like the polled path;
+    // sigma-delta picks the new level up at the next decision
+    uint32_t newOnTimeUs = (uint32_t)(onTime * 1000);
+    if (newOnTimeUs != onTimeUs && !sigmaDelta) {
+        onTimeUs = newOnTimeUs;
+        retrigger();
+    }
 }
 
 void SSRControl::setWindowSize(unsigned long size) {
     windowSize = size;
     // Recalculate onTime based on current percentage
     onTime = (windowSize * powerPercentage) / 100.0;
+    windowSizeUs = windowSize * 1000UL;
+    onTimeUs = (uint32_t)(onTime * 1000);
+    retrigger();
 }
 
 void SSRControl::enable(bool state) {
@@ -73,6 +146,7 @@ void SSRControl::enable(bool state) {
     if (!enabled) {
         setPinState(false);
     }
+    retrigger();
 }
 
 void SSRControl::setSafetyLock(bool lock) {
@@ -81,6 +155,7 @@ void SSRControl::setSafetyLock(bool lock) {
         setPinState(false);
         DEBUG_PRINTLN(F("SSR Safety lock engaged"));
     }
+    retrigger();
 }
 
 float SSRControl::getPowerPercentage() {
@@ -100,6 +175,8 @@ void SSRControl::emergencyStop() {
     setPinState(false);
     powerPercentage = 0;
     onTime = 0;
+    onTimeUs = 0;
+    level = 0;
     DEBUG_PRINTLN(F("EMERGENCY STOP ACTIVATED"));
 }
 
@@ -111,14 +188,127 @@ void SSRControl::test() {
     // Quick test pattern
     for (int i = 0; i < 3; i++) {
         setPinState(true);
-        delay(500);
+        HAL::clock().delay(500);
         setPinState(false);
-        delay(500);
+        HAL::clock().delay(500);
     }
     
     DEBUG_PRINTLN(F("SSR test complete"));
 }
 
-void SSRControl::setPinState(bool state) {
-    digitalWrite(ssrPin, state ? HIGH : LOW);
-}
\ No newline at end of file
+void IRAM_ATTR SSRControl::setPinState(bool state) {
+    HAL::gpio().digitalWrite(ssrPin, state ? HIGH : LOW);
+}
+// True while zero-cross edges arrive; on losing them the pin goes low and
+// update() takes the decisions on its own clock
+bool SSRControl::watchZeroCross() {
+    unsigned long nowUs = HAL::clock().micros();
+    uint32_t edges = zeroCrossEdges;
+    if (edges != seenEdges) {
+        seenEdges = edges;
+        lastEdgeUs = nowUs;
+    }
+    
+    bool present = nowUs - lastEdgeUs < SSR_ZERO_CROSS_TIMEOUT * 500000UL / MAINS_FREQUENCY;
+    if (present == zeroCrossLost) {
+        zeroCrossLost = !present;
+        if (zeroCrossLost) {
+            setPinState(false);
+            lastDecisionUs = nowUs;
+            DEBUG_PRINTLN(F("WARNING: Zero cross lost, SSR decisions from update()"));
+        } else {
+            DEBUG_PRINTLN(F("Zero cross restored"));
+        }
+    }
+    return present;
+}
+
+void SSRControl::retrigger() {
+    // Re-evaluate the window now; the interrupt re-arms from there
+    if (timerDriven) {
+        HAL::timer().alarmAt(HAL::timer().nowMicros());
+    }
+}
+
+void IRAM_ATTR SSRControl::onTimer() {
+    if (instance == nullptr) return;
+    if (instance->sigmaDelta) {
+        instance->sigmaDeltaEdge();
+    } else {
+        instance->timerEdge();
+    }
+}
+
+void IRAM_ATTR SSRControl::onZeroCross() {
+    if (instance != nullptr) {
+        instance->zeroCrossEdge();
+    }
+}
+
+void IRAM_ATTR SSRControl::timerEdge() {
+    // Interrupt context: no allocation, no logging
+    if (!enabled || safetyLock) {
+        setPinState(false);
+        return;     // enable() and setSafetyLock() restart the chain
+    }
+    
+    uint64_t now = HAL::timer().nowMicros();
+    uint32_t window = windowSizeUs;
+    uint32_t on = onTimeUs;
+    
+    // Move to the window containing now (several if the timer was stopped)
+    if (now - windowStartUs >= window) {
+        windowStartUs += (now - windowStartUs) / window * window;
+    }
+    
+    bool high = (now - windowStartUs) < on;
+    setPinState(high);
+    HAL::timer().alarmAt(windowStartUs + (high ? on : window));
+}
+
+void IRAM_ATTR SSRControl::sigmaDeltaEdge() {
+    // Interrupt context; windowStartUs is the next decision time here
+    if (!enabled || safetyLock) {
+        setPinState(false);
+        return;     // enable() and setSafetyLock() restart the chain
+    }
+    
+    uint64_t now = HAL::timer().nowMicros();
+    
+    // A retrigger ahead of the grid only re-arms, so the decisions stay
+    // evenly spaced
+    if (now >= windowStartUs) {
+        decideCycle();
+        windowStartUs += cycleUs;
+        if (windowStartUs <= now) {
+            windowStartUs = now + cycleUs;
+        }
+    }
+    HAL::timer().alarmAt(windowStartUs);
+}
+
+void IRAM_ATTR SSRControl::zeroCrossEdge() {
+    // Interrupt context
+    zeroCrossEdges++;
+    if (!enabled || safetyLock) {
+        setPinState(false);
+        halfCycles = 0;
+        return;
+    }
+    if (zeroCrossLost) return;      // update() decides until it sees the edges
+    
+    if (++halfCycles < 2 * SSR_SIGMA_DELTA_CYCLES) return;
+    halfCycles = 0;
+    decideCycle();
+}
+
+void IRAM_ATTR SSRControl::decideCycle() {
+    // First-order sigma-delta: the accumulated error never exceeds one
+    // decision's worth of energy
+    accumulator += level;
+    bool on = accumulator >= 10000;
+    if (on) {
+        accumulator -= 10000;
+    }
+    setPinState(on);
+}
@@ -0,0 +1,53 @@
+#include "../include/SerialConsole.h"
+
+SerialConsole::SerialConsole() {
+    commandBus = nullptr;
+    length = 0;
+    overflowed = false;
+}
+
+void SerialConsole::begin(CommandBus* bus) {
+    commandBus = bus;
+    length = 0;
+    overflowed = false;
+}
+
+void SerialConsole::update() {
+    while (Serial.available() > 0) {
+        int c = Serial.read();
+        if (c < 0) break;
+        
+        if (c == '\n' || c == '\r') {
+            if (overflowed) {
+                Serial.println(F("error: line too long"));
+            } else if (length > 0) {
+                line[length] = '\0';
+                handleLine();
+            }
+            length = 0;
+            overflowed = false;
+        } else if (length + 1 < sizeof(line)) {
+            line[length++] = (char)c;
+        } else {
+            overflowed = true;
+        }
+    }
+}
+
+void SerialConsole::handleLine() {
+    char* value = strpbrk(line, "= ");
+    if (value != nullptr) {
+        *value++ = '\0';
+        while (*value == ' ') value++;
+    }
+    
+    Command command;
+    if (!CommandBus::parse(line, value, COMMAND_SOURCE_SERIAL, command)) {
+        Serial.print(F("error: bad command "));
+        Serial.println(line);
+    } else if (commandBus == nullptr || !commandBus->post(command)) {
+        Serial.println(F("error: busy"));
+    } else {
+        Serial.println(F("ok"));
+    }
+}
@@ -19,6 +19,12 @@ StateMachine::StateMachine() {
     isPreheated = false;
     alarmActive = false;
     lastError = ERROR_NONE;
+    
+    coreTemperature = SENSOR_ERROR_TEMP;
+    coreInBand = false;
+    coreInBandSince = 0;
+    
+    commandBus = nullptr;
 }
 
 void StateMachine::begin() {
@@ -27,6 +33,12 @@ void StateMachine::begin() {
 }
 
 void StateMachine::update(float currentTemp, Encoder& encoder) {
+    // Remote commands act on this tick, like the encoder below
+    Command command;
+    while (commandBus != nullptr && commandBus->take(command)) {
+        applyCommand(command);
+    }
+    
     // Check for errors first
     if (currentTemp == SENSOR_ERROR_TEMP) {
         setError(ERROR_SENSOR_DISCONNECTED);
@@ -57,6 +69,9 @@ void StateMachine::update(float currentTemp, Encoder& encoder) {
         case STATE_ERROR:
             handleErrorState(currentTemp, encoder);
             break;
+        case STATE_AUTOTUNE:
+            handleAutoTuneState(currentTemp, encoder);
+            break;
         default:
             break;
     }
@@ -70,7 +85,7 @@ void StateMachine::update(float currentTemp, Encoder& encoder) {
 void StateMachine::changeState(SystemState newState) {
     previousState = currentState;
     currentState = newState;
-    stateChangeTime = millis();
+    stateChangeTime = HAL::clock().millis();
     
     DEBUG_PRINT(F("State changed to: "));
     DEBUG_PRINTLN(newState);
@@ -81,7 +96,7 @@ unsigned long StateMachine::getRemainingTime() {
         return 0;
     }
     
-    unsigned long elapsed = (millis() - cookingStartTime) / 1000;
+    unsigned long elapsed = (HAL::clock().millis() - cookingStartTime) / 1000;
     if (elapsed >= cookingParams.cookingTime) {
         return 0;
     }
@@ -94,7 +109,7 @@ unsigned long StateMachine::getElapsedTime() {
         return 0;
     }
     
-    return (millis() - cookingStartTime) / 1000;
+    return (HAL::clock().millis() - cookingStartTime) / 1000;
 }
 
 void StateMachine::setTargetTemperature(float temp) {
@@ -109,7 +124,7 @@ void StateMachine::startCooking() {
     if (cookingParams.preHeatEnabled && !isPreheated) {
         changeState(STATE_PREHEAT);
     } else {
-        cookingStartTime = millis();
+        cookingStartTime = HAL::clock().millis();
         cookingEndTime = cookingStartTime + (cookingParams.cookingTime * 1000);
         changeState(STATE_COOKING);
     }
@@ -119,6 +134,7 @@ void StateMachine::stopCooking() {
     cookingStartTime = 0;
     cookingEndTime = 0;
     isPreheated = false;
+    coreInBand = false;
     changeState(STATE_IDLE);
 }
 
@@ -137,6 +153,67 @@ void StateMachine::resumeCooking() {
     }
 }
 
+void StateMachine::applyCommand(const Command& command) {
+    DEBUG_PRINT(F("Command from "));
+    DEBUG_PRINT(CommandBus::sourceName(command.source));
+    DEBUG_PRINT(F(": "));
+    DEBUG_PRINTLN(CommandBus::typeName(command.type));
+    
+    switch (command.type) {
+        case COMMAND_START:
+            // A repeated start must not restart a running cook, and an
+            // error has to be acknowledged on the device
+            if (currentState != STATE_PREHEAT && currentState != STATE_COOKING &&
+                currentState != STATE_ERROR && currentState != STATE_AUTOTUNE) {
+                startCooking();
+            }
+            break;
+        case COMMAND_STOP:
+            if (currentState != STATE_ERROR) {
+                stopCooking();
+            }
+            break;
+        case COMMAND_PAUSE:
+            pauseCooking();
+            break;
+        case COMMAND_RESUME:
+            resumeCooking();
+            break;
+        case COMMAND_SET_TARGET:
+            setTargetTemperature(command.temperature);
+            break;
+        case COMMAND_SET_TIME:
+            setCookingTime(command.seconds);
+            break;
+        case COMMAND_SET_PID:
+            // Picked up by the PID on its next sample
+            cookingParams.pidKp = command.gains.kp;
+            cookingParams.pidKi = command.gains.ki;
+            cookingParams.pidKd = command.gains.kd;
+            break;
+        case COMMAND_AUTOTUNE:
+            // Only from idle; "stop" aborts it
+            startAutoTune();
+            break;
+    }
+}
+
+void StateMachine::startAutoTune() {
+    if (currentState == STATE_IDLE) {
+        changeState(STATE_AUTOTUNE);
+    }
+}
+
+void StateMachine::applyTuning(float kp, float ki, float kd) {
+    cookingParams.pidKp = kp;
+    cookingParams.pidKi = ki;
+    cookingParams.pidKd = kd;
+    
+    if (currentState == STATE_AUTOTUNE) {
+        changeState(STATE_IDLE);
+    }
+}
+
 void StateMachine::setError(ErrorCode error) {
     lastError = error;
     if (error != ERROR_NONE) {
@@ -212,7 +289,7 @@ void StateMachine::handlePreheatState(float currentTemp, Encoder& encoder) {
     // Check if target temperature reached
     if (checkTemperatureReached(currentTemp, cookingParams.targetTemperature)) {
         isPreheated = true;
-        cookingStartTime = millis();
+        cookingStartTime = HAL::clock().millis();
         cookingEndTime = cookingStartTime + (cookingParams.cookingTime * 1000);
         changeState(STATE_COOKING);
     }
@@ -220,7 +297,7 @@ void StateMachine::handlePreheatState(float currentTemp, Encoder& encoder) {
     // Button press to skip preheat
     if (encoder.wasButtonPressed()) {
         isPreheated = true;
-        cookingStartTime = millis();
+        cookingStartTime = HAL::clock().millis();
         cookingEndTime = cookingStartTime + (cookingParams.cookingTime * 1000);
         changeState(STATE_COOKING);
     }
@@ -232,8 +309,8 @@ void StateMachine::handlePreheatState(float currentTemp, Encoder& encoder) {
 }
 
 void StateMachine::handleCookingState(float currentTemp, Encoder& encoder) {
-    // Check if cooking time has elapsed
-    if (getRemainingTime() == 0) {
+    // Check if cooking time has elapsed or the core is done
+    if (getRemainingTime() == 0 || isCoreDone()) {
         changeState(STATE_FINISHED);
         if (cookingParams.alarmEnabled) {
             alarmActive = true;
@@ -271,10 +348,32 @@ void StateMachine::handleErrorState(float currentTemp, Encoder& encoder) {
     }
 }
 
+void StateMachine::handleAutoTuneState(float, Encoder& encoder) {
+    // Tuning itself runs in the PID controller; long press aborts it
+    if (encoder.isLongPress()) {
+        changeState(STATE_IDLE);
+    }
+}
+
 bool StateMachine::checkTemperatureReached(float current, float target, float tolerance) {
     return abs(current - target) <= tolerance;
 }
 
+bool StateMachine::isCoreDone() {
+    if (!ENABLE_CORE_FINISH || coreTemperature == SENSOR_ERROR_TEMP ||
+        coreTemperature < cookingParams.targetTemperature - CORE_DONE_BAND) {
+        coreInBand = false;
+        return false;
+    }
+    
+    unsigned long now = HAL::clock().millis();
+    if (!coreInBand) {
+        coreInBand = true;
+        coreInBandSince = now;
+    }
+    return now - coreInBandSince >= (unsigned long)CORE_HOLD_TIME * 1000;
+}
+
 void StateMachine::updateAlarm(float currentTemp) {
     if (currentState == STATE_COOKING) {
         // Check for temperature deviation
@@ -0,0 +1,59 @@
+#ifdef ARDUINO
+
+#include "../include/Tasks.h"
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// ESP32 backend: one FreeRTOS task per PeriodicTask
+
+void PeriodicTask::entry(void* param) {
+    PeriodicTask* task = static_cast<PeriodicTask*>(param);
+    const TickType_t period = pdMS_TO_TICKS(task->periodMs);
+    TickType_t lastWake = xTaskGetTickCount();
+    unsigned long lastStart = 0;
+    bool first = true;
+
+    while (task->running) {
+        unsigned long start = ::micros();
+        task->body();
+        unsigned long end = ::micros();
+        if (!first) {
+            task->record(start - lastStart, end - start);
+        }
+        lastStart = start;
+        first = false;
+
+        vTaskDelayUntil(&lastWake, period);
+    }
+
+    task->handle = nullptr;
+    vTaskDelete(NULL);
+}
+
+bool PeriodicTask::start() {
+    if (running) return true;
+
+    running = true;
+    TaskHandle_t created = nullptr;
+    BaseType_t result = xTaskCreatePinnedToCore(
+        entry, name, stackSize, this, priority, &created,
+        core >= 0 ? core : tskNO_AFFINITY);
+    if (result != pdPASS) {
+        running = false;
+        DEBUG_PRINT(F("ERROR: Unable to start task "));
+        DEBUG_PRINTLN(name);
+        return false;
+    }
+    handle = created;
+    return true;
+}
+
+void PeriodicTask::stop() {
+    // The task finishes its current run and deletes itself
+    running = false;
+    while (handle != nullptr) {
+        vTaskDelay(1);
+    }
+}
+
+#endif // ARDUINO
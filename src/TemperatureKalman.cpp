@@ -0,0 +1,64 @@
+#include "../include/TemperatureKalman.h"
+
+TemperatureKalman::TemperatureKalman() {
+    rateNoise = KALMAN_RATE_NOISE;
+    measurementNoise = KALMAN_MEASUREMENT_NOISE;
+    reset();
+}
+
+void TemperatureKalman::reset() {
+    temperature = 0;
+    rate = 0;
+    p00 = p01 = p11 = 0;
+    lastTime = 0;
+    initialized = false;
+}
+
+void TemperatureKalman::setNoise(float rateVariance, float measurementVariance) {
+    if (rateVariance > 0) rateNoise = rateVariance;
+    if (measurementVariance >= 0) measurementNoise = measurementVariance;
+}
+
+void TemperatureKalman::update(float measurement, uint8_t resolution, unsigned long timeMs) {
+    // Uniform quantization error of one LSB at this resolution
+    float step = 0.0625f * (1 << (12 - constrain(resolution, 9, 12)));
+    float r = measurementNoise + step * step / 12;
+
+    if (!initialized) {
+        temperature = measurement;
+        rate = 0;
+        p00 = r;
+        p01 = 0;
+        p11 = KALMAN_INITIAL_RATE_VARIANCE;
+        lastTime = timeMs;
+        initialized = true;
+        return;
+    }
+
+    float dt = (timeMs - lastTime) * 0.001f;
+    lastTime = timeMs;
+
+    // Predict: x = F x, P = F P F' + Q with F = [1 dt; 0 1]
+    if (dt > 0) {
+        temperature += rate * dt;
+        float dt2 = dt * dt;
+        p00 += dt * (2 * p01 + dt * p11) + rateNoise * dt2 * dt / 3;
+        p01 += dt * p11 + rateNoise * dt2 / 2;
+        p11 += rateNoise * dt;
+    }
+
+    // Correct with H = [1 0]
+    float innovation = measurement - temperature;
+    float s = p00 + r;
+    float k0 = p00 / s;
+    float k1 = p01 / s;
+    temperature += k0 * innovation;
+    rate += k1 * innovation;
+
+    float n00 = p00 - k0 * p00;
+    float n01 = p01 - k0 * p01;
+    float n11 = p11 - k1 * p01;
+    p00 = n00;
+    p01 = n01;
+    p11 = n11;
+}
@@ -1,38 +1,39 @@
 #include "../include/TemperatureSensor.h"
 
+static const OneWireAddress ROLE_ADDRESSES[TEMP_SENSOR_COUNT] = {
+    SENSOR_BATH_ADDRESS, SENSOR_HEATER_OUTLET_ADDRESS, SENSOR_CORE_ADDRESS
+};
+
 TemperatureSensor::TemperatureSensor() {
-    oneWire = nullptr;
     sensors = nullptr;
-    lastTemperature = 0.0;
+    for (int i = 0; i < TEMP_SENSOR_COUNT; i++) {
+        memcpy(roleAddress[i], ROLE_ADDRESSES[i], sizeof(OneWireAddress));
+        roleSlot[i] = -1;
+        slotRole[i] = -1;
+        lastTemperature[i] = 0.0;
+        readingValid[i] = false;
+    }
+    activeSensors = 0;
     temperatureOffset = 0.0;
-    lastReadTime = 0;
     sensorFound = false;
     isCalibrated = false;
-    historyIndex = 0;
-    historyFilled = false;
-    
-    // Initialize temperature history
-    for (int i = 0; i < FILTER_SIZE; i++) {
-        tempHistory[i] = 0.0;
-    }
 }
 
 TemperatureSensor::~TemperatureSensor() {
-    if (sensors != nullptr) {
-        delete sensors;
-    }
-    if (oneWire != nullptr) {
-        delete oneWire;
+    // The bus is owned by the HAL backend
+    sensors = nullptr;
+}
+
+void TemperatureSensor::setRoleAddress(int role, const OneWireAddress address) {
+    if (role >= 0 && role < TEMP_SENSOR_COUNT) {
+        memcpy(roleAddress[role], address, sizeof(OneWireAddress));
     }
 }
 
 bool TemperatureSensor::begin() {
-    // Initialize OneWire and DallasTemperature
-    oneWire = new OneWire(ONE_WIRE_BUS);
-    sensors = new DallasTemperature(oneWire);
-    
-    // Start the library
-    sensors->begin();
+    // Initialize the OneWire bus
+    sensors = &HAL::oneWire();
+    sensors->begin(ONE_WIRE_BUS);
     
     // Check if any sensors are found
     int deviceCount = sensors->getDeviceCount();
@@ -45,79 +46,156 @@ bool TemperatureSensor::begin() {
         return false;
     }
     
-    // Get the address of the first sensor
-    if (!sensors->getAddress(sensorAddress, 0)) {
-        DEBUG_PRINTLN(F("ERROR: Unable to find address for sensor 0"));
-        return false;
+    // Match every probe on the bus against the role addresses; search
+    // order follows the ROM codes, so it says nothing about the wiring
+    bool found[TEMP_SENSOR_COUNT] = {};
+    OneWireAddress unbound;
+    int unboundCount = 0;
+    for (int i = 0; i < deviceCount; i++) {
+        OneWireAddress address;
+        if (!sensors->getAddress(address, i)) {
+            DEBUG_PRINT(F("ERROR: Unable to find address for sensor "));
+            DEBUG_PRINTLN(i);
+            break;
+        }
+        
+        // Print sensor address
+        DEBUG_PRINT(F("Sensor "));
+        DEBUG_PRINT(i);
+        DEBUG_PRINT(F(" Address: "));
+        printAddress(address);
+        
+        int role = findRole(address);
+        if (role >= 0) {
+            found[role] = true;
+            DEBUG_PRINT(F(" role "));
+            DEBUG_PRINT(role);
+        } else {
+            memcpy(unbound, address, sizeof(OneWireAddress));
+            unboundCount++;
+        }
+        DEBUG_PRINTLN();
     }
     
-    // Print sensor address
-    DEBUG_PRINT(F("Sensor 0 Address: "));
-    printAddress(sensorAddress);
-    DEBUG_PRINTLN();
+    // Without a bath address, the one probe left over is unambiguous
+    if (!isBound(roleAddress[SENSOR_BATH]) && unboundCount == 1) {
+        memcpy(roleAddress[SENSOR_BATH], unbound, sizeof(OneWireAddress));
+        found[SENSOR_BATH] = true;
+    }
+    if (!found[SENSOR_BATH]) {
+        DEBUG_PRINTLN(isBound(roleAddress[SENSOR_BATH])
+                      ? F("ERROR: Bath probe not found on the bus")
+                      : F("ERROR: Several unbound probes, set SENSOR_BATH_ADDRESS"));
+        return false;
+    }
     
-    // Set resolution
-    sensors->setResolution(sensorAddress, TEMP_RESOLUTION);
+    scheduler.begin(sensors, TEMP_READ_INTERVAL);
+    activeSensors = 0;
+    for (int role = 0; role < TEMP_SENSOR_COUNT; role++) {
+        roleSlot[role] = -1;
+        slotRole[role] = -1;
+    }
+    for (int role = 0; role < TEMP_SENSOR_COUNT; role++) {
+        if (!found[role]) {
+            continue;
+        }
+        
+        // Set resolution
+        sensors->setResolution(roleAddress[role], TEMP_RESOLUTION);
+        int slot = scheduler.addDevice(roleAddress[role], TEMP_RESOLUTION);
+        roleSlot[role] = slot;
+        slotRole[slot] = role;
+        activeSensors++;
+    }
     
     // Set to async mode for non-blocking reads
     sensors->setWaitForConversion(false);
     
     // Request first temperature
-    sensors->requestTemperatures();
-    lastReadTime = millis();
+    scheduler.startAll();
     
     sensorFound = true;
     return true;
 }
 
 void TemperatureSensor::update() {
-    unsigned long currentTime = millis();
+    // Bounded bus time; readings arrive one probe at a time
+    int slot = scheduler.poll();
+    if (slot < 0) {
+        return;
+    }
     
-    // Check if it's time to read temperature
-    if (currentTime - lastReadTime >= TEMP_READ_INTERVAL) {
-        // Get temperature from last request
-        float tempC = sensors->getTempC(sensorAddress);
-        
+    int index = slotRole[slot];
+    float tempC = scheduler.getReading(slot);
+    
+    if (index == SENSOR_BATH) {
         // Validate reading
         if (validateReading(tempC)) {
             // Apply calibration offset
             float calibratedTemp = tempC + temperatureOffset;
             
             // Update moving average
-            updateMovingAverage(calibratedTemp);
+            statistics.add(calibratedTemp);
+            if (ENABLE_KALMAN_FILTER) {
+                kalman.update(calibratedTemp, scheduler.getResolution(slot),
+                              HAL::clock().millis());
+            }
             
             // Store last valid temperature
-            lastTemperature = calibratedTemp;
+            lastTemperature[SENSOR_BATH] = calibratedTemp;
+            readingValid[SENSOR_BATH] = true;
         } else {
             DEBUG_PRINTLN(F("WARNING: Invalid temperature reading"));
         }
-        
-        // Request next temperature (non-blocking)
-        sensors->requestTemperatures();
-        lastReadTime = currentTime;
+        return;
+    }
+    
+    // Secondary probes drop out on a bad reading so control falls back
+    // to the bath probe alone
+    readingValid[index] = validateReading(tempC);
+    if (readingValid[index]) {
+        lastTemperature[index] = tempC;
     }
 }
 
 float TemperatureSensor::getTemperature() {
-    return lastTemperature;
+    return lastTemperature[SENSOR_BATH];
+}
+
+float TemperatureSensor::getTemperature(int index) {
+    if (index == SENSOR_BATH) {
+        return lastTemperature[SENSOR_BATH];
+    }
+    return hasSensor(index) ? lastTemperature[index] : SENSOR_ERROR_TEMP;
+}
+
+bool TemperatureSensor::hasSensor(int index) {
+    return index >= 0 && index < TEMP_SENSOR_COUNT && roleSlot[index] >= 0 && readingValid[index];
 }
 
 float TemperatureSensor::getRawTemperature() {
-    return sensors->getTempC(sensorAddress);
+    return roleSlot[SENSOR_BATH] >= 0 ? scheduler.getReading(roleSlot[SENSOR_BATH]) : SENSOR_ERROR_TEMP;
 }
 
 float TemperatureSensor::getFilteredTemperature() {
-    return calculateMovingAverage();
+    return getAverageTemperature();
+}
+
+float TemperatureSensor::getEstimatedTemperature() {
+    return kalman.isInitialized() ? kalman.getTemperature() : lastTemperature[SENSOR_BATH];
+}
+
+float TemperatureSensor::getTemperatureRate() {
+    return kalman.isInitialized() ? kalman.getRate() : 0.0;
 }
 
 bool TemperatureSensor::isConnected() {
-    // Check if sensor is still responding
-    float temp = sensors->getTempC(sensorAddress);
-    return (temp != DEVICE_DISCONNECTED_C && temp != -127.0);
+    // Judged from the scheduled reads, without an extra bus transaction
+    return roleSlot[SENSOR_BATH] >= 0 && scheduler.isResponding(roleSlot[SENSOR_BATH]);
 }
 
 bool TemperatureSensor::hasError() {
-    return !isConnected() || lastTemperature == SENSOR_ERROR_TEMP;
+    return !isConnected() || lastTemperature[SENSOR_BATH] == SENSOR_ERROR_TEMP;
 }
 
 void TemperatureSensor::setCalibrationOffset(float offset) {
@@ -143,80 +221,99 @@ int TemperatureSensor::getSensorCount() {
     return sensors->getDeviceCount();
 }
 
-void TemperatureSensor::printAddress(DeviceAddress deviceAddress) {
+void TemperatureSensor::printAddress(const OneWireAddress deviceAddress) {
     for (uint8_t i = 0; i < 8; i++) {
         if (deviceAddress[i] < 16) DEBUG_PRINT("0");
-        DEBUG_PRINT(deviceAddress[i], HEX);
+        DEBUG_PRINT(String(deviceAddress[i], HEX));
     }
 }
 
-bool TemperatureSensor::getSensorAddress(DeviceAddress& address, int index) {
+bool TemperatureSensor::getSensorAddress(OneWireAddress address, int index) {
     return sensors->getAddress(address, index);
 }
 
 void TemperatureSensor::setResolution(uint8_t resolution) {
-    sensors->setResolution(sensorAddress, resolution);
+    for (int slot = 0; slot < scheduler.getDeviceCount(); slot++) {
+        scheduler.setResolution(slot, resolution);
+    }
 }
 
 uint8_t TemperatureSensor::getResolution() {
-    return sensors->getResolution(sensorAddress);
+    return roleSlot[SENSOR_BATH] >= 0 ? scheduler.getResolution(roleSlot[SENSOR_BATH]) : 0;
 }
 
-float TemperatureSensor::getMinTemperature() {
-    float minTemp = tempHistory[0];
-    for (int i = 1; i < FILTER_SIZE; i++) {
-        if (tempHistory[i] < minTemp && tempHistory[i] != 0) {
-            minTemp = tempHistory[i];
+void TemperatureSensor::adaptResolution(float error, bool preheating) {
+    int slot = roleSlot[SENSOR_BATH];
+    if (!ENABLE_ADAPTIVE_RESOLUTION || slot < 0) {
+        return;
+    }
+    
+    float distance = fabs(error);
+    uint8_t current = scheduler.getResolution(slot);
+    uint8_t wanted = TEMP_RESOLUTION;
+    if (preheating) {
+        if (distance > ADAPTIVE_RES_FAST_ERROR) {
+            wanted = 10;
+        } else if (distance > ADAPTIVE_RES_MEDIUM_ERROR) {
+            wanted = 11;
         }
+        
+        // Coarsening needs the error clear of the switch point, so noise
+        // around it doesn't rewrite the configuration every read
+        if (wanted < current) {
+            float threshold = (wanted == 10) ? ADAPTIVE_RES_FAST_ERROR : ADAPTIVE_RES_MEDIUM_ERROR;
+            if (distance < threshold + ADAPTIVE_RES_HYSTERESIS) {
+                wanted = current;
+            }
+        }
+    }
+    wanted = min(wanted, (uint8_t)TEMP_RESOLUTION);
+    
+    if (wanted != current) {
+        scheduler.setResolution(slot, wanted);
+        DEBUG_PRINT(F("Bath probe resolution: "));
+        DEBUG_PRINTLN(wanted);
     }
-    return minTemp;
+}
+
+float TemperatureSensor::getMinTemperature() {
+    return statistics.getCount() > 0 ? statistics.getMin() : lastTemperature[SENSOR_BATH];
 }
 
 float TemperatureSensor::getMaxTemperature() {
-    float maxTemp = tempHistory[0];
-    for (int i = 1; i < FILTER_SIZE; i++) {
-        if (tempHistory[i] > maxTemp) {
-            maxTemp = tempHistory[i];
-        }
-    }
-    return maxTemp;
+    return statistics.getCount() > 0 ? statistics.getMax() : lastTemperature[SENSOR_BATH];
 }
 
 float TemperatureSensor::getAverageTemperature() {
-    return calculateMovingAverage();
+    return statistics.getCount() > 0 ? statistics.getMean() : lastTemperature[SENSOR_BATH];
+}
+
+float TemperatureSensor::getTemperatureStdDev() {
+    return statistics.getStandardDeviation();
 }
 
 void TemperatureSensor::resetStatistics() {
-    for (int i = 0; i < FILTER_SIZE; i++) {
-        tempHistory[i] = 0.0;
-    }
-    historyIndex = 0;
-    historyFilled = false;
+    statistics.reset();
+    kalman.reset();
 }
 
-void TemperatureSensor::updateMovingAverage(float newTemp) {
-    tempHistory[historyIndex] = newTemp;
-    historyIndex = (historyIndex + 1) % FILTER_SIZE;
-    
-    if (historyIndex == 0) {
-        historyFilled = true;
-    }
+bool TemperatureSensor::validateReading(float temp) {
+    // Check if temperature is within valid range
+    return (temp > -55.0 && temp < 125.0 && temp != SENSOR_ERROR_TEMP);
 }
 
-float TemperatureSensor::calculateMovingAverage() {
-    float sum = 0.0;
-    int count = historyFilled ? FILTER_SIZE : historyIndex;
-    
-    if (count == 0) return lastTemperature;
-    
-    for (int i = 0; i < count; i++) {
-        sum += tempHistory[i];
+int TemperatureSensor::findRole(const OneWireAddress address) {
+    for (int role = 0; role < TEMP_SENSOR_COUNT; role++) {
+        if (isBound(roleAddress[role]) && memcmp(roleAddress[role], address, sizeof(OneWireAddress)) == 0) {
+            return role;
+        }
     }
-    
-    return sum / count;
+    return -1;
 }
 
-bool TemperatureSensor::validateReading(float temp) {
-    // Check if temperature is within valid range
-    return (temp > -55.0 && temp < 125.0 && temp != DEVICE_DISCONNECTED_C);
-}
\ No newline at end of file
+bool TemperatureSensor::isBound(const OneWireAddress address) {
+    for (uint8_t i = 0; i < 8; i++) {
+        if (address[i] != 0) return true;
+    }
+    return false;
+}
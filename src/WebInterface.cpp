@@ -1,15 +1,216 @@
 #include "../include/WebInterface.h"
+#include "../include/DashboardPage.h"
+#include "../include/LogCodec.h"
+#include "../include/LogHistory.h"
+
+#if DASHBOARD_WEBSOCKET_PORT != WEBSOCKET_PORT
+#error "DashboardPage.h was built for another WEBSOCKET_PORT; run python3 web/build_dashboard.py"
+#endif
+
+// The page only changes with the firmware: browsers keep it but revalidate
+// on every load, and a matching ETag gets a bodyless 304
+#define DASHBOARD_CACHE_HEADERS "Cache-Control: no-cache\r\nETag: " DASHBOARD_ETAG "\r\n"
+
+// DataLogger's files, "log_<ms>.bin" or ".csv"; anything else, a path in
+// particular, is refused
+static bool isLogName(const char* name) {
+    size_t length = strlen(name);
+    if (length < 9 || length >= 32 || strncmp(name, "log_", 4) != 0 ||
+        (strcmp(name + length - 4, ".bin") != 0 && strcmp(name + length - 4, ".csv") != 0)) {
+        return false;
+    }
+    for (size_t i = 0; i < length; i++) {
+        if (!isalnum((unsigned char)name[i]) && name[i] != '_' && name[i] != '.') return false;
+    }
+    return true;
+}
+
+// A log file from its current position to its end as it stands on flash
+class LogFileSource : public HttpBodySource {
+private:
+    HalFile* file;
+
+public:
+    LogFileSource(HalFile* file) : file(file) {}
+    ~LogFileSource() {
+        file->close();
+        delete file;
+    }
+
+    size_t read(uint8_t* buffer, size_t size) override {
+        int count = file->read(buffer, size);
+        return count > 0 ? count : 0;
+    }
+};
+
+// A binary log decoded to CSV a line at a time
+class LogCsvSource : public HttpBodySource {
+private:
+    HalFile* file;
+    LogDecoder decoder;
+    char line[64];
+    size_t lineLength;
+    size_t lineSent;
+
+public:
+    LogCsvSource(HalFile* file) : file(file), decoder([file](uint8_t* buffer, size_t size) {
+        return file->read(buffer, size);
+    }) {
+        lineLength = snprintf(line, sizeof(line), "%s\r\n", LOG_CSV_HEADER);
+        lineSent = 0;
+    }
+    ~LogCsvSource() {
+        file->close();
+        delete file;
+    }
+
+    bool begin() { return decoder.begin(); }
+
+    size_t read(uint8_t* buffer, size_t size) override {
+        size_t count = 0;
+        while (count < size) {
+            if (lineSent == lineLength) {
+                // An open session has no end marker: stop at the last whole record
+                LogEntry entry;
+                if (!decoder.next(entry)) break;
+                lineLength = LogDecoder::formatCSV(entry, line, sizeof(line));
+                lineSent = 0;
+            }
+            size_t part = min(size - count, lineLength - lineSent);
+            memcpy(buffer + count, line + lineSent, part);
+            lineSent += part;
+            count += part;
+        }
+        return count;
+    }
+};
+
+// A /history query as JSON, one point at a time
+class HistorySource : public HttpBodySource {
+private:
+    char text[160];
+    size_t textLength;
+    size_t textSent;
+    bool pointsSent;
+    bool closed;
+
+public:
+    LogHistory history;
+
+    HistorySource() : textLength(0), textSent(0), pointsSent(false), closed(false) {}
+
+    bool begin(const char* name, unsigned long from, unsigned long to, int points) {
+        if (!history.query(from, to, points)) return false;
+        unsigned long end = history.getEndTime();
+        textLength = snprintf(text, sizeof(text),
+                              "{\"file\":\"%s\",\"start\":%lu,\"end\":%.1f,\"from\":%.1f,\"to\":%.1f,\"points\":[",
+                              name, (unsigned long)history.getHeader().startTime, end / 1000.0f,
+                              min(from, end) / 1000.0f, min(to, end) / 1000.0f);
+        return textLength < sizeof(text);
+    }
+
+    size_t read(uint8_t* buffer, size_t size) override {
+        size_t count = 0;
+        while (count < size) {
+            if (textSent == textLength) {
+                LogEntry entry;
+                if (closed) break;
+                textSent = 0;
+                if (history.next(entry)) {
+                    textLength = pointsSent ? 1 : 0;
+                    text[0] = ',';
+                    textLength += LogHistory::formatJSON(entry, text + textLength, sizeof(text) - textLength);
+                    pointsSent = true;
+                } else {
+                    textLength = 2;
+                    memcpy(text, "]}", 2);
+                    closed = true;
+                }
+            }
+            size_t part = min(size - count, textLength - textSent);
+            memcpy(buffer + count, text + textSent, part);
+            textSent += part;
+            count += part;
+        }
+        return count;
+    }
+};
+
+// Seconds in a query argument, as ms
+static bool secondsArg(const HttpRequest& request, const char* name, unsigned long& ms) {
+    char value[16];
+    char* end;
+    if (!request.arg(name, value, sizeof(value)) || !isdigit((unsigned char)value[0])) return false;
+    unsigned long seconds = strtoul(value, &end, 10);
+    if (*end != '\0' || seconds > (unsigned long)-1 / 1000) return false;
+    ms = seconds * 1000;
+    return true;
+}
+
+// The JSON list of log files. Each read lists the filesystem again and
+// carries on after the files already sent, so no list is held in RAM.
+class LogListSource : public HttpBodySource {
+private:
+    size_t sent;                // files already in the list
+    bool opened;
+    bool closed;
+
+public:
+    LogListSource() : sent(0), opened(false), closed(false) {}
+
+    size_t read(uint8_t* buffer, size_t size) override {
+        if (closed) return 0;
+        size_t count = 0;
+        if (!opened) {
+            buffer[count++] = '[';
+            opened = true;
+        }
+
+        // One byte is kept for the closing bracket
+        size_t seen = 0;
+        bool full = false;
+        HAL::fs().listFiles([&](const char* path, size_t fileSize) {
+            const char* name = path[0] == '/' ? path + 1 : path;
+            if (full || !isLogName(name) || seen++ < sent) return;
+            char entry[64];
+            int length = snprintf(entry, sizeof(entry), "%s{\"name\":\"%s\",\"size\":%u}",
+                                  sent > 0 ? "," : "", name, (unsigned)fileSize);
+            if (count + length + 1 > size) {
+                full = true;
+                return;
+            }
+            memcpy(buffer + count, entry, length);
+            count += length;
+            sent++;
+        });
+        if (!full) {
+            buffer[count++] = ']';
+            closed = true;
+        }
+        return count;
+    }
+};
 
 WebInterface::WebInterface() {
     server = nullptr;
+    socket = nullptr;
     wifiConnected = false;
     localIP = "";
+    pushed = PushState{0, 0, 0, 0, 0};
+    pushedAny = false;
+    snapshotPending = 0;
+    lastPushTime = 0;
+    pushBuffer[0] = '\0';
+    commandBus = nullptr;
 }
 
 WebInterface::~WebInterface() {
     if (server != nullptr) {
         delete server;
     }
+    if (socket != nullptr) {
+        delete socket;
+    }
 }
 
 bool WebInterface::begin() {
@@ -17,18 +218,29 @@ bool WebInterface::begin() {
         return false;
     }
     
-    server = new WebServer(WEB_SERVER_PORT);
+    server = new AsyncHttpServer();
     setupRoutes();
-    server->begin();
+    if (!server->begin(WEB_SERVER_PORT)) {
+        DEBUG_PRINTLN(F("ERROR: HTTP server failed to start"));
+    }
+    
+    socket = new WebSocketsServer(WEBSOCKET_PORT);
+    socket->onEvent([this](uint8_t num, WStype_t type, uint8_t* payload, size_t length) {
+        handleSocketEvent(num, type, payload, length);
+    });
+    socket->begin();
     
     DEBUG_PRINTLN(F("Web server started"));
     return true;
 }
 
-void WebInterface::update(SystemState state, float currentTemp, float targetTemp, 
-                         unsigned long remainingTime, float power) {
-    if (server != nullptr) {
-        server->handleClient();
+void WebInterface::update(const ControlStatus& status) {
+    // HTTP is served from the network task; it only sees what is published
+    // here. The push channel is polled.
+    sharedStatus.write(status);
+    if (socket != nullptr) {
+        socket->loop();
+        pushState(status);
     }
 }
 
@@ -37,7 +249,7 @@ bool WebInterface::connectWiFi() {
     
     int attempts = 0;
     while (WiFi.status() != WL_CONNECTED && attempts < 20) {
-        delay(500);
+        HAL::clock().delay(500);
         DEBUG_PRINT(".");
         attempts++;
     }
@@ -54,105 +266,367 @@ bool WebInterface::connectWiFi() {
 }
 
 void WebInterface::setupRoutes() {
-    server->on("/", [this]() { handleRoot(); });
-    server->on("/status", [this]() { handleStatus(); });
-    server->on("/control", [this]() { handleControl(); });
-    server->on("/settings", [this]() { handleSettings(); });
-    server->onNotFound([this]() { handleNotFound(); });
+    server->on("/", HTTP_METHOD_GET, [this](HttpRequest& request) { handleRoot(request); });
+    server->on("/status", HTTP_METHOD_GET, [this](HttpRequest& request) { handleStatus(request); });
+    server->on("/control", HTTP_METHOD_ANY, [this](HttpRequest& request) { handleControl(request); });
+    server->on("/settings", HTTP_METHOD_ANY, [this](HttpRequest& request) { handleSettings(request); });
+    server->on("/logs", HTTP_METHOD_GET, [this](HttpRequest& request) { handleLogs(request); });
+    server->on("/history", HTTP_METHOD_GET, [this](HttpRequest& request) { handleHistory(request); });
+    server->onNotFound([this](HttpRequest& request) { handleNotFound(request); });
 }
 
-void WebInterface::handleRoot() {
-    server->send(200, "text/html", generateHTML());
+void WebInterface::handleRoot(HttpRequest& request) {
+    char tags[64];
+    if (request.header("If-None-Match", tags, sizeof(tags)) && strstr(tags, DASHBOARD_ETAG) != nullptr) {
+        request.sendStatic(304, "text/html", nullptr, 0, DASHBOARD_CACHE_HEADERS);
+        return;
+    }
+    // Served gzipped from flash without a copy; every browser accepts gzip
+    request.sendStatic(200, "text/html", DASHBOARD_HTML_GZ, sizeof(DASHBOARD_HTML_GZ),
+                       "Content-Encoding: gzip\r\n" DASHBOARD_CACHE_HEADERS);
 }
 
-void WebInterface::handleStatus() {
-    // This would need access to actual system state
-    String json = "{\"status\":\"ok\"}";
-    server->send(200, "application/json", json);
+void WebInterface::handleStatus(HttpRequest& request) {
+    ControlStatus status;
+    if (!sharedStatus.read(status)) {
+        request.sendStatic(503, "text/plain", nullptr, 0, "Retry-After: 1\r\n");
+        return;
+    }
+    size_t length = serializeStatus(status, statusBuffer, sizeof(statusBuffer));
+    if (length == 0) {
+        request.send(500, "text/plain", "Status too large");
+        return;
+    }
+    request.send(200, "application/json", statusBuffer, length);
 }
 
-void WebInterface::handleControl() {
-    if (server->hasArg("action")) {
-        String action = server->arg("action");
-        // Process control commands
-        server->send(200, "text/plain", "OK");
+size_t WebInterface::serializeStatus(const ControlStatus& status, char* buffer, size_t size) {
+    JsonWriter json(buffer, size);
+    json.beginObject();
+    json.addUnsigned("timestamp", status.timestamp);
+    json.addInt("state", status.state);
+    json.addInt("error", status.error);
+    json.addFloat("currentTemp", status.currentTemp, 2);
+    json.addFloat("targetTemp", status.targetTemp, 2);
+    if (status.coreTemp == SENSOR_ERROR_TEMP) {
+        json.addNull("coreTemp");
     } else {
-        server->send(400, "text/plain", "Bad Request");
-    }
-}
-
-void WebInterface::handleSettings() {
-    // Handle settings updates
-    server->send(200, "text/plain", "Settings updated");
-}
-
-void WebInterface::handleNotFound() {
-    server->send(404, "text/plain", "Not Found");
-}
-
-String WebInterface::generateHTML() {
-    String html = R"(
-<!DOCTYPE html>
-<html>
-<head>
-    <title>ESP32 Sous Vide Controller</title>
-    <meta name="viewport" content="width=device-width, initial-scale=1">
-    <style>
-        body { font-family: Arial; margin: 20px; background: #f0f0f0; }
-        .container { max-width: 600px; margin: auto; background: white; padding: 20px; border-radius: 10px; }
-        h1 { color: #333; text-align: center; }
-        .status { margin: 20px 0; padding: 15px; background: #e8f4f8; border-radius: 5px; }
-        .control { margin: 20px 0; }
-        button { padding: 10px 20px; margin: 5px; background: #4CAF50; color: white; border: none; border-radius: 5px; cursor: pointer; }
-        button:hover { background: #45a049; }
-        .temp { font-size: 24px; font-weight: bold; color: #2196F3; }
-    </style>
-</head>
-<body>
-    <div class="container">
-        <h1>Sous Vide Controller</h1>
-        <div class="status">
-            <p>Current Temperature: <span class="temp" id="currentTemp">--</span>°C</p>
-            <p>Target Temperature: <span class="temp" id="targetTemp">--</span>°C</p>
-            <p>Time Remaining: <span id="timeRemaining">--:--</span></p>
-            <p>Power: <span id="power">--%</span></p>
-        </div>
-        <div class="control">
-            <button onclick="startCooking()">Start</button>
-            <button onclick="stopCooking()">Stop</button>
-            <button onclick="pauseCooking()">Pause</button>
-        </div>
-    </div>
-    <script>
-        function updateStatus() {
-            fetch('/status')
-                .then(response => response.json())
-                .then(data => {
-                    document.getElementById('currentTemp').textContent = data.currentTemp.toFixed(1);
-                    document.getElementById('targetTemp').textContent = data.targetTemp.toFixed(1);
-                    document.getElementById('timeRemaining').textContent = formatTime(data.remainingTime);
-                    document.getElementById('power').textContent = data.power.toFixed(0) + '%';
-                });
+        json.addFloat("coreTemp", status.coreTemp, 2);
+    }
+    json.addFloat("tempRate", status.tempRate, 4);
+    json.addUnsigned("cookingTime", status.cookingTime);
+    json.addUnsigned("elapsedTime", status.elapsedTime);
+    json.addUnsigned("remainingTime", status.remainingTime);
+    json.addFloat("power", status.power, 1);
+    
+    json.beginObject("sensors");
+    json.addUnsigned("active", status.activeSensors);
+    json.addBool("error", status.sensorError);
+    json.endObject();
+    
+    json.beginObject("pid");
+    json.addBool("auto", status.pidAutoMode);
+    json.addFloat("output", status.pidOutput, 1);
+    json.addFloat("feedForward", status.feedForward, 1);
+    json.addFloat("kp", status.kp, 3);
+    json.addFloat("ki", status.ki, 5);
+    json.addFloat("kd", status.kd, 3);
+    json.endObject();
+    
+    json.beginObject("ssr");
+    json.addBool("enabled", status.ssrEnabled);
+    json.addBool("safetyLocked", status.ssrSafetyLocked);
+    json.endObject();
+    
+    json.endObject();
+    return json.finish();
+}
+
+void WebInterface::handleControl(HttpRequest& request) {
+    if (request.method() != HTTP_METHOD_POST) {
+        request.sendStatic(405, "text/plain", nullptr, 0, "Allow: POST\r\n");
+        return;
+    }
+    
+    char action[16];
+    char value[48] = "";
+    Command command;
+    if (!request.arg("action", action, sizeof(action)) ||
+        (request.hasArg("value") && !request.arg("value", value, sizeof(value))) ||
+        !CommandBus::parse(action, value, COMMAND_SOURCE_WEB, command)) {
+        request.send(400, "text/plain", "Bad command");
+        return;
+    }
+    sendPostResult(request, &command, 1);
+}
+
+void WebInterface::handleSettings(HttpRequest& request) {
+    if (request.method() == HTTP_METHOD_GET || request.method() == HTTP_METHOD_HEAD) {
+        ControlStatus status;
+        if (!sharedStatus.read(status)) {
+            request.sendStatic(503, "text/plain", nullptr, 0, "Retry-After: 1\r\n");
+            return;
         }
-        
-        function formatTime(seconds) {
-            const hours = Math.floor(seconds / 3600);
-            const minutes = Math.floor((seconds % 3600) / 60);
-            const secs = seconds % 60;
-            return hours > 0 ? 
-                `${hours}:${minutes.toString().padStart(2, '0')}:${secs.toString().padStart(2, '0')}` :
-                `${minutes}:${secs.toString().padStart(2, '0')}`;
+        JsonWriter json(statusBuffer, sizeof(statusBuffer));
+        json.beginObject();
+        json.addFloat("targetTemp", status.targetTemp, 2);
+        json.addUnsigned("cookingTime", status.cookingTime);
+        json.addFloat("kp", status.kp, 3);
+        json.addFloat("ki", status.ki, 5);
+        json.addFloat("kd", status.kd, 3);
+        json.endObject();
+        request.send(200, "application/json", statusBuffer, json.finish());
+        return;
+    }
+    if (request.method() != HTTP_METHOD_POST) {
+        request.sendStatic(405, "text/plain", nullptr, 0, "Allow: GET, POST\r\n");
+        return;
+    }
+    
+    // Everything is validated before anything is queued
+    Command commands[3];
+    int count = 0;
+    char value[48];
+    bool valid = true;
+    if (request.hasArg("target")) {
+        valid &= request.arg("target", value, sizeof(value)) &&
+                 CommandBus::parse("target", value, COMMAND_SOURCE_WEB, commands[count++]);
+    }
+    if (request.hasArg("time")) {
+        valid &= request.arg("time", value, sizeof(value)) &&
+                 CommandBus::parse("time", value, COMMAND_SOURCE_WEB, commands[count++]);
+    }
+    if (request.hasArg("kp") || request.hasArg("ki") || request.hasArg("kd")) {
+        char kp[16], ki[16], kd[16];
+        valid &= request.arg("kp", kp, sizeof(kp)) && request.arg("ki", ki, sizeof(ki)) &&
+                 request.arg("kd", kd, sizeof(kd));
+        if (valid) {
+            snprintf(value, sizeof(value), "%s,%s,%s", kp, ki, kd);
+            valid = CommandBus::parse("pid", value, COMMAND_SOURCE_WEB, commands[count++]);
+        }
+    }
+    if (!valid || count == 0) {
+        request.send(400, "text/plain", "Bad settings");
+        return;
+    }
+    sendPostResult(request, commands, count);
+}
+
+void WebInterface::handleLogs(HttpRequest& request) {
+    if (!request.hasArg("file")) {
+        request.sendStream(200, "application/json", new LogListSource(), HttpRequest::UNKNOWN_LENGTH,
+                           "Cache-Control: no-store\r\n");
+        return;
+    }
+
+    char name[32];
+    char path[40];
+    if (!request.arg("file", name, sizeof(name)) || !isLogName(name)) {
+        request.send(400, "text/plain", "Bad log name");
+        return;
+    }
+    snprintf(path, sizeof(path), "/%s", name);
+    HalFile* file = HAL::fs().open(path, "r");
+    if (file == nullptr) {
+        request.send(404, "text/plain", "Not Found");
+        return;
+    }
+
+    char headers[160];
+    bool binary = strcmp(name + strlen(name) - 4, ".bin") == 0;
+    char format[8];
+    if (binary && request.arg("format", format, sizeof(format)) && strcmp(format, "csv") == 0) {
+        // Decoded text has no byte offsets to resume from: no ranges
+        LogCsvSource* source = new LogCsvSource(file);
+        if (!source->begin()) {
+            delete source;
+            request.send(500, "text/plain", "Unreadable log");
+            return;
         }
-        
-        function startCooking() { fetch('/control?action=start'); }
-        function stopCooking() { fetch('/control?action=stop'); }
-        function pauseCooking() { fetch('/control?action=pause'); }
-        
-        setInterval(updateStatus, 1000);
-        updateStatus();
-    </script>
-</body>
-</html>
-)";
-    return html;
-}
\ No newline at end of file
+        snprintf(headers, sizeof(headers), "Content-Disposition: attachment; filename=\"%.*s.csv\"\r\n",
+                 (int)strlen(name) - 4, name);
+        request.sendStream(200, "text/csv", source, HttpRequest::UNKNOWN_LENGTH, headers);
+        return;
+    }
+
+    // Logs only grow, so an offset stays valid for resuming and for
+    // fetching just what was appended since the last sync
+    const char* type = binary ? "application/octet-stream" : "text/csv";
+    size_t size = file->size();
+    size_t first, last;
+    switch (request.range(size, first, last)) {
+        case HTTP_RANGE_UNSATISFIABLE:
+            file->close();
+            delete file;
+            snprintf(headers, sizeof(headers), "Content-Range: bytes */%u\r\n", (unsigned)size);
+            request.sendStatic(416, "text/plain", nullptr, 0, headers);
+            return;
+        case HTTP_RANGE_SATISFIABLE:
+            file->seek(first);
+            snprintf(headers, sizeof(headers), "Accept-Ranges: bytes\r\nContent-Range: bytes %u-%u/%u\r\n",
+                     (unsigned)first, (unsigned)last, (unsigned)size);
+            request.sendStream(206, type, new LogFileSource(file), last - first + 1, headers);
+            return;
+        default:
+            // Chunked to the end as it is then, so an open session comes
+            // with whatever was committed while it was being sent
+            snprintf(headers, sizeof(headers),
+                     "Accept-Ranges: bytes\r\nContent-Disposition: attachment; filename=\"%s\"\r\n", name);
+            request.sendStream(200, type, new LogFileSource(file), HttpRequest::UNKNOWN_LENGTH, headers);
+            return;
+    }
+}
+
+void WebInterface::handleHistory(HttpRequest& request) {
+    char name[32];
+    char path[40];
+    if (!request.arg("file", name, sizeof(name)) || !isLogName(name) ||
+        strcmp(name + strlen(name) - 4, ".bin") != 0) {
+        request.send(400, "text/plain", "Bad log name");
+        return;
+    }
+    snprintf(path, sizeof(path), "/%s", name);
+    HistorySource* source = new HistorySource();
+    if (!source->history.open(path)) {
+        delete source;
+        request.send(404, "text/plain", "Not Found");
+        return;
+    }
+
+    // The whole session unless narrowed; last counts back from its end
+    unsigned long end = source->history.getEndTime();
+    unsigned long from = 0, to = end, last;
+    char value[8] = "";
+    int points = HISTORY_DEFAULT_POINTS;
+    bool valid = true;
+    if (request.hasArg("last")) {
+        valid &= secondsArg(request, "last", last);
+        from = end > last ? end - last : 0;
+    }
+    if (request.hasArg("from")) valid &= secondsArg(request, "from", from);
+    if (request.hasArg("to")) valid &= secondsArg(request, "to", to);
+    if (request.hasArg("points")) {
+        valid &= request.arg("points", value, sizeof(value));
+        points = atoi(value);
+        valid &= points >= 2 && points <= HISTORY_MAX_POINTS;
+    }
+    if (!valid || !source->begin(name, from, to, points)) {
+        delete source;
+        request.send(400, "text/plain", "Bad query");
+        return;
+    }
+    request.sendStream(200, "application/json", source, HttpRequest::UNKNOWN_LENGTH, "Cache-Control: no-store\r\n");
+}
+
+void WebInterface::sendPostResult(HttpRequest& request, const Command* commands, int count) {
+    // All or nothing, so a retry after 503 never applies a field twice
+    if (commandBus == nullptr || !commandBus->postAll(commands, count)) {
+        request.sendStatic(503, "text/plain", nullptr, 0, "Retry-After: 1\r\n");
+        return;
+    }
+    request.send(202, "text/plain", "Accepted");
+}
+
+void WebInterface::handleNotFound(HttpRequest& request) {
+    request.send(404, "text/plain", "Not Found");
+}
+
+void WebInterface::handleSocketEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t length) {
+    if (num >= 32) return;
+    
+    switch (type) {
+        case WStype_CONNECTED:
+            snapshotPending |= 1UL << num;
+            break;
+        case WStype_DISCONNECTED:
+            snapshotPending &= ~(1UL << num);
+            break;
+        case WStype_TEXT:
+            handleCommand(payload, length);
+            break;
+        default:
+            break;
+    }
+}
+
+void WebInterface::handleCommand(const uint8_t* text, size_t length) {
+    // "action" or "action=value"; the payload is not NUL-terminated
+    char action[64];
+    if (length >= sizeof(action)) return;
+    memcpy(action, text, length);
+    action[length] = '\0';
+    
+    char* value = strchr(action, '=');
+    if (value != nullptr) {
+        *value++ = '\0';
+    }
+    
+    Command command;
+    if (!CommandBus::parse(action, value, COMMAND_SOURCE_WEB, command)) {
+        DEBUG_PRINT(F("Rejected web command: "));
+        DEBUG_PRINTLN(action);
+        return;
+    }
+    if (commandBus == nullptr || !commandBus->post(command)) {
+        DEBUG_PRINTLN(F("Command queue full, command dropped"));
+    }
+}
+
+void WebInterface::pushState(const ControlStatus& status) {
+    PushState current = {
+        (int)status.state,
+        lround(status.currentTemp * 10),
+        lround(status.targetTemp * 10),
+        status.remainingTime,
+        (int)lround(status.power)
+    };
+    
+    // Viewers that just joined get everything, serialized once for all of them
+    if (snapshotPending != 0) {
+        size_t length = serializeState(current, nullptr);
+        for (uint8_t num = 0; num < 32; num++) {
+            if (snapshotPending & (1UL << num)) {
+                socket->sendTXT(num, pushBuffer, length);
+            }
+        }
+        snapshotPending = 0;
+    }
+    
+    unsigned long now = HAL::clock().millis();
+    if (socket->connectedClients() == 0 ||
+        (pushedAny && now - lastPushTime < WEBSOCKET_MIN_INTERVAL)) {
+        return;
+    }
+    
+    size_t length = serializeState(current, pushedAny ? &pushed : nullptr);
+    if (length == 0) return;
+    
+    socket->broadcastTXT(pushBuffer, length);
+    pushed = current;
+    pushedAny = true;
+    lastPushTime = now;
+}
+
+size_t WebInterface::serializeState(const PushState& state, const PushState* previous) {
+    // Writes the fields that differ from previous (all without one) into
+    // pushBuffer; 0 when nothing changed
+    size_t length = 0;
+    size_t size = sizeof(pushBuffer);
+    
+    #define PUSH_FIELD(changed, format, value) \
+        if ((previous == nullptr || (changed)) && length < size) { \
+            length += snprintf(pushBuffer + length, size - length, \
+                               length == 0 ? "{" format : "," format, value); \
+        }
+    PUSH_FIELD(state.state != previous->state, "\"state\":%d", state.state)
+    PUSH_FIELD(state.currentTemp != previous->currentTemp, "\"currentTemp\":%.1f", state.currentTemp / 10.0)
+    PUSH_FIELD(state.targetTemp != previous->targetTemp, "\"targetTemp\":%.1f", state.targetTemp / 10.0)
+    PUSH_FIELD(state.remainingTime != previous->remainingTime, "\"remainingTime\":%lu", state.remainingTime)
+    PUSH_FIELD(state.power != previous->power, "\"power\":%d", state.power)
+    #undef PUSH_FIELD
+    
+    if (length == 0 || length + 1 >= size) return 0;
+    pushBuffer[length++] = '}';
+    pushBuffer[length] = '\0';
+    return length;
+}
@@ -0,0 +1,99 @@
+"""Build the dashboard page into include/DashboardPage.h.
+
+web/dashboard.html is the page source. This script fills in WEBSOCKET_PORT,
+strips indentation and comment lines, gzips the result and writes it out as
+a PROGMEM byte array with a content-derived ETag. The firmware serves that
+array as is with Content-Encoding: gzip.
+
+PlatformIO runs it before every build (extra_scripts = pre:...), taking
+WEBSOCKET_PORT from the build flags when it is overridden there. For the
+Arduino IDE, run it by hand after editing the page or the port:
+
+    python3 web/build_dashboard.py
+
+The header is only rewritten when its content changes, so an unchanged page
+does not trigger a rebuild.
+"""
+
+import gzip
+import hashlib
+import os
+import re
+import sys
+
+
+def websocket_port(root, defines):
+    for define in defines:
+        if isinstance(define, (tuple, list)) and define[0] == "WEBSOCKET_PORT":
+            return str(define[1])
+        if isinstance(define, str) and define.startswith("WEBSOCKET_PORT="):
+            return define.split("=", 1)[1]
+    with open(os.path.join(root, "include", "Config.h"), encoding="utf-8") as config:
+        match = re.search(r"^#define\s+WEBSOCKET_PORT\s+(\d+)", config.read(), re.MULTILINE)
+    if match is None:
+        sys.exit("build_dashboard.py: WEBSOCKET_PORT not found in include/Config.h")
+    return match.group(1)
+
+
+def minify(html):
+    lines = []
+    for line in html.splitlines():
+        line = line.strip()
+        if line and not line.startswith("//"):
+            lines.append(line)
+    return "\n".join(lines) + "\n"
+
+
+def build(root, defines=()):
+    port = websocket_port(root, defines)
+    with open(os.path.join(root, "web", "dashboard.html"), encoding="utf-8") as source:
+        html = source.read()
+    page = minify(html.replace("%WEBSOCKET_PORT%", port)).encode("utf-8")
+    # mtime=0 keeps the output, and with it the ETag, reproducible
+    compressed = gzip.compress(page, compresslevel=9, mtime=0)
+    etag = hashlib.sha1(compressed).hexdigest()[:16]
+
+    rows = []
+    for offset in range(0, len(compressed), 16):
+        chunk = compressed[offset:offset + 16]
+        rows.append("    " + ", ".join("0x%02x" % byte for byte in chunk) + ",")
+
+    header = "\n".join([
+        "// Generated by web/build_dashboard.py from web/dashboard.html - do not edit.",
+        "// %d bytes of HTML (%d minified), %d bytes gzipped."
+        % (len(html.encode("utf-8")), len(page), len(compressed)),
+        "#ifndef DASHBOARD_PAGE_H",
+        "#define DASHBOARD_PAGE_H",
+        "",
+        "#include <Arduino.h>",
+        "",
+        "#define DASHBOARD_WEBSOCKET_PORT %s" % port,
+        "#define DASHBOARD_ETAG \"\\\"%s\\\"\"" % etag,
+        "",
+        "static const uint8_t DASHBOARD_HTML_GZ[] PROGMEM = {",
+    ] + rows + [
+        "};",
+        "",
+        "#endif // DASHBOARD_PAGE_H",
+        "",
+    ])
+
+    output_path = os.path.join(root, "include", "DashboardPage.h")
+    try:
+        with open(output_path, encoding="utf-8") as existing:
+            if existing.read() == header:
+                return
+    except FileNotFoundError:
+        pass
+    with open(output_path, "w", encoding="utf-8", newline="\n") as output:
+        output.write(header)
+    print("Dashboard: %d bytes, %d gzipped, ETag %s" % (len(page), len(compressed), etag))
+
+
+# PlatformIO provides Import() and env, but not __file__
+try:
+    Import("env")  # noqa: F821
+except NameError:
+    build(os.path.dirname(os.path.dirname(os.path.abspath(__file__))))
+else:
+    build(env.subst("$PROJECT_DIR"), env.get("CPPDEFINES", []))  # noqa: F821